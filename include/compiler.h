@@ -9,7 +9,9 @@
 #include <time.h>
 #include <stdint.h>
 
-/* Configurações globais */
+/* Configurações globais (padrões; os limites efetivos vêm de CompilerConfig).
+ * MAX_TOKEN_LENGTH e MAX_STRING_LENGTH também dimensionam os vetores de
+ * tokens, símbolos e literais, portanto são tetos para a configuração */
 #define MAX_MEMORY_KB 512  
 #define MAX_MEMORY_BYTES (MAX_MEMORY_KB * 1024)
 #define MAX_TOKEN_LENGTH 256
@@ -17,14 +19,32 @@
 #define MAX_STRING_LENGTH 512
 #define MAX_LINE_LENGTH 1024
 #define MAX_FUNCTION_PARAMS 16
+#define MAX_CALL_DEPTH 4096
+#define DEFAULT_INLINE_MAX_NODES 16
+#define DEFAULT_MEMO_KB 64
+#define DEFAULT_JIT_CALLS 1000
+#define DEFAULT_JIT_BACK_EDGES 10000
 #define MAX_SYMBOL_TABLE_SIZE 1024
+#define DEFAULT_VARIABLE_SLOTS 1024
 #define MAX_ERROR_MESSAGE_LENGTH 512
 
 /* Configurações de memória interna */
-#define MEMORY_BLOCK_OVERHEAD 32  /* Bytes extras para cada bloco alocado */
 #define MEMORY_GUARD_SIZE 16      /* Tamanho dos guardas de memória */
 #define DEBUG_MEMORY 0       /* Ativar debug de memória */
 #define MEMORY_POISON_VALUE 0xDEADBEEF  /* Valor usado para envenenar memória liberada */
+#define MEMORY_ARENA_CHUNK_SIZE 16384   /* Tamanho padrão dos blocos de arena */
+#define MEMORY_MODE_ENV "COMPILADOR_MODO_MEMORIA"  /* Variável de ambiente do modo */
+#define MEMORY_PROFILE_ENV "COMPILADOR_PERFIL_HEAP"  /* Ativa o perfil de heap (arquivo de saída) */
+#define MEMORY_PROFILE_DEFAULT_PATH "heap.folded"
+#define MEMORY_TIMELINE_ENV "COMPILADOR_LINHA_TEMPO"  /* Ativa a linha do tempo (arquivo de saída) */
+#define MEMORY_TIMELINE_DEFAULT_PATH "memoria.csv"
+#define NATIVE_CACHE_ENV "COMPILADOR_NATIVO"  /* Ativa o backend nativo (diretório do cache) */
+#define NATIVE_CACHE_DEFAULT_DIR ".cache-compilador"
+#define NATIVE_BACKEND_ENV "COMPILADOR_GERADOR"  /* Gerador nativo: c ou asm */
+#define NATIVE_DEFAULT_BACKEND "c"
+#define NATIVE_CC "gcc"                 /* Compilador C do sistema */
+#define NATIVE_CODEGEN_VERSION "2"      /* Incrementar ao mudar o código gerado */
+#define NATIVE_PATH_LENGTH 1024
 
 /* Tipos de token */
 typedef enum {
@@ -96,9 +116,14 @@ typedef enum {
     TOKEN_ERROR        /* erro léxico */
 } TokenType;
 
+/* Identificador internado: mesmo texto, mesmo id (0 = nenhum) */
+typedef uint32_t InternId;
+#define INTERN_NONE 0
+
 /* Estrutura do token */
 typedef struct {
     TokenType type;
+    InternId id;        /* Para identificadores de variável e função */
     char value[MAX_TOKEN_LENGTH];
     int line;
     int column;
@@ -119,40 +144,71 @@ typedef struct {
     int scale;          /* Para decimal[antes.depois] - parte depois */
 } TypeInfo;
 
+/* Parâmetro de função: nome internado, tipo e dimensões */
+typedef struct {
+    InternId name_id;
+    DataType type;
+    TypeInfo type_info;
+} FunctionParam;
+
+/* Assinatura de função, guardada fora do símbolo: aponta para os
+   parâmetros da definição, válidos enquanto a AST analisada existir */
+typedef struct {
+    const FunctionParam* params;
+} FunctionSignature;
+
 /* Entrada da tabela de símbolos */
 typedef struct Symbol {
-    char name[MAX_IDENTIFIER_LENGTH];
+    InternId name_id;
+    const char* name;    /* Texto internado de name_id */
     DataType type;
     TypeInfo type_info;
-    int is_function;
-    int is_parameter;
     int scope_level;
     int line_declared;
-    int is_initialized;
+    unsigned char is_function;
+    unsigned char is_parameter;
+    unsigned char is_initialized;
     
-    /* Para variáveis */
-    union {
-        int int_value;
-        char string_value[MAX_STRING_LENGTH];
-        double decimal_value;
-    } value;
-    
-    /* Para funções */
+    /* Para funções: quantidade de parâmetros e índice da assinatura (-1 se não há) */
     int param_count;
-    DataType param_types[MAX_FUNCTION_PARAMS];
-    TypeInfo param_type_infos[MAX_FUNCTION_PARAMS];
-    char param_names[MAX_FUNCTION_PARAMS][MAX_IDENTIFIER_LENGTH];
+    int signature;
     
-    struct Symbol* next; /* Para lista ligada */
+    unsigned int hash;   /* Hash completo do nome */
+    struct Symbol* next; /* Símbolo de mesmo nome ocultado por este (ou lista livre) */
+    struct Symbol* scope_next; /* Próximo símbolo inserido no mesmo escopo */
 } Symbol;
 
-/* Tabela de símbolos */
+/* Entrada da tabela aberta: hash completo e símbolo visível do nome */
 typedef struct {
-    Symbol* table[MAX_SYMBOL_TABLE_SIZE];
+    unsigned int hash;
+    Symbol* symbol;             /* NULL se a entrada está vazia */
+} SymbolSlot;
+
+/* Tabela de símbolos */
+typedef struct SymbolTable {
+    const struct SymbolTable* parent; /* Consultada (somente leitura) quando o nome não está aqui */
+    SymbolSlot* table;          /* Endereçamento aberto (robin hood), potência de 2 */
+    int table_size;
+    int used_slots;             /* Nomes distintos visíveis */
     int scope_level;
+    Symbol** scope_symbols;     /* Por nível: símbolos inseridos, mais recente primeiro */
+    int scope_capacity;
     int symbol_count;
+    struct MemoryArena* arena;  /* Símbolos alocados por região */
+    Symbol* free_symbols;       /* Símbolos de escopos encerrados para reuso */
+    FunctionSignature* signatures; /* Assinaturas referenciadas por Symbol.signature */
+    int signature_count;
+    int signature_capacity;
 } SymbolTable;
 
+/* Trecho do código fonte e sua posição de origem */
+typedef struct {
+    int start;                  /* Deslocamento do primeiro byte */
+    int end;                    /* Deslocamento após o último byte */
+    int line;
+    int column;
+} SourceRange;
+
 /* Estado do lexer */
 typedef struct {
     FILE* input;
@@ -161,12 +217,40 @@ typedef struct {
     int line;
     int column;
     int length;
+    int offset;                 /* Posição de source[0] no fonte original */
     Token current_token;
     int error_count;
+    struct MemoryArena* arena;  /* Arena da fase léxica (contém o próprio lexer) */
+    int max_token_length;       /* Limites da configuração, até MAX_TOKEN_LENGTH */
+    int max_string_length;
 } Lexer;
 
+/* Modos do gerenciador de memória (fixados na criação) */
+typedef enum {
+    MEMORY_MODE_OFF,    /* Repasse ao malloc: só o contador do limite */
+    MEMORY_MODE_STATS,  /* Contadores e picos, sem registro por bloco */
+    MEMORY_MODE_DEBUG   /* Rastreamento completo: lista de blocos e guardas */
+} MemoryMode;
+
+/* Configuração da execução, lida da linha de comando e do ambiente */
+typedef struct {
+    MemoryMode memory_mode;
+    size_t memory_limit;        /* Bytes */
+    int max_string_length;      /* Strings criadas em tempo de execução */
+    int max_token_length;       /* Limitado a MAX_TOKEN_LENGTH */
+    int symbol_table_size;      /* Capacidade inicial da tabela de símbolos */
+    int initial_variable_slots; /* Variáveis pré-alocadas pelo interpretador */
+    int worker_threads;         /* Trabalhadores das fases paralelas (0 = um por processador) */
+    int lazy_bodies;            /* Corpos de funções analisados só quando alcançados */
+    int inline_max_nodes;       /* Tamanho máximo de função expandida na chamada (0 = desligado) */
+    int memo_kb;                /* Cache de resultados de funções puras (0 = desligado) */
+    int jit_calls;              /* Chamadas até compilar a função no JIT (0 = desligado) */
+    int jit_back_edges;         /* Voltas de laço até compilar o laço no JIT (0 = desligado) */
+} CompilerConfig;
+
 /* Gerenciador de memória */
 typedef struct {
+    MemoryMode mode;
     size_t allocated;
     size_t peak_usage;
     size_t limit;
@@ -175,6 +259,24 @@ typedef struct {
     size_t process_peak_usage; /* Pico de memória do processo */
 } MemoryManager;
 
+/* Bloco de uma arena */
+typedef struct MemoryArenaChunk {
+    struct MemoryArenaChunk* next;
+    size_t size;
+    size_t used;
+} MemoryArenaChunk;
+
+/* Arena de alocação por fase: libera tudo de uma vez */
+typedef struct MemoryArena {
+    MemoryManager* mm;
+    const char* name;
+    MemoryArenaChunk* chunks;   /* Lista de blocos na ordem de criação */
+    MemoryArenaChunk* current;  /* Bloco em uso */
+    size_t chunk_size;
+    size_t reserved;            /* Bytes contabilizados no gerenciador */
+    size_t used;                /* Bytes entregues desde o último reset */
+} MemoryArena;
+
 /* Tipos de erro */
 typedef enum {
     ERROR_LEXICAL,
@@ -211,9 +313,36 @@ typedef enum {
     AST_BLOCK
 } ASTNodeType;
 
+/* Índice de nó na AST plana */
+typedef uint32_t ASTIndex;
+#define AST_INDEX_NONE UINT32_MAX
+
+struct FlatAST;
+
+/* Token de origem de um nó: sem o texto, que fica no id internado */
+typedef struct {
+    TokenType type;
+    InternId id;
+    int line;
+    int column;
+} NodeToken;
+
+/* Definição de função, fora do nó: nós de função apontam para ela */
+typedef struct {
+    const char* name;           /* Texto internado do nome */
+    DataType return_type;
+    int param_count;
+    FunctionParam* params;      /* param_count itens, na mesma arena da definição */
+    SourceRange body;           /* Trecho do corpo ainda não analisado */
+    int body_pending;           /* Corpo pulado, analisado só se alcançado */
+    unsigned char pure;         /* Grafo de chamadas: sem efeitos observáveis */
+    unsigned char recursive;    /* Grafo de chamadas: recursão direta ou mútua */
+} FunctionInfo;
+
 typedef struct ASTNode {
     ASTNodeType type;
-    Token token;
+    NodeToken token;
+    InternId name_id;   /* Nome de identificadores, declarações, funções e chamadas */
     DataType data_type;
     
     /* Filhos do nó */
@@ -221,16 +350,16 @@ typedef struct ASTNode {
     int child_count;
     int child_capacity;
     
+    /* Representação plana: filhos em flat->edges[first_child..] */
+    const struct FlatAST* flat;
+    ASTIndex first_child;
+    
+    /* Arena de origem (NULL quando alocado individualmente) */
+    struct MemoryArena* arena;
+    
     /* Informações específicas do nó */
     union {
-        struct {
-            char name[MAX_IDENTIFIER_LENGTH];
-            DataType return_type;
-            int param_count;
-            DataType param_types[MAX_FUNCTION_PARAMS];
-            TypeInfo param_type_infos[MAX_FUNCTION_PARAMS];
-            char param_names[MAX_FUNCTION_PARAMS][MAX_IDENTIFIER_LENGTH];
-        } function;
+        FunctionInfo* function;     /* Na arena da árvore ou da AST plana */
         
         struct {
             DataType var_type;
@@ -241,14 +370,45 @@ typedef struct ASTNode {
             TokenType operator;
         } binary_op;
         
+        struct {
+            int tail_call;          /* Retorna direto o valor de uma chamada de mesmo tipo */
+        } return_stmt;
+        
         struct {
             int int_val;
             double decimal_val;
-            char string_val[MAX_STRING_LENGTH];
+            const char* string_val; /* Literal texto (na arena) ou nome internado */
         } literal;
     } data;
 } ASTNode;
 
+/* AST plana: nós contíguos, filhos como faixas de índices em um vetor
+ * compartilhado de arestas. Cabeçalho, nós e arestas ocupam um único bloco
+ * de memória; textos literais e definições de função ficam na arena. */
+typedef struct FlatAST {
+    ASTNode* nodes;
+    ASTIndex* edges;
+    uint32_t node_count;
+    uint32_t edge_count;
+    ASTIndex root;
+    struct MemoryArena* payload;
+} FlatAST;
+
+/* Construtor incremental da AST plana */
+typedef struct {
+    FlatAST* ast;
+    uint32_t node_capacity;
+    uint32_t edge_capacity;
+    ASTIndex* pending;          /* Filhos já fechados aguardando o pai */
+    uint32_t pending_count;
+    uint32_t pending_capacity;
+    ASTIndex* open_nodes;       /* Pilha de nós abertos */
+    uint32_t* open_bases;       /* Início dos filhos de cada nó aberto em pending */
+    uint32_t open_count;
+    uint32_t open_capacity;
+    int failed;
+} FlatASTBuilder;
+
 /* Parser */
 typedef struct {
     Lexer* lexer;
@@ -256,6 +416,12 @@ typedef struct {
     ASTNode* ast;
     int error_count;
     int current_scope;
+    MemoryArena* arena;         /* Árvore da definição em análise (descartada após a cópia) */
+    struct ParseJob* job;       /* Se definido, erros ficam guardados no job */
+    InternId* scope_names;      /* Sem tabela de símbolos: nomes declarados nos escopos abertos */
+    int scope_name_count;
+    int scope_name_capacity;
+    int scope_base;             /* Primeiro nome do escopo atual */
 } Parser;
 
 /* Interpretador */
@@ -272,13 +438,172 @@ typedef struct {
     } return_value;
 } Interpreter;
 
+/* Aresta do grafo de chamadas: chamadas de uma função a outra */
+typedef struct {
+    int callee;                 /* Índice da função chamada */
+    int count;                  /* Pontos de chamada no corpo do chamador */
+} CallEdge;
+
+/* Função no grafo de chamadas */
+typedef struct {
+    ASTNode* function;          /* AST_FUNCTION_DEF */
+    int first_edge;             /* Arestas em edges[first_edge..] */
+    int edge_count;
+    int caller_count;           /* Pontos de chamada que chegam a ela */
+    int scc;                    /* Componente fortemente conexa */
+    unsigned char reachable;    /* Alcançável a partir de principal */
+    unsigned char recursive;    /* Recursão direta ou mútua */
+    unsigned char pure;         /* Sem leia/escreva nem chamadas a funções impuras */
+} CallGraphNode;
+
+/* Grafo de chamadas do programa. Componentes são numeradas em ordem
+ * topológica reversa: a de uma função chamada vem antes da de quem chama. */
+typedef struct {
+    CallGraphNode* nodes;       /* Na ordem das definições */
+    int node_count;
+    CallEdge* edges;
+    int edge_count;
+    int edge_capacity;
+    int* index_by_id;           /* Id do nome -> índice (-1 se ausente) */
+    int* order;                 /* Nós agrupados por componente, em ordem crescente */
+    InternId max_id;
+    int root;                   /* principal, -1 se ausente */
+    int scc_count;
+    int reachable_count;
+} CallGraph;
+
+/* Compilação nativa: executável no cache indexado pelo hash do fonte */
+typedef struct {
+    const char* backend;
+    char key[17];                           /* Hash do fonte em hexadecimal */
+    char dir[NATIVE_PATH_LENGTH];
+    char executable[NATIVE_PATH_LENGTH];
+    char runtime[NATIVE_PATH_LENGTH];       /* Objeto do runtime de E/S */
+} NativeBuild;
+
+/* JIT: compilador e laços compilados (privados ao jit.c) */
+typedef struct JitCompiler JitCompiler;
+typedef struct JitLoop JitLoop;
+
+/* Estado compartilhado com o código nativo durante uma execução */
+typedef struct {
+    int32_t error;              /* JIT_ERROR_* */
+    int32_t depth;              /* Profundidade de chamadas corrente */
+    int32_t returned;           /* Laço terminou em retorno da função */
+} JitState;
+
+#define JIT_ERROR_NONE 0
+#define JIT_ERROR_DIVISION 1
+#define JIT_ERROR_DEPTH 2
+#define JIT_MAX_LOOP_VARS 64     /* Variáveis externas de um laço compilado */
+
+/* Representação intermediária: código de três endereços em SSA, com
+ * blocos básicos e arestas explícitas. Valores e blocos são referidos pelo
+ * índice na função (%n, bN); instruções removidas ficam na tabela, fora
+ * das listas dos blocos */
+typedef enum {
+    IR_CONST,           /* Literal */
+    IR_PARAM,           /* Parâmetro (constant.param) */
+    IR_UNDEF,           /* Variável sem valor */
+    IR_PHI,             /* Um operando por predecessor, na ordem de preds */
+    IR_BINARY,          /* operator sobre dois operandos */
+    IR_CONVERT,         /* Conversão do operando para type */
+    IR_CALL,            /* Função name_id; tail marca chamada de cauda */
+    IR_READ,            /* leia de um valor do tipo; o operando é o valor
+                         * anterior da variável, mantido se nada for lido */
+    IR_WRITE,           /* escreva do operando; sem operando, quebra de linha */
+    IR_JUMP,            /* Terminadores: targets[0] */
+    IR_BRANCH,          /* Operando verdadeiro: targets[0], falso: targets[1] */
+    IR_RETURN           /* Operando opcional */
+} IrOp;
+
+typedef struct {
+    IrOp op;
+    DataType type;              /* TYPE_VOID se não define valor */
+    TokenType operator;
+    int* operands;
+    int operand_count;
+    int operand_capacity;
+    int targets[2];
+    InternId name_id;
+    int tail;
+    int block;                  /* Bloco que contém a instrução (-1 se removida) */
+    union {
+        int int_val;
+        double decimal_val;
+        const char* text_val;
+        int param;
+    } constant;
+} IrInstr;
+
+typedef struct {
+    int* instrs;                /* Phis primeiro, terminador por último */
+    int instr_count;
+    int instr_capacity;
+    int* preds;
+    int pred_count;
+    int pred_capacity;
+    int succs[2];
+    int succ_count;
+    unsigned char sealed;       /* Todos os predecessores conhecidos */
+    unsigned char removed;
+} IrBlock;
+
+typedef struct {
+    const ASTNode* definition;
+    const char* name;
+    InternId name_id;
+    DataType return_type;       /* TYPE_VOID em principal */
+    IrInstr* instrs;
+    int instr_count;
+    int instr_capacity;
+    IrBlock* blocks;            /* blocks[0] é a entrada */
+    int block_count;
+    int block_capacity;
+} IrFunction;
+
+typedef struct {
+    IrFunction* functions;
+    int function_count;
+    MemoryArena* arena;         /* Tudo do módulo; liberado de uma vez */
+} IrModule;
+
+/* Passo sobre uma função; retorna quantas alterações fez */
+typedef int (*IrPassFunction)(IrModule* module, IrFunction* function);
+
+typedef struct {
+    const char* name;
+    IrPassFunction run;
+    double seconds;             /* Acumulado em todas as execuções */
+    long changes;
+} IrPass;
+
+/* Gerenciador de passos: executados em ordem sobre cada função */
+typedef struct {
+    IrPass* passes;
+    int pass_count;
+    int pass_capacity;
+} IrPassManager;
+
 /* ================================
    PROTÓTIPOS DE FUNÇÃO
    ================================ */
 
 /* Gerenciador de Memória */
 MemoryManager* memory_manager_create(void);
+MemoryManager* memory_manager_create_with_config(const CompilerConfig* config);
+MemoryMode memory_mode_from_env(void);
+int memory_mode_parse(const char* name, MemoryMode* mode);
+const char* memory_mode_name(MemoryMode mode);
+void memory_benchmark(int iterations);
 void memory_manager_destroy(MemoryManager* mm);
+void memory_manager_discard(MemoryManager* mm);
+void memory_thread_release(MemoryManager* mm);
+int memory_profile_enable(MemoryManager* mm, const char* folded_path);
+int memory_profile_dump(MemoryManager* mm, FILE* table, const char* folded_path);
+int memory_timeline_enable(MemoryManager* mm, const char* path);
+void memory_set_phase(MemoryManager* mm, const char* phase);
+int memory_timeline_export(MemoryManager* mm, const char* path);
 void* memory_alloc(MemoryManager* mm, size_t size);
 void* memory_alloc_debug(MemoryManager* mm, size_t size, const char* file, int line, const char* function);
 void memory_free(MemoryManager* mm, void* ptr);
@@ -291,6 +616,27 @@ int memory_check_limit(MemoryManager* mm);
 int memory_validate_integrity(MemoryManager* mm);
 size_t memory_get_process_usage(void);
 
+/* Arenas por fase */
+MemoryArena* memory_arena_create(MemoryManager* mm, const char* name, size_t chunk_size);
+void* memory_arena_alloc(MemoryArena* arena, size_t size);
+char* memory_arena_strdup(MemoryArena* arena, const char* str);
+void memory_arena_reset(MemoryArena* arena);
+void memory_arena_destroy(MemoryArena* arena);
+
+/* Internação de identificadores */
+InternId intern_string(const char* text);
+InternId intern_lookup(const char* text);
+const char* intern_text(InternId id);
+unsigned int intern_hash(InternId id);
+void intern_table_destroy(void);
+
+/* Configuração */
+void config_init_defaults(CompilerConfig* config);
+int config_load_env(CompilerConfig* config);
+int config_parse_option(CompilerConfig* config, const char* arg);
+void config_print_usage(void);
+int config_worker_count(const CompilerConfig* config, int jobs);
+
 /* Macros para facilitar debug de memória */
 #define MEMORY_ALLOC(mm, size) memory_alloc_debug(mm, size, __FILE__, __LINE__, __func__)
 #define MEMORY_FREE(mm, ptr) memory_free_debug(mm, ptr, __FILE__, __LINE__, __func__)
@@ -301,6 +647,9 @@ Lexer* lexer_create(const char* source);
 void lexer_destroy(Lexer* lexer);
 Token lexer_next_token(Lexer* lexer);
 Token lexer_peek_token(Lexer* lexer);
+Lexer* lexer_create_range(const char* source, const SourceRange* range);
+int lexer_scan_top_level(Lexer* lexer, SourceRange** ranges);
+int lexer_skip_block(Lexer* lexer, SourceRange* range);
 void lexer_skip_whitespace(Lexer* lexer);
 void lexer_skip_comment(Lexer* lexer);
 int lexer_is_keyword(const char* str);
@@ -308,24 +657,47 @@ TokenType lexer_get_keyword_type(const char* str);
 
 /* Tabela de Símbolos */
 SymbolTable* symbol_table_create(void);
+SymbolTable* symbol_table_create_view(const SymbolTable* parent);
 void symbol_table_destroy(SymbolTable* st);
 Symbol* symbol_table_insert(SymbolTable* st, const char* name, DataType type);
 Symbol* symbol_table_lookup(SymbolTable* st, const char* name);
+Symbol* symbol_table_insert_id(SymbolTable* st, InternId name_id, DataType type);
+Symbol* symbol_table_lookup_id(SymbolTable* st, InternId name_id);
 void symbol_table_enter_scope(SymbolTable* st);
 void symbol_table_exit_scope(SymbolTable* st);
 void symbol_table_print(SymbolTable* st);
+FunctionSignature* symbol_table_add_signature(SymbolTable* st, Symbol* func);
+const FunctionSignature* symbol_table_get_signature(const SymbolTable* st, const Symbol* func);
 unsigned int symbol_hash(const char* str);
 
 /* AST */
 ASTNode* ast_create_node(ASTNodeType type);
+NodeToken ast_node_token(Token token);
+ASTNode* ast_create_node_in(MemoryArena* arena, ASTNodeType type);
 void ast_destroy(ASTNode* node);
 void ast_add_child(ASTNode* parent, ASTNode* child);
 void ast_print(ASTNode* node, int depth);
+ASTNode* ast_get_child(const ASTNode* node, int index);
+
+/* AST plana */
+FlatASTBuilder* flat_ast_builder_create(uint32_t node_hint, uint32_t edge_hint);
+void flat_ast_builder_destroy(FlatASTBuilder* builder);
+ASTIndex flat_ast_begin_node(FlatASTBuilder* builder, ASTNodeType type, NodeToken token);
+ASTIndex flat_ast_begin_copy(FlatASTBuilder* builder, const ASTNode* source);
+ASTNode* flat_ast_builder_node(FlatASTBuilder* builder, ASTIndex index);
+void flat_ast_end_node(FlatASTBuilder* builder);
+FlatAST* flat_ast_builder_finish(FlatASTBuilder* builder);
+FlatAST* flat_ast_from_tree_filtered(ASTNode* root, const unsigned char* keep);
+ASTIndex flat_ast_copy_subtree(FlatASTBuilder* builder, const ASTNode* node);
+int flat_ast_attach_subtree(FlatASTBuilder* builder, ASTIndex parent, const ASTNode* node);
+void flat_ast_destroy(FlatAST* ast);
+ASTNode* flat_ast_root(const FlatAST* ast);
 
 /* Parser */
 Parser* parser_create(Lexer* lexer);
 void parser_destroy(Parser* parser);
-ASTNode* parser_parse(Parser* parser);
+FlatAST* parser_parse(Parser* parser);
+void parser_release_tree(Parser* parser);
 ASTNode* parser_parse_program(Parser* parser);
 ASTNode* parser_parse_function(Parser* parser);
 ASTNode* parser_parse_statement(Parser* parser);
@@ -337,6 +709,51 @@ int semantic_analyze(ASTNode* ast, SymbolTable* st);
 int semantic_check_types(ASTNode* node, SymbolTable* st);
 int semantic_check_scopes(ASTNode* node, SymbolTable* st);
 
+/* Grafo de chamadas */
+CallGraph* call_graph_build(ASTNode* program, int* out_of_memory);
+void call_graph_destroy(CallGraph* graph);
+int call_graph_find(const CallGraph* graph, InternId name_id);
+void call_graph_print(const CallGraph* graph);
+FlatAST* call_graph_prune(const CallGraph* graph, ASTNode* program, int* out_of_memory);
+
+/* Expansão de funções no ponto de chamada */
+FlatAST* inline_functions(const CallGraph* graph, ASTNode* program, int* expanded, int* out_of_memory);
+
+/* Geração de código nativo */
+int codegen_c_emit(ASTNode* program, FILE* out);
+int codegen_asm_emit(ASTNode* program, FILE* out);
+int native_backend_valid(const char* name);
+int native_build_init(NativeBuild* build, const char* dir, const char* backend, const char* source);
+int native_build_cached(const NativeBuild* build);
+int native_build(NativeBuild* build, ASTNode* program);
+int native_execute(const NativeBuild* build);
+int native_run_process(char* const argv[]);
+
+/* Representação intermediária (SSA) */
+IrModule* ir_build(ASTNode* program);
+void ir_destroy(IrModule* module);
+int ir_verify(const IrModule* module);
+void ir_print(const IrModule* module, FILE* out);
+IrPassManager* ir_pass_manager_create(void);
+void ir_pass_manager_destroy(IrPassManager* pm);
+int ir_pass_manager_add(IrPassManager* pm, const char* name, IrPassFunction run);
+int ir_pass_manager_add_defaults(IrPassManager* pm);
+int ir_pass_manager_run(IrPassManager* pm, IrModule* module);
+void ir_pass_manager_report(const IrPassManager* pm, FILE* out);
+int ir_execute(const IrModule* module);
+
+/* JIT de funções e laços quentes (x86-64) */
+JitCompiler* jit_create(ASTNode** functions, int count);
+void jit_destroy(JitCompiler* jit);
+int jit_function_ready(const JitCompiler* jit, int index);
+int jit_compile_function(JitCompiler* jit, int index);
+int jit_call(JitCompiler* jit, int index, const int32_t* args, JitState* state, int32_t* result);
+const JitLoop* jit_compile_loop(JitCompiler* jit, int function, ASTNode* node);
+int jit_loop_inputs(const JitLoop* loop, const InternId** ids);
+int jit_run_loop(JitCompiler* jit, const JitLoop* loop, int32_t* values, JitState* state, int32_t* result);
+const char* jit_error_message(int error);
+void jit_report(const JitCompiler* jit);
+
 /* Interpretador */
 Interpreter* interpreter_create(ASTNode* ast, SymbolTable* st);
 void interpreter_destroy(Interpreter* interpreter);
@@ -357,6 +774,7 @@ const char* data_type_to_string(DataType type);
 
 /* Variáveis globais */
 extern MemoryManager* g_memory_manager;
+extern CompilerConfig g_config;
 extern int g_error_count;
 extern int g_warning_count;
 
@@ -2,7 +2,13 @@
 
 /* Criar nó da AST */
 ASTNode* ast_create_node(ASTNodeType type) {
-    ASTNode* node = (ASTNode*)memory_alloc(g_memory_manager, sizeof(ASTNode));
+    return ast_create_node_in(NULL, type);
+}
+
+/* Criar nó da AST em uma arena (NULL usa alocação individual) */
+ASTNode* ast_create_node_in(MemoryArena* arena, ASTNodeType type) {
+    ASTNode* node = arena ? (ASTNode*)memory_arena_alloc(arena, sizeof(ASTNode))
+                          : (ASTNode*)MEMORY_ALLOC(g_memory_manager, sizeof(ASTNode));
     if (!node) {
         error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar nó da AST");
         return NULL;
@@ -13,6 +19,10 @@ ASTNode* ast_create_node(ASTNodeType type) {
     node->children = NULL;
     node->child_count = 0;
     node->child_capacity = 0;
+    node->flat = NULL;
+    node->first_child = AST_INDEX_NONE;
+    node->arena = arena;
+    node->name_id = INTERN_NONE;
     
     /* Zerar dados específicos do nó */
     memset(&node->data, 0, sizeof(node->data));
@@ -20,10 +30,24 @@ ASTNode* ast_create_node(ASTNodeType type) {
     return node;
 }
 
+/* Token de origem de um nó: o texto fica no id internado */
+NodeToken ast_node_token(Token token) {
+    NodeToken node_token;
+    node_token.type = token.type;
+    node_token.id = token.id;
+    node_token.line = token.line;
+    node_token.column = token.column;
+    return node_token;
+}
+
 /* Destruir nó da AST e seus filhos */
 void ast_destroy(ASTNode* node) {
     if (!node) return;
     
+    /* Nós da AST plana pertencem ao bloco único (ver flat_ast_destroy)
+     * e nós de arena são liberados junto com ela */
+    if (node->flat || node->arena) return;
+    
     /* Destruir filhos */
     if (node->children) {
         for (int i = 0; i < node->child_count; i++) {
@@ -42,8 +66,18 @@ void ast_add_child(ASTNode* parent, ASTNode* child) {
     /* Verificar se precisa aumentar capacidade */
     if (parent->child_count >= parent->child_capacity) {
         int new_capacity = parent->child_capacity == 0 ? 4 : parent->child_capacity * 2;
-        ASTNode** new_children = (ASTNode**)memory_realloc(g_memory_manager, parent->children, 
-                                                   new_capacity * sizeof(ASTNode*));
+        ASTNode** new_children;
+        
+        if (parent->arena) {
+            /* Arena não realoca: copiar para nova área */
+            new_children = (ASTNode**)memory_arena_alloc(parent->arena, new_capacity * sizeof(ASTNode*));
+            if (new_children && parent->child_count > 0) {
+                memcpy(new_children, parent->children, parent->child_count * sizeof(ASTNode*));
+            }
+        } else {
+            new_children = (ASTNode**)MEMORY_REALLOC(g_memory_manager, parent->children, 
+                                                     new_capacity * sizeof(ASTNode*));
+        }
         
         if (!new_children) {
             error_report(ERROR_MEMORY, 0, 0, "Falha ao realocar filhos da AST");
@@ -57,6 +91,18 @@ void ast_add_child(ASTNode* parent, ASTNode* child) {
     parent->children[parent->child_count++] = child;
 }
 
+/* Obter filho de um nó (árvore ou AST plana) */
+ASTNode* ast_get_child(const ASTNode* node, int index) {
+    if (!node || index < 0 || index >= node->child_count) return NULL;
+    
+    if (node->flat) {
+        const FlatAST* flat = node->flat;
+        return &flat->nodes[flat->edges[node->first_child + (ASTIndex)index]];
+    }
+    
+    return node->children[index];
+}
+
 /* Imprimir AST (para debug) */
 static void print_ast_recursive(ASTNode* node, int depth) {
     if (!node) return;
@@ -73,7 +119,7 @@ static void print_ast_recursive(ASTNode* node, int depth) {
             printf("Programa");
             break;
         case AST_FUNCTION_DEF:
-            printf("Função: %s", node->data.function.name);
+            printf("Função: %s", node->data.function->name);
             break;
         case AST_VAR_DECL:
             printf("Variável: tipo %s", data_type_to_string(node->data.var_decl.var_type));
@@ -132,7 +178,7 @@ static void print_ast_recursive(ASTNode* node, int depth) {
     
     /* Imprimir filhos */
     for (int i = 0; i < node->child_count; i++) {
-        print_ast_recursive(node->children[i], depth + 1);
+        print_ast_recursive(ast_get_child(node, i), depth + 1);
     }
 }
 
@@ -0,0 +1,342 @@
+#include "../include/compiler.h"
+
+/* Chamada a uma função do programa (leia/escreva também usam o nó de chamada) */
+static int is_user_call(const ASTNode* node) {
+    return node->type == AST_FUNCTION_CALL && node->token.type == TOKEN_FUNCAO_ID;
+}
+
+/* Índice da função pelo id do nome; -1 se não definida */
+int call_graph_find(const CallGraph* graph, InternId name_id) {
+    if (!graph || name_id == INTERN_NONE || name_id > graph->max_id) return -1;
+    return graph->index_by_id[name_id];
+}
+
+/* Registrar um ponto de chamada de caller para callee */
+static int call_graph_add_call(CallGraph* graph, int caller, int callee) {
+    CallGraphNode* node = &graph->nodes[caller];
+
+    /* Arestas do chamador são contíguas: basta procurar nas dele */
+    for (int i = 0; i < node->edge_count; i++) {
+        CallEdge* edge = &graph->edges[node->first_edge + i];
+        if (edge->callee == callee) {
+            edge->count++;
+            graph->nodes[callee].caller_count++;
+            return 1;
+        }
+    }
+
+    if (graph->edge_count >= graph->edge_capacity) {
+        int capacity = graph->edge_capacity == 0 ? 16 : graph->edge_capacity * 2;
+        CallEdge* edges = (CallEdge*)MEMORY_REALLOC(g_memory_manager, graph->edges,
+                                                    (size_t)capacity * sizeof(CallEdge));
+        if (!edges) return 0;
+        graph->edges = edges;
+        graph->edge_capacity = capacity;
+    }
+
+    CallEdge* edge = &graph->edges[graph->edge_count++];
+    edge->callee = callee;
+    edge->count = 1;
+    node->edge_count++;
+    graph->nodes[callee].caller_count++;
+    return 1;
+}
+
+/* Registrar as chamadas feitas dentro da subárvore */
+static int call_graph_collect(CallGraph* graph, int caller, const ASTNode* node) {
+    if (is_user_call(node)) {
+        int callee = call_graph_find(graph, node->name_id);
+        if (callee >= 0 && !call_graph_add_call(graph, caller, callee)) return 0;
+    }
+
+    for (int i = 0; i < node->child_count; i++) {
+        if (!call_graph_collect(graph, caller, ast_get_child(node, i))) return 0;
+    }
+    return 1;
+}
+
+/* Marcar funções alcançáveis a partir de principal (busca em largura) */
+static int call_graph_mark_reachable(CallGraph* graph) {
+    if (graph->root < 0) return 1;
+
+    int* queue = (int*)MEMORY_ALLOC(g_memory_manager, (size_t)graph->node_count * sizeof(int));
+    if (!queue) return 0;
+
+    int head = 0;
+    int tail = 0;
+    graph->nodes[graph->root].reachable = 1;
+    queue[tail++] = graph->root;
+
+    while (head < tail) {
+        const CallGraphNode* node = &graph->nodes[queue[head++]];
+        for (int i = 0; i < node->edge_count; i++) {
+            int callee = graph->edges[node->first_edge + i].callee;
+            if (!graph->nodes[callee].reachable) {
+                graph->nodes[callee].reachable = 1;
+                queue[tail++] = callee;
+            }
+        }
+    }
+
+    graph->reachable_count = tail;
+    memory_free(g_memory_manager, queue);
+    return 1;
+}
+
+/* Componentes fortemente conexas (Tarjan, com pilha explícita para não
+ * depender da pilha de C em cadeias longas de chamadas) */
+static int call_graph_find_sccs(CallGraph* graph) {
+    int n = graph->node_count;
+    int* index = (int*)MEMORY_ALLOC(g_memory_manager, (size_t)n * 5 * sizeof(int));
+    if (!index) return 0;
+
+    int* low = index + n;
+    int* stack = low + n;           /* Pilha de Tarjan */
+    int* path = stack + n;          /* Caminho da busca em profundidade */
+    int* next_edge = path + n;      /* Próxima aresta de cada nível do caminho */
+    for (int i = 0; i < n; i++) index[i] = -1;
+
+    int counter = 0;
+    int sp = 0;
+    int ordered = 0;
+    for (int start = 0; start < n; start++) {
+        if (index[start] >= 0) continue;
+
+        int depth = 0;
+        path[depth] = start;
+        next_edge[depth++] = 0;
+        index[start] = low[start] = counter++;
+        stack[sp++] = start;
+
+        while (depth > 0) {
+            int v = path[depth - 1];
+            const CallGraphNode* node = &graph->nodes[v];
+
+            if (next_edge[depth - 1] < node->edge_count) {
+                int w = graph->edges[node->first_edge + next_edge[depth - 1]++].callee;
+                if (index[w] < 0) {
+                    index[w] = low[w] = counter++;
+                    stack[sp++] = w;
+                    path[depth] = w;
+                    next_edge[depth++] = 0;
+                } else if (graph->nodes[w].scc < 0 && index[w] < low[v]) {
+                    /* Ainda na pilha: faz parte da componente em aberto */
+                    low[v] = index[w];
+                }
+                continue;
+            }
+
+            /* v é raiz de componente: desempilhar seus membros */
+            if (low[v] == index[v]) {
+                int first = sp;
+                do {
+                    first--;
+                    graph->nodes[stack[first]].scc = graph->scc_count;
+                } while (stack[first] != v);
+
+                for (int i = first; i < sp; i++) {
+                    graph->order[ordered++] = stack[i];
+                    if (sp - first > 1) graph->nodes[stack[i]].recursive = 1;
+                }
+                sp = first;
+                graph->scc_count++;
+            }
+
+            depth--;
+            if (depth > 0 && low[v] < low[path[depth - 1]]) {
+                low[path[depth - 1]] = low[v];
+            }
+        }
+    }
+
+    /* Recursão direta: componente de um só membro com aresta para si */
+    for (int i = 0; i < n; i++) {
+        const CallGraphNode* node = &graph->nodes[i];
+        for (int j = 0; j < node->edge_count; j++) {
+            if (graph->edges[node->first_edge + j].callee == i) graph->nodes[i].recursive = 1;
+        }
+    }
+
+    memory_free(g_memory_manager, index);
+    return 1;
+}
+
+/* Comando de entrada/saída na subárvore */
+static int has_io(const ASTNode* node) {
+    if (node->type == AST_FUNCTION_CALL &&
+        (node->token.type == TOKEN_ESCREVA || node->token.type == TOKEN_LEIA)) {
+        return 1;
+    }
+    for (int i = 0; i < node->child_count; i++) {
+        if (has_io(ast_get_child(node, i))) return 1;
+    }
+    return 0;
+}
+
+/* Funções puras: resultado depende só dos argumentos. Variáveis são
+ * locais a cada chamada (não há globais), então basta não fazer
+ * leia/escreva e só chamar funções puras. Componentes são visitadas das
+ * chamadas para quem chama; dentro de uma componente a recursão não
+ * impede a pureza. */
+static void call_graph_mark_pure(CallGraph* graph) {
+    int first = 0;
+    while (first < graph->node_count) {
+        int scc = graph->nodes[graph->order[first]].scc;
+        int last = first;
+        while (last < graph->node_count && graph->nodes[graph->order[last]].scc == scc) last++;
+
+        int pure = 1;
+        for (int i = first; pure && i < last; i++) {
+            const CallGraphNode* node = &graph->nodes[graph->order[i]];
+            if (has_io(node->function)) pure = 0;
+            for (int j = 0; pure && j < node->edge_count; j++) {
+                const CallGraphNode* callee = &graph->nodes[graph->edges[node->first_edge + j].callee];
+                if (callee->scc != scc && !callee->pure) pure = 0;
+            }
+        }
+
+        for (int i = first; i < last; i++) graph->nodes[graph->order[i]].pure = (unsigned char)pure;
+        first = last;
+    }
+}
+
+/* Construir grafo a partir das definições do programa. Recursão e pureza
+ * também são anotadas nas definições, para as fases seguintes. Sem
+ * memória, retorna NULL e marca out_of_memory: o grafo é opcional e quem
+ * chama decide como seguir */
+CallGraph* call_graph_build(ASTNode* program, int* out_of_memory) {
+    if (out_of_memory) *out_of_memory = 0;
+    if (!program || program->type != AST_PROGRAM) return NULL;
+
+    CallGraph* graph = (CallGraph*)MEMORY_ALLOC(g_memory_manager, sizeof(CallGraph));
+    if (!graph) {
+        if (out_of_memory) *out_of_memory = 1;
+        return NULL;
+    }
+    memset(graph, 0, sizeof(CallGraph));
+    graph->root = -1;
+
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type != AST_FUNCTION_DEF) continue;
+        graph->node_count++;
+        if (child->name_id > graph->max_id) graph->max_id = child->name_id;
+    }
+
+    graph->nodes = (CallGraphNode*)MEMORY_ALLOC(g_memory_manager,
+                                                (size_t)(graph->node_count + 1) * sizeof(CallGraphNode));
+    graph->index_by_id = (int*)MEMORY_ALLOC(g_memory_manager, ((size_t)graph->max_id + 1) * sizeof(int));
+    graph->order = (int*)MEMORY_ALLOC(g_memory_manager, (size_t)(graph->node_count + 1) * sizeof(int));
+    if (!graph->nodes || !graph->index_by_id || !graph->order) {
+        call_graph_destroy(graph);
+        if (out_of_memory) *out_of_memory = 1;
+        return NULL;
+    }
+    for (InternId id = 0; id <= graph->max_id; id++) graph->index_by_id[id] = -1;
+
+    /* Nós na ordem das definições; nomes repetidos ficam com a primeira */
+    InternId main_id = intern_lookup("principal");
+    int count = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type != AST_FUNCTION_DEF) continue;
+
+        CallGraphNode* node = &graph->nodes[count];
+        memset(node, 0, sizeof(CallGraphNode));
+        node->function = child;
+        node->scc = -1;
+
+        if (child->name_id != INTERN_NONE && graph->index_by_id[child->name_id] < 0) {
+            graph->index_by_id[child->name_id] = count;
+            if (child->name_id == main_id) graph->root = count;
+        }
+        count++;
+    }
+
+    /* Arestas de cada função ficam juntas, na ordem dos nós */
+    int ok = 1;
+    for (int i = 0; ok && i < graph->node_count; i++) {
+        graph->nodes[i].first_edge = graph->edge_count;
+        ok = call_graph_collect(graph, i, graph->nodes[i].function);
+    }
+
+    if (!ok || !call_graph_mark_reachable(graph) || !call_graph_find_sccs(graph)) {
+        call_graph_destroy(graph);
+        if (out_of_memory) *out_of_memory = 1;
+        return NULL;
+    }
+
+    call_graph_mark_pure(graph);
+    for (int i = 0; i < graph->node_count; i++) {
+        ASTNode* function = graph->nodes[i].function;
+        function->data.function->pure = graph->nodes[i].pure;
+        function->data.function->recursive = graph->nodes[i].recursive;
+    }
+
+    return graph;
+}
+
+/* Destruir grafo */
+void call_graph_destroy(CallGraph* graph) {
+    if (!graph) return;
+
+    if (graph->nodes) memory_free(g_memory_manager, graph->nodes);
+    if (graph->edges) memory_free(g_memory_manager, graph->edges);
+    if (graph->index_by_id) memory_free(g_memory_manager, graph->index_by_id);
+    if (graph->order) memory_free(g_memory_manager, graph->order);
+    memory_free(g_memory_manager, graph);
+}
+
+/* Imprimir grafo: funções, componentes e chamadas com suas contagens */
+void call_graph_print(const CallGraph* graph) {
+    if (!graph) return;
+
+    printf("=== GRAFO DE CHAMADAS ===\n");
+    printf("Funções: %d (alcançáveis: %d, componentes: %d)\n",
+           graph->node_count, graph->reachable_count, graph->scc_count);
+
+    for (int i = 0; i < graph->node_count; i++) {
+        const CallGraphNode* node = &graph->nodes[i];
+        printf("%s [%s%s%s] componente %d, chamada em %d ponto(s)\n",
+               node->function->data.function->name,
+               node->reachable ? "alcançável" : "inalcançável",
+               node->recursive ? ", recursiva" : "",
+               node->pure ? ", pura" : "",
+               node->scc, node->caller_count);
+
+        for (int j = 0; j < node->edge_count; j++) {
+            const CallEdge* edge = &graph->edges[node->first_edge + j];
+            printf("  -> %s (%dx)\n",
+                   graph->nodes[edge->callee].function->data.function->name, edge->count);
+        }
+    }
+
+    printf("=========================\n");
+}
+
+/* AST plana só com as funções alcançáveis a partir de principal; NULL se
+ * não há o que descartar (ou sem principal, quando nada é podado) ou se
+ * faltou memória, caso em que out_of_memory é marcado */
+FlatAST* call_graph_prune(const CallGraph* graph, ASTNode* program, int* out_of_memory) {
+    if (out_of_memory) *out_of_memory = 0;
+    if (!graph || !program || graph->root < 0 || graph->reachable_count == graph->node_count) {
+        return NULL;
+    }
+
+    unsigned char* keep = (unsigned char*)MEMORY_ALLOC(g_memory_manager, (size_t)program->child_count + 1);
+    if (!keep) {
+        if (out_of_memory) *out_of_memory = 1;
+        return NULL;
+    }
+
+    int index = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        keep[i] = child->type != AST_FUNCTION_DEF || graph->nodes[index++].reachable;
+    }
+
+    FlatAST* pruned = flat_ast_from_tree_filtered(program, keep);
+    memory_free(g_memory_manager, keep);
+    if (!pruned && out_of_memory) *out_of_memory = 1;
+    return pruned;
+}
@@ -0,0 +1,862 @@
+#include "../include/compiler.h"
+#include <stdarg.h>
+
+/* Geração de assembly x86-64 (System V, sintaxe AT&T do GNU as) a partir
+ * da AST verificada. Cada variável tem um espaço fixo no quadro da função.
+ * Expressões deixam o resultado em %rax (inteiro, verdade ou endereço de
+ * texto) ou em %xmm0 (decimal); o operando esquerdo fica empilhado
+ * enquanto o direito é avaliado, o que mantém a ordem da esquerda para a
+ * direita. As palavras empilhadas são contadas para alinhar a pilha em 16
+ * bytes em cada chamada.
+ *
+ * inteiro tem 32 bits, como no interpretador: as operações usam %eax e
+ * %ecx, e o resultado volta estendido com sinal para os 64 bits de %rax,
+ * forma em que fica nos registradores, na pilha e no quadro. Assim
+ * comparações, parâmetros e o runtime (int64_t) continuam valendo sem
+ * conversão, e 2147483647 + 1 dá -2147483648.
+ *
+ * Texto é um vetor de max_string_length bytes no quadro. Parâmetros de
+ * texto chegam como endereço e são copiados na entrada; funções que
+ * retornam texto recebem em %rdi o endereço onde gravar o resultado. */
+
+#define ASM_INT_REGS 6
+#define ASM_SSE_REGS 8
+
+static const char* const asm_int_regs[ASM_INT_REGS] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
+
+/* Variável visível: deslocamento em relação a %rbp */
+typedef struct {
+    InternId name_id;
+    DataType type;
+    int offset;
+} AsmVariable;
+
+typedef struct {
+    FILE* out;                  /* Corpo da função em geração */
+    ASTNode** functions;
+    int function_count;
+    AsmVariable* variables;     /* Escopos abertos, do mais externo ao atual */
+    int variable_count;
+    int variable_capacity;
+    int frame_size;             /* Bytes reservados abaixo de %rbp */
+    int depth;                  /* Palavras empilhadas por expressões em andamento */
+    int labels;
+    int strings;
+    int text_size;              /* Espaço de um texto no quadro, múltiplo de 8 */
+    int in_principal;
+    DataType return_type;
+    int return_label;
+    int result_offset;          /* Onde está o destino do texto retornado */
+    int ok;
+} CodegenAsm;
+
+static DataType emit_expression(CodegenAsm* cg, ASTNode* node);
+static void emit_statement(CodegenAsm* cg, ASTNode* node);
+
+static void emit(CodegenAsm* cg, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    fputs("    ", cg->out);
+    vfprintf(cg->out, format, args);
+    fputc('\n', cg->out);
+    va_end(args);
+}
+
+static void emit_label(CodegenAsm* cg, int label) {
+    fprintf(cg->out, ".L%d:\n", label);
+}
+
+/* Nome do símbolo: prefixo + nome; bytes fora de [A-Za-z0-9_] em hexadecimal */
+static void emit_symbol(FILE* out, const char* name) {
+    fputs("f_", out);
+    for (const unsigned char* c = (const unsigned char*)name; *c; c++) {
+        if (isalnum(*c) || *c == '_') {
+            fputc(*c, out);
+        } else {
+            fprintf(out, "_%02x", *c);
+        }
+    }
+}
+
+/* Literal de texto em .rodata; devolve o número do rótulo .LC */
+static int emit_string(CodegenAsm* cg, const char* text) {
+    int id = cg->strings++;
+    fprintf(cg->out, "    .pushsection .rodata\n.LC%d:\n    .string \"", id);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(cg->out, "\\%c", *c);
+        } else if (*c < 0x20 || *c >= 0x7f) {
+            fprintf(cg->out, "\\%03o", *c);
+        } else {
+            fputc(*c, cg->out);
+        }
+    }
+    fputs("\"\n    .popsection\n", cg->out);
+    return id;
+}
+
+static int alloc_slot(CodegenAsm* cg, int size) {
+    cg->frame_size += size;
+    return -cg->frame_size;
+}
+
+static int slot_size(CodegenAsm* cg, DataType type) {
+    return type == TYPE_TEXTO ? cg->text_size : 8;
+}
+
+static AsmVariable* find_variable(CodegenAsm* cg, InternId name_id) {
+    for (int i = cg->variable_count - 1; i >= 0; i--) {
+        if (cg->variables[i].name_id == name_id) return &cg->variables[i];
+    }
+    return NULL;
+}
+
+static void declare_variable(CodegenAsm* cg, InternId name_id, DataType type, int offset) {
+    if (cg->variable_count >= cg->variable_capacity) {
+        int capacity = cg->variable_capacity ? cg->variable_capacity * 2 : 32;
+        AsmVariable* variables = (AsmVariable*)MEMORY_REALLOC(g_memory_manager, cg->variables,
+                                                              (size_t)capacity * sizeof(AsmVariable));
+        if (!variables) {
+            cg->ok = 0;
+            return;
+        }
+        cg->variables = variables;
+        cg->variable_capacity = capacity;
+    }
+    AsmVariable* var = &cg->variables[cg->variable_count++];
+    var->name_id = name_id;
+    var->type = type;
+    var->offset = offset;
+}
+
+static int is_user_call(const ASTNode* node) {
+    return node->type == AST_FUNCTION_CALL && node->token.type == TOKEN_FUNCAO_ID;
+}
+
+static ASTNode* find_function(CodegenAsm* cg, InternId name_id) {
+    for (int i = 0; i < cg->function_count; i++) {
+        if (cg->functions[i]->name_id == name_id) return cg->functions[i];
+    }
+    return NULL;
+}
+
+/* Registrador de cada parâmetro conforme o System V (-1 = pilha):
+ * inteiros e endereços nos gerais, decimais nos xmm. O destino de um
+ * texto retornado ocupa %rdi. Retorna quantos vão para a pilha */
+static int classify_parameters(const ASTNode* function, int* location) {
+    int general = function->data.function->return_type == TYPE_TEXTO ? 1 : 0;
+    int sse = 0;
+    int stack = 0;
+
+    for (int i = 0; i < function->data.function->param_count; i++) {
+        if (function->data.function->params[i].type == TYPE_DECIMAL) {
+            location[i] = sse < ASM_SSE_REGS ? sse++ : -1;
+        } else {
+            location[i] = general < ASM_INT_REGS ? general++ : -1;
+        }
+        if (location[i] < 0) stack++;
+    }
+    return stack;
+}
+
+/* Chamada ao runtime ou à libm com a pilha alinhada */
+static void emit_runtime_call(CodegenAsm* cg, const char* name) {
+    if (cg->depth % 2) emit(cg, "subq $8, %%rsp");
+    emit(cg, "call %s", name);
+    if (cg->depth % 2) emit(cg, "addq $8, %%rsp");
+}
+
+static void push_result(CodegenAsm* cg, DataType type) {
+    if (type == TYPE_DECIMAL) emit(cg, "movq %%xmm0, %%rax");
+    emit(cg, "pushq %%rax");
+    cg->depth++;
+}
+
+/* Operandos de inteiros em %rax e %rcx, de decimais em %xmm0 e %xmm1 */
+static void pop_left(CodegenAsm* cg, DataType type) {
+    if (type == TYPE_DECIMAL) {
+        emit(cg, "movapd %%xmm0, %%xmm1");
+        emit(cg, "popq %%rax");
+        emit(cg, "movq %%rax, %%xmm0");
+    } else {
+        emit(cg, "movq %%rax, %%rcx");
+        emit(cg, "popq %%rax");
+    }
+    cg->depth--;
+}
+
+/* Copiar o texto apontado por %rax para o endereço em %rdi */
+static void emit_text_copy(CodegenAsm* cg) {
+    emit(cg, "movq %%rax, %%rsi");
+    emit(cg, "movl $%d, %%edx", g_config.max_string_length);
+    emit_runtime_call(cg, "rt_texto_copia");
+}
+
+static void emit_convert(CodegenAsm* cg, DataType from, DataType to) {
+    if (from == to) return;
+    if (from == TYPE_TEXTO || to == TYPE_TEXTO) {
+        cg->ok = 0;
+    } else if (to == TYPE_DECIMAL) {
+        emit(cg, "cvtsi2sdl %%eax, %%xmm0");
+    } else if (from == TYPE_DECIMAL) {
+        emit(cg, "cvttsd2si %%xmm0, %%eax");
+        emit(cg, "movslq %%eax, %%rax");
+    }
+}
+
+static void emit_value(CodegenAsm* cg, ASTNode* node, DataType want) {
+    emit_convert(cg, emit_expression(cg, node), want);
+}
+
+/* Verdade de um valor como 0 ou 1 em %rax, como no interpretador */
+static void emit_truth(CodegenAsm* cg, ASTNode* node) {
+    switch (emit_expression(cg, node)) {
+        case TYPE_DECIMAL:
+            emit(cg, "xorpd %%xmm1, %%xmm1");
+            emit(cg, "ucomisd %%xmm1, %%xmm0");
+            emit(cg, "setne %%al");
+            emit(cg, "setp %%cl");
+            emit(cg, "orb %%cl, %%al");
+            break;
+        case TYPE_TEXTO:
+            emit(cg, "cmpb $0, (%%rax)");
+            emit(cg, "setne %%al");
+            break;
+        default:
+            emit(cg, "testq %%rax, %%rax");
+            emit(cg, "setne %%al");
+            break;
+    }
+    emit(cg, "movzbl %%al, %%eax");
+}
+
+/* Destino do retorno de texto da função atual em %rdi */
+static void emit_result_address(CodegenAsm* cg) {
+    emit(cg, "movq %d(%%rbp), %%rdi", cg->result_offset);
+}
+
+/* Chamada de função do usuário. Argumentos são avaliados em ordem e
+ * empilhados; depois os da pilha são copiados para o topo e os demais
+ * carregados nos registradores. Em chamada de cauda o quadro atual é
+ * desfeito e a chamada vira um salto */
+static DataType emit_call(CodegenAsm* cg, ASTNode* node, int tail) {
+    ASTNode* callee = find_function(cg, node->name_id);
+    if (!callee || callee->data.function->param_count != node->child_count) {
+        cg->ok = 0;
+        return TYPE_INTEIRO;
+    }
+
+    int count = node->child_count;
+    int location[MAX_FUNCTION_PARAMS];
+    int stack = classify_parameters(callee, location);
+    DataType result = callee->data.function->return_type;
+    int result_offset = 0;
+    if (result == TYPE_TEXTO && !tail) result_offset = alloc_slot(cg, cg->text_size);
+
+    for (int i = 0; i < count; i++) {
+        DataType type = callee->data.function->params[i].type;
+        emit_value(cg, ast_get_child(node, i), type);
+        push_result(cg, type);
+    }
+
+    int pad = tail ? 0 : (cg->depth + stack) % 2;
+    if (pad) {
+        emit(cg, "subq $8, %%rsp");
+        cg->depth++;
+    }
+    int pushed = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        if (location[i] >= 0) continue;
+        emit(cg, "pushq %d(%%rsp)", 8 * (count - 1 - i + pad + pushed));
+        pushed++;
+        cg->depth++;
+    }
+    for (int i = 0; i < count; i++) {
+        if (location[i] < 0) continue;
+        int offset = 8 * (count - 1 - i + pad + stack);
+        if (callee->data.function->params[i].type == TYPE_DECIMAL) {
+            emit(cg, "movsd %d(%%rsp), %%xmm%d", offset, location[i]);
+        } else {
+            emit(cg, "movq %d(%%rsp), %s", offset, asm_int_regs[location[i]]);
+        }
+    }
+
+    if (tail) {
+        if (result == TYPE_TEXTO) emit_result_address(cg);
+        emit(cg, "leave");
+        fputs("    jmp ", cg->out);
+        emit_symbol(cg->out, callee->data.function->name);
+        fputc('\n', cg->out);
+        cg->depth -= count;
+        return result;
+    }
+
+    if (result == TYPE_TEXTO) emit(cg, "leaq %d(%%rbp), %%rdi", result_offset);
+    fputs("    call ", cg->out);
+    emit_symbol(cg->out, callee->data.function->name);
+    fputc('\n', cg->out);
+    if (count + pushed + pad > 0) emit(cg, "addq $%d, %%rsp", 8 * (count + pushed + pad));
+    cg->depth -= count + pushed + pad;
+    if (result == TYPE_TEXTO) emit(cg, "leaq %d(%%rbp), %%rax", result_offset);
+    return result;
+}
+
+static DataType emit_binary(CodegenAsm* cg, ASTNode* node) {
+    TokenType op = node->data.binary_op.operator;
+    ASTNode* left = ast_get_child(node, 0);
+    ASTNode* right = ast_get_child(node, 1);
+
+    /* Lógicos: os dois lados são sempre avaliados, como no interpretador */
+    if (op == TOKEN_E || op == TOKEN_OU) {
+        emit_truth(cg, left);
+        push_result(cg, TYPE_INTEIRO);
+        emit_truth(cg, right);
+        pop_left(cg, TYPE_INTEIRO);
+        emit(cg, op == TOKEN_E ? "andq %%rcx, %%rax" : "orq %%rcx, %%rax");
+        return TYPE_INTEIRO;
+    }
+
+    if (op == TOKEN_IGUAL || op == TOKEN_DIFERENTE || op == TOKEN_MENOR ||
+        op == TOKEN_MENOR_IGUAL || op == TOKEN_MAIOR || op == TOKEN_MAIOR_IGUAL) {
+        DataType type = TYPE_DECIMAL;
+        if (left->data_type == TYPE_TEXTO && right->data_type == TYPE_TEXTO) {
+            type = TYPE_TEXTO;
+        } else if (left->data_type == TYPE_INTEIRO && right->data_type == TYPE_INTEIRO) {
+            type = TYPE_INTEIRO;
+        }
+
+        emit_value(cg, left, type);
+        push_result(cg, type);
+        emit_value(cg, right, type);
+
+        if (type == TYPE_TEXTO) {
+            emit(cg, "movq %%rax, %%rsi");
+            emit(cg, "popq %%rdi");
+            cg->depth--;
+            if (op != TOKEN_IGUAL && op != TOKEN_DIFERENTE) {
+                emit(cg, "leaq .Lerro_texto(%%rip), %%rdi");
+                emit_runtime_call(cg, "rt_erro");
+                return TYPE_INTEIRO;
+            }
+            emit_runtime_call(cg, "rt_texto_compara");
+            emit(cg, "testl %%eax, %%eax");
+            emit(cg, op == TOKEN_IGUAL ? "sete %%al" : "setne %%al");
+        } else if (type == TYPE_INTEIRO) {
+            pop_left(cg, type);
+            emit(cg, "cmpq %%rcx, %%rax");
+            switch (op) {
+                case TOKEN_IGUAL: emit(cg, "sete %%al"); break;
+                case TOKEN_DIFERENTE: emit(cg, "setne %%al"); break;
+                case TOKEN_MENOR: emit(cg, "setl %%al"); break;
+                case TOKEN_MENOR_IGUAL: emit(cg, "setle %%al"); break;
+                case TOKEN_MAIOR: emit(cg, "setg %%al"); break;
+                default: emit(cg, "setge %%al"); break;
+            }
+        } else {
+            /* ucomisd deixa PF ligado quando há NaN: igual exige PF
+             * desligado e diferente aceita PF ligado */
+            pop_left(cg, type);
+            switch (op) {
+                case TOKEN_IGUAL:
+                    emit(cg, "ucomisd %%xmm1, %%xmm0");
+                    emit(cg, "sete %%al");
+                    emit(cg, "setnp %%cl");
+                    emit(cg, "andb %%cl, %%al");
+                    break;
+                case TOKEN_DIFERENTE:
+                    emit(cg, "ucomisd %%xmm1, %%xmm0");
+                    emit(cg, "setne %%al");
+                    emit(cg, "setp %%cl");
+                    emit(cg, "orb %%cl, %%al");
+                    break;
+                case TOKEN_MENOR:
+                    emit(cg, "ucomisd %%xmm0, %%xmm1");
+                    emit(cg, "seta %%al");
+                    break;
+                case TOKEN_MENOR_IGUAL:
+                    emit(cg, "ucomisd %%xmm0, %%xmm1");
+                    emit(cg, "setae %%al");
+                    break;
+                case TOKEN_MAIOR:
+                    emit(cg, "ucomisd %%xmm1, %%xmm0");
+                    emit(cg, "seta %%al");
+                    break;
+                default:
+                    emit(cg, "ucomisd %%xmm1, %%xmm0");
+                    emit(cg, "setae %%al");
+                    break;
+            }
+        }
+        emit(cg, "movzbl %%al, %%eax");
+        return TYPE_INTEIRO;
+    }
+
+    /* Aritméticos */
+    DataType type = node->data_type;
+    if (type != TYPE_INTEIRO && type != TYPE_DECIMAL) {
+        cg->ok = 0;
+        return TYPE_INTEIRO;
+    }
+
+    emit_value(cg, left, type);
+    push_result(cg, type);
+    emit_value(cg, right, type);
+    pop_left(cg, type);
+
+    if (type == TYPE_INTEIRO) {
+        switch (op) {
+            case TOKEN_MAIS: emit(cg, "addl %%ecx, %%eax"); break;
+            case TOKEN_MENOS: emit(cg, "subl %%ecx, %%eax"); break;
+            case TOKEN_MULT: emit(cg, "imull %%ecx, %%eax"); break;
+            case TOKEN_DIV: {
+                /* Divisor -1 vira negação: idivl de -2147483648 por -1 falharia */
+                int divide_label = cg->labels++;
+                int end_label = cg->labels++;
+                emit(cg, "testl %%ecx, %%ecx");
+                emit(cg, "je .Ldivisao_zero");
+                emit(cg, "cmpl $-1, %%ecx");
+                emit(cg, "jne .L%d", divide_label);
+                emit(cg, "negl %%eax");
+                emit(cg, "jmp .L%d", end_label);
+                emit_label(cg, divide_label);
+                emit(cg, "cltd");
+                emit(cg, "idivl %%ecx");
+                emit_label(cg, end_label);
+                break;
+            }
+            case TOKEN_POT:
+                emit(cg, "cvtsi2sdl %%eax, %%xmm0");
+                emit(cg, "cvtsi2sdl %%ecx, %%xmm1");
+                emit_runtime_call(cg, "pow@PLT");
+                emit(cg, "cvttsd2si %%xmm0, %%eax");
+                break;
+            default:
+                cg->ok = 0;
+                break;
+        }
+        emit(cg, "movslq %%eax, %%rax");
+    } else {
+        switch (op) {
+            case TOKEN_MAIS: emit(cg, "addsd %%xmm1, %%xmm0"); break;
+            case TOKEN_MENOS: emit(cg, "subsd %%xmm1, %%xmm0"); break;
+            case TOKEN_MULT: emit(cg, "mulsd %%xmm1, %%xmm0"); break;
+            case TOKEN_DIV: {
+                int label = cg->labels++;
+                emit(cg, "xorpd %%xmm2, %%xmm2");
+                emit(cg, "ucomisd %%xmm2, %%xmm1");
+                emit(cg, "jp .L%d", label);
+                emit(cg, "je .Ldivisao_zero");
+                emit_label(cg, label);
+                emit(cg, "divsd %%xmm1, %%xmm0");
+                break;
+            }
+            case TOKEN_POT:
+                emit_runtime_call(cg, "pow@PLT");
+                break;
+            default:
+                cg->ok = 0;
+                break;
+        }
+    }
+    return type;
+}
+
+/* Avaliar expressão; devolve o tipo do valor deixado em %rax ou %xmm0 */
+static DataType emit_expression(CodegenAsm* cg, ASTNode* node) {
+    switch (node->type) {
+        case AST_LITERAL:
+            if (node->data_type == TYPE_DECIMAL) {
+                long long bits;
+                memcpy(&bits, &node->data.literal.decimal_val, sizeof(bits));
+                emit(cg, "movabsq $%lld, %%rax", bits);
+                emit(cg, "movq %%rax, %%xmm0");
+            } else if (node->data_type == TYPE_TEXTO) {
+                int id = emit_string(cg, node->data.literal.string_val);
+                emit(cg, "leaq .LC%d(%%rip), %%rax", id);
+            } else {
+                emit(cg, "movq $%d, %%rax", node->data.literal.int_val);
+            }
+            return node->data_type == TYPE_VOID ? TYPE_INTEIRO : node->data_type;
+
+        case AST_IDENTIFIER: {
+            AsmVariable* var = find_variable(cg, node->name_id);
+            if (!var) {
+                cg->ok = 0;
+                return TYPE_INTEIRO;
+            }
+            if (var->type == TYPE_DECIMAL) {
+                emit(cg, "movsd %d(%%rbp), %%xmm0", var->offset);
+            } else if (var->type == TYPE_TEXTO) {
+                emit(cg, "leaq %d(%%rbp), %%rax", var->offset);
+            } else {
+                emit(cg, "movq %d(%%rbp), %%rax", var->offset);
+            }
+            return var->type;
+        }
+
+        case AST_BINARY_OP:
+            return emit_binary(cg, node);
+
+        case AST_FUNCTION_CALL:
+            if (is_user_call(node)) return emit_call(cg, node, 0);
+            /* fallthrough */
+        default:
+            cg->ok = 0;
+            return TYPE_INTEIRO;
+    }
+}
+
+/* Gravar o valor calculado na variável */
+static void emit_store(CodegenAsm* cg, DataType type, int offset) {
+    if (type == TYPE_DECIMAL) {
+        emit(cg, "movsd %%xmm0, %d(%%rbp)", offset);
+    } else if (type == TYPE_TEXTO) {
+        emit(cg, "leaq %d(%%rbp), %%rdi", offset);
+        emit_text_copy(cg);
+    } else {
+        emit(cg, "movq %%rax, %d(%%rbp)", offset);
+    }
+}
+
+/* Declaração: o inicializador é avaliado antes de o nome valer, então
+ * pode ler uma variável externa de mesmo nome */
+static void emit_declaration(CodegenAsm* cg, ASTNode* node) {
+    DataType type = node->data.var_decl.var_type;
+    int offset = alloc_slot(cg, slot_size(cg, type));
+
+    if (node->child_count > 0) {
+        emit_value(cg, ast_get_child(node, 0), type);
+        emit_store(cg, type, offset);
+    } else if (type == TYPE_TEXTO) {
+        emit(cg, "movb $0, %d(%%rbp)", offset);
+    } else {
+        emit(cg, "movq $0, %d(%%rbp)", offset);
+    }
+    declare_variable(cg, node->name_id, type, offset);
+}
+
+static void emit_assignment(CodegenAsm* cg, ASTNode* node) {
+    AsmVariable* var = find_variable(cg, ast_get_child(node, 0)->name_id);
+    if (!var) {
+        cg->ok = 0;
+        return;
+    }
+    DataType type = var->type;
+    int offset = var->offset;
+    emit_value(cg, ast_get_child(node, 1), type);
+    emit_store(cg, type, offset);
+}
+
+/* escreva: cada argumento é avaliado e impresso antes do seguinte */
+static void emit_write(CodegenAsm* cg, ASTNode* node) {
+    for (int i = 0; i < node->child_count; i++) {
+        switch (emit_expression(cg, ast_get_child(node, i))) {
+            case TYPE_DECIMAL:
+                emit_runtime_call(cg, "rt_escreva_decimal");
+                break;
+            case TYPE_TEXTO:
+                emit(cg, "movq %%rax, %%rdi");
+                emit_runtime_call(cg, "rt_escreva_texto");
+                break;
+            default:
+                emit(cg, "movq %%rax, %%rdi");
+                emit_runtime_call(cg, "rt_escreva_inteiro");
+                break;
+        }
+    }
+    emit_runtime_call(cg, "rt_escreva_fim");
+}
+
+static void emit_read(CodegenAsm* cg, ASTNode* node) {
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* arg = ast_get_child(node, i);
+        if (arg->type != AST_IDENTIFIER) continue;
+
+        AsmVariable* var = find_variable(cg, arg->name_id);
+        if (!var) {
+            cg->ok = 0;
+            return;
+        }
+        emit(cg, "leaq %d(%%rbp), %%rdi", var->offset);
+        if (var->type == TYPE_TEXTO) {
+            emit(cg, "movl $%d, %%esi", g_config.max_string_length);
+            emit_runtime_call(cg, "rt_leia_texto");
+        } else {
+            emit_runtime_call(cg, var->type == TYPE_DECIMAL ? "rt_leia_decimal" : "rt_leia_inteiro");
+            if (var->type != TYPE_DECIMAL) {
+                /* O runtime lê 64 bits; guarda só os 32 de inteiro */
+                emit(cg, "movslq %d(%%rbp), %%rax", var->offset);
+                emit(cg, "movq %%rax, %d(%%rbp)", var->offset);
+            }
+        }
+    }
+}
+
+/* Valor padrão de retorno quando a função termina sem retorno */
+static void emit_zero_result(CodegenAsm* cg) {
+    if (cg->return_type == TYPE_DECIMAL) {
+        emit(cg, "xorpd %%xmm0, %%xmm0");
+    } else if (cg->return_type == TYPE_TEXTO) {
+        emit(cg, "movq %d(%%rbp), %%rax", cg->result_offset);
+        emit(cg, "movb $0, (%%rax)");
+    } else {
+        emit(cg, "xorl %%eax, %%eax");
+    }
+}
+
+/* Chamada de cauda vira salto quando o quadro atual pode ser descartado:
+ * nenhum argumento de texto (apontaria para o quadro) nem na pilha */
+static int can_jump(CodegenAsm* cg, ASTNode* node, ASTNode* value) {
+    if (cg->in_principal || !node->data.return_stmt.tail_call || !is_user_call(value)) return 0;
+
+    ASTNode* callee = find_function(cg, value->name_id);
+    if (!callee || callee->data.function->return_type != cg->return_type ||
+        callee->data.function->param_count != value->child_count) {
+        return 0;
+    }
+    for (int i = 0; i < callee->data.function->param_count; i++) {
+        if (callee->data.function->params[i].type == TYPE_TEXTO) return 0;
+    }
+    int location[MAX_FUNCTION_PARAMS];
+    return classify_parameters(callee, location) == 0;
+}
+
+static void emit_return(CodegenAsm* cg, ASTNode* node) {
+    ASTNode* value = node->child_count > 0 ? ast_get_child(node, 0) : NULL;
+
+    if (value && can_jump(cg, node, value)) {
+        emit_call(cg, value, 1);
+        return;
+    }
+
+    if (cg->in_principal) {
+        /* Valor de principal é descartado, mas a avaliação pode ter efeito */
+        if (value) emit_expression(cg, value);
+    } else if (!value) {
+        emit_zero_result(cg);
+    } else {
+        emit_value(cg, value, cg->return_type);
+        if (cg->return_type == TYPE_TEXTO) {
+            emit_result_address(cg);
+            emit_text_copy(cg);
+            emit(cg, "movq %d(%%rbp), %%rax", cg->result_offset);
+        }
+    }
+    emit(cg, "jmp .L%d", cg->return_label);
+}
+
+static void emit_block(CodegenAsm* cg, ASTNode* node) {
+    int scope = cg->variable_count;
+    for (int i = 0; i < node->child_count; i++) {
+        emit_statement(cg, ast_get_child(node, i));
+    }
+    cg->variable_count = scope;
+}
+
+static void emit_statement(CodegenAsm* cg, ASTNode* node) {
+    switch (node->type) {
+        case AST_VAR_DECL:
+            emit_declaration(cg, node);
+            break;
+
+        case AST_ASSIGNMENT:
+            emit_assignment(cg, node);
+            break;
+
+        case AST_FUNCTION_CALL:
+            if (node->token.type == TOKEN_FUNCAO_ID) {
+                emit_call(cg, node, 0);
+            } else if (node->token.type == TOKEN_ESCREVA) {
+                emit_write(cg, node);
+            } else {
+                emit_read(cg, node);
+            }
+            break;
+
+        case AST_IF_STMT: {
+            int else_label = cg->labels++;
+            int end_label = cg->labels++;
+            emit_truth(cg, ast_get_child(node, 0));
+            emit(cg, "testq %%rax, %%rax");
+            emit(cg, "je .L%d", else_label);
+            emit_block(cg, ast_get_child(node, 1));
+            emit(cg, "jmp .L%d", end_label);
+            emit_label(cg, else_label);
+            if (node->child_count > 2) emit_block(cg, ast_get_child(node, 2));
+            emit_label(cg, end_label);
+            break;
+        }
+
+        case AST_FOR_STMT: {
+            int condition_label = cg->labels++;
+            int end_label = cg->labels++;
+            emit_assignment(cg, ast_get_child(node, 0));
+            emit_label(cg, condition_label);
+            emit_truth(cg, ast_get_child(node, 1));
+            emit(cg, "testq %%rax, %%rax");
+            emit(cg, "je .L%d", end_label);
+            emit_block(cg, ast_get_child(node, 3));
+            emit_assignment(cg, ast_get_child(node, 2));
+            emit(cg, "jmp .L%d", condition_label);
+            emit_label(cg, end_label);
+            break;
+        }
+
+        case AST_WHILE_STMT: {
+            int condition_label = cg->labels++;
+            int end_label = cg->labels++;
+            emit_label(cg, condition_label);
+            emit_truth(cg, ast_get_child(node, 0));
+            emit(cg, "testq %%rax, %%rax");
+            emit(cg, "je .L%d", end_label);
+            emit_block(cg, ast_get_child(node, 1));
+            emit(cg, "jmp .L%d", condition_label);
+            emit_label(cg, end_label);
+            break;
+        }
+
+        case AST_RETURN_STMT:
+            emit_return(cg, node);
+            break;
+
+        case AST_BLOCK:
+            emit_block(cg, node);
+            break;
+
+        default:
+            for (int i = 0; i < node->child_count; i++) {
+                emit_statement(cg, ast_get_child(node, i));
+            }
+            break;
+    }
+}
+
+/* Função: corpo gerado num arquivo temporário, pois o tamanho do quadro
+ * só é conhecido no fim */
+static int emit_function(CodegenAsm* cg, ASTNode* function, FILE* out) {
+    FILE* body = tmpfile();
+    if (!body) return 0;
+
+    cg->out = body;
+    cg->frame_size = 0;
+    cg->depth = 0;
+    cg->variable_count = 0;
+    cg->in_principal = strcmp(function->data.function->name, "principal") == 0;
+    cg->return_type = function->data.function->return_type;
+    cg->return_label = cg->labels++;
+    cg->result_offset = 0;
+
+    /* Parâmetros dos registradores vão para o quadro; os da pilha ficam
+     * acima do endereço de retorno. Textos são copiados depois que todos
+     * os registradores foram salvos */
+    int location[MAX_FUNCTION_PARAMS];
+    int incoming[MAX_FUNCTION_PARAMS];
+    int count = cg->in_principal ? 0 : function->data.function->param_count;
+    classify_parameters(function, location);
+
+    if (!cg->in_principal && cg->return_type == TYPE_TEXTO) {
+        cg->result_offset = alloc_slot(cg, 8);
+        emit(cg, "movq %%rdi, %d(%%rbp)", cg->result_offset);
+    }
+
+    int stack_index = 0;
+    for (int i = 0; i < count; i++) {
+        if (location[i] < 0) {
+            incoming[i] = 16 + 8 * stack_index++;
+        } else {
+            incoming[i] = alloc_slot(cg, 8);
+            if (function->data.function->params[i].type == TYPE_DECIMAL) {
+                emit(cg, "movsd %%xmm%d, %d(%%rbp)", location[i], incoming[i]);
+            } else {
+                emit(cg, "movq %s, %d(%%rbp)", asm_int_regs[location[i]], incoming[i]);
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        DataType type = function->data.function->params[i].type;
+        int offset = incoming[i];
+        if (type == TYPE_TEXTO) {
+            offset = alloc_slot(cg, cg->text_size);
+            emit(cg, "movq %d(%%rbp), %%rax", incoming[i]);
+            emit(cg, "leaq %d(%%rbp), %%rdi", offset);
+            emit_text_copy(cg);
+        }
+        declare_variable(cg, function->data.function->params[i].name_id, type, offset);
+    }
+
+    if (function->child_count > 0) {
+        emit_statement(cg, ast_get_child(function, 0));
+    }
+    if (!cg->in_principal) emit_zero_result(cg);
+    emit_label(cg, cg->return_label);
+    emit(cg, "leave");
+    emit(cg, "ret");
+
+    int frame = (cg->frame_size + 15) & ~15;
+    emit_symbol(out, function->data.function->name);
+    fputs(":\n    pushq %rbp\n    movq %rsp, %rbp\n", out);
+    if (frame > 0) fprintf(out, "    subq $%d, %%rsp\n", frame);
+
+    char buffer[4096];
+    size_t size;
+    rewind(body);
+    while ((size = fread(buffer, 1, sizeof(buffer), body)) > 0) {
+        fwrite(buffer, 1, size, out);
+    }
+    fclose(body);
+    fputc('\n', out);
+    return 1;
+}
+
+/* Gerar o programa em assembly; retorna 0 se alguma construção não tem tradução */
+int codegen_asm_emit(ASTNode* program, FILE* out) {
+    if (!program || !out || program->type != AST_PROGRAM) return 0;
+
+    CodegenAsm cg;
+    memset(&cg, 0, sizeof(cg));
+    cg.ok = 1;
+    cg.text_size = (g_config.max_string_length + 7) & ~7;
+    cg.functions = (ASTNode**)MEMORY_ALLOC(g_memory_manager,
+                                           (size_t)(program->child_count + 1) * sizeof(ASTNode*));
+    if (!cg.functions) return 0;
+
+    int has_principal = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type != AST_FUNCTION_DEF || child->data.function->body_pending) continue;
+        cg.functions[cg.function_count++] = child;
+        if (strcmp(child->data.function->name, "principal") == 0) has_principal = 1;
+    }
+
+    fputs("# Gerado pelo compilador a partir da AST verificada\n"
+          "    .text\n\n", out);
+    for (int i = 0; i < cg.function_count && cg.ok && has_principal; i++) {
+        if (!emit_function(&cg, cg.functions[i], out)) cg.ok = 0;
+    }
+
+    /* Na divisão por zero a pilha pode ter operandos pendentes, então é
+     * realinhada antes de chamar o runtime */
+    fputs("    .globl main\n"
+          "main:\n"
+          "    pushq %rbp\n"
+          "    movq %rsp, %rbp\n"
+          "    call f_principal\n"
+          "    xorl %eax, %eax\n"
+          "    popq %rbp\n"
+          "    ret\n\n"
+          ".Ldivisao_zero:\n"
+          "    andq $-16, %rsp\n"
+          "    leaq .Lerro_divisao(%rip), %rdi\n"
+          "    call rt_erro\n\n"
+          "    .section .rodata\n"
+          ".Lerro_divisao:\n"
+          "    .string \"Divis\\303\\243o por zero\"\n"
+          ".Lerro_texto:\n"
+          "    .string \"Operador n\\303\\243o suportado para texto\"\n"
+          "    .section .note.GNU-stack,\"\",@progbits\n", out);
+
+    if (cg.variables) memory_free(g_memory_manager, cg.variables);
+    memory_free(g_memory_manager, cg.functions);
+    return cg.ok && has_principal;
+}
@@ -0,0 +1,795 @@
+#include "../include/compiler.h"
+
+/* Tradução da AST verificada para C99. inteiro vira int32_t, como no
+ * interpretador, com soma, subtração e multiplicação em complemento de
+ * dois (estouro dá a volta em vez de ser comportamento indefinido) e o
+ * runtime recebendo int64_t só nas bordas; decimal vira double e texto
+ * um vetor de tamanho fixo (max_string_length) dentro de uma struct,
+ * copiada por valor como no interpretador. A ordem de avaliação da
+ * linguagem é da esquerda para a direita; quando os dois
+ * lados de uma operação podem ter efeito (chamada ou divisão que falha),
+ * os valores passam por temporárias sequenciadas com o operador vírgula. */
+
+/* Temporárias por tipo */
+enum { TEMP_INTEIRO, TEMP_DECIMAL, TEMP_TEXTO, TEMP_KINDS };
+
+/* Forma de um operando */
+typedef enum {
+    OPERAND_VALUE,              /* Valor do tipo pedido */
+    OPERAND_TEXT,               /* Ponteiro para os caracteres de um texto */
+    OPERAND_BOOL                /* Verdade como 0 ou 1 */
+} OperandMode;
+
+typedef struct {
+    ASTNode* node;
+    DataType type;              /* Tipo do valor (o de origem em OPERAND_BOOL) */
+    OperandMode mode;
+    int temp;                   /* Temporária já avaliada, -1 se nenhuma */
+} Operand;
+
+typedef struct {
+    FILE* out;                  /* Corpo da função em geração */
+    ASTNode** functions;        /* Definições, para os tipos dos parâmetros */
+    int function_count;
+    int temps[TEMP_KINDS];      /* Temporárias usadas na função atual */
+    int indent;
+    int in_principal;
+    DataType return_type;
+    int ok;
+} CodegenC;
+
+static void emit_value(CodegenC* cg, ASTNode* node, DataType want);
+static void emit_operand(CodegenC* cg, const Operand* operand);
+static void emit_statement(CodegenC* cg, ASTNode* node);
+
+static int temp_kind(DataType type) {
+    if (type == TYPE_DECIMAL) return TEMP_DECIMAL;
+    if (type == TYPE_TEXTO) return TEMP_TEXTO;
+    return TEMP_INTEIRO;
+}
+
+static const char* c_type(DataType type) {
+    switch (type) {
+        case TYPE_DECIMAL: return "double";
+        case TYPE_TEXTO: return "rt_texto";
+        default: return "int32_t";
+    }
+}
+
+static int new_temp(CodegenC* cg, DataType type) {
+    return cg->temps[temp_kind(type)]++;
+}
+
+static void emit_temp(CodegenC* cg, DataType type, int index) {
+    static const char prefix[TEMP_KINDS] = {'i', 'd', 't'};
+    fprintf(cg->out, "t%c%d", prefix[temp_kind(type)], index);
+}
+
+static void emit_indent(CodegenC* cg) {
+    for (int i = 0; i < cg->indent; i++) fputs("    ", cg->out);
+}
+
+/* Nome C: prefixo + nome da linguagem; bytes fora de [A-Za-z0-9_] em hexadecimal */
+static void emit_name(FILE* out, const char* prefix, const char* name) {
+    fputs(prefix, out);
+    for (const unsigned char* c = (const unsigned char*)name; *c; c++) {
+        if (isalnum(*c) || *c == '_') {
+            fputc(*c, out);
+        } else {
+            fprintf(out, "_%02x", *c);
+        }
+    }
+}
+
+static void emit_variable(CodegenC* cg, InternId name_id) {
+    const char* name = intern_text(name_id);
+    emit_name(cg->out, "v_", name[0] == '!' ? name + 1 : name);
+}
+
+static void emit_function_name(FILE* out, const char* name) {
+    emit_name(out, "f_", name);
+}
+
+/* Literal de texto como string C; '?' escapado por causa dos trígrafos */
+static void emit_c_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        switch (*c) {
+            case '"': fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\t': fputs("\\t", out); break;
+            case '?': fputs("\\?", out); break;
+            default:
+                if (*c < 0x20 || *c == 0x7f) {
+                    fprintf(out, "\\%03o", *c);
+                } else {
+                    fputc(*c, out);
+                }
+                break;
+        }
+    }
+    fputc('"', out);
+}
+
+static void emit_decimal(FILE* out, double value) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.17g", value);
+    fputs(buffer, out);
+    if (!strpbrk(buffer, ".eEni")) fputs(".0", out);
+}
+
+static int is_user_call(const ASTNode* node) {
+    return node->type == AST_FUNCTION_CALL && node->token.type == TOKEN_FUNCAO_ID;
+}
+
+/* Avaliar a expressão pode ter efeito visível: chamada de função ou
+ * divisão, que interrompe a execução com erro */
+static int has_effect(ASTNode* node) {
+    if (is_user_call(node)) return 1;
+    if (node->type == AST_BINARY_OP && node->data.binary_op.operator == TOKEN_DIV) return 1;
+    for (int i = 0; i < node->child_count; i++) {
+        if (has_effect(ast_get_child(node, i))) return 1;
+    }
+    return 0;
+}
+
+/* A expressão lê a variável de nome dado */
+static int uses_variable(ASTNode* node, InternId name_id) {
+    if (node->type == AST_IDENTIFIER && node->name_id == name_id) return 1;
+    for (int i = 0; i < node->child_count; i++) {
+        if (uses_variable(ast_get_child(node, i), name_id)) return 1;
+    }
+    return 0;
+}
+
+static ASTNode* find_function(CodegenC* cg, InternId name_id) {
+    for (int i = 0; i < cg->function_count; i++) {
+        if (cg->functions[i]->name_id == name_id) return cg->functions[i];
+    }
+    return NULL;
+}
+
+/* Chamada de função do usuário; argumentos convertidos aos tipos dos
+ * parâmetros. Com mais de um argumento com efeito, todos esses são
+ * avaliados antes, em ordem, em temporárias */
+static void emit_call(CodegenC* cg, ASTNode* node) {
+    ASTNode* callee = find_function(cg, node->name_id);
+    if (!callee || callee->data.function->param_count != node->child_count) {
+        cg->ok = 0;
+        fputs("0", cg->out);
+        return;
+    }
+
+    int temps[MAX_FUNCTION_PARAMS];
+    int effects = 0;
+    for (int i = 0; i < node->child_count; i++) {
+        effects += has_effect(ast_get_child(node, i));
+    }
+
+    if (effects > 1) fputc('(', cg->out);
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* arg = ast_get_child(node, i);
+        DataType type = callee->data.function->params[i].type;
+        temps[i] = -1;
+        if (effects > 1 && has_effect(arg)) {
+            temps[i] = new_temp(cg, type);
+            emit_temp(cg, type, temps[i]);
+            fputs(" = ", cg->out);
+            emit_value(cg, arg, type);
+            fputs(", ", cg->out);
+        }
+    }
+
+    emit_function_name(cg->out, intern_text(node->name_id));
+    fputc('(', cg->out);
+    for (int i = 0; i < node->child_count; i++) {
+        DataType type = callee->data.function->params[i].type;
+        if (i > 0) fputs(", ", cg->out);
+        if (temps[i] >= 0) {
+            emit_temp(cg, type, temps[i]);
+        } else {
+            emit_value(cg, ast_get_child(node, i), type);
+        }
+    }
+    fputc(')', cg->out);
+    if (effects > 1) fputc(')', cg->out);
+}
+
+/* Texto como struct (atribuições, argumentos e retornos) */
+static void emit_text_value(CodegenC* cg, ASTNode* node) {
+    if (node->type == AST_LITERAL) {
+        fputs("rt_texto_de(", cg->out);
+        emit_c_string(cg->out, node->data.literal.string_val);
+        fputc(')', cg->out);
+    } else if (node->type == AST_IDENTIFIER) {
+        emit_variable(cg, node->name_id);
+    } else if (is_user_call(node)) {
+        emit_call(cg, node);
+    } else {
+        cg->ok = 0;
+        fputs("rt_texto_de(\"\")", cg->out);
+    }
+}
+
+/* Texto como ponteiro para os caracteres (saída e comparações); o
+ * retorno de uma chamada fica numa temporária para ter endereço */
+static void emit_text_chars(CodegenC* cg, ASTNode* node) {
+    if (node->type == AST_LITERAL) {
+        emit_c_string(cg->out, node->data.literal.string_val);
+    } else if (node->type == AST_IDENTIFIER) {
+        emit_variable(cg, node->name_id);
+        fputs(".s", cg->out);
+    } else {
+        int temp = new_temp(cg, TYPE_TEXTO);
+        fputc('(', cg->out);
+        emit_temp(cg, TYPE_TEXTO, temp);
+        fputs(" = ", cg->out);
+        emit_text_value(cg, node);
+        fputs(", ", cg->out);
+        emit_temp(cg, TYPE_TEXTO, temp);
+        fputs(".s)", cg->out);
+    }
+}
+
+/* Par de operandos de um operador binário, avaliados em ordem */
+static void emit_binary(CodegenC* cg, ASTNode* node) {
+    TokenType op = node->data.binary_op.operator;
+    ASTNode* left_node = ast_get_child(node, 0);
+    ASTNode* right_node = ast_get_child(node, 1);
+    Operand left = {left_node, node->data_type, OPERAND_VALUE, -1};
+    Operand right = {right_node, node->data_type, OPERAND_VALUE, -1};
+
+    switch (op) {
+        case TOKEN_IGUAL: case TOKEN_DIFERENTE: case TOKEN_MENOR:
+        case TOKEN_MENOR_IGUAL: case TOKEN_MAIOR: case TOKEN_MAIOR_IGUAL:
+            if (left_node->data_type == TYPE_TEXTO && right_node->data_type == TYPE_TEXTO) {
+                left.type = right.type = TYPE_TEXTO;
+                left.mode = right.mode = OPERAND_TEXT;
+            } else if (left_node->data_type == TYPE_INTEIRO && right_node->data_type == TYPE_INTEIRO) {
+                left.type = right.type = TYPE_INTEIRO;
+            } else {
+                left.type = right.type = TYPE_DECIMAL;
+            }
+            break;
+        case TOKEN_E: case TOKEN_OU:
+            left.type = left_node->data_type;
+            right.type = right_node->data_type;
+            left.mode = right.mode = OPERAND_BOOL;
+            break;
+        default:
+            if (node->data_type != TYPE_INTEIRO && node->data_type != TYPE_DECIMAL) {
+                cg->ok = 0;
+                fputs("0", cg->out);
+                return;
+            }
+            break;
+    }
+
+    int sequenced = has_effect(left_node) && has_effect(right_node);
+    if (sequenced) {
+        Operand* operands[2] = {&left, &right};
+        fputc('(', cg->out);
+        for (int i = 0; i < 2; i++) {
+            operands[i]->temp = new_temp(cg, operands[i]->type);
+            emit_temp(cg, operands[i]->type, operands[i]->temp);
+            fputs(" = ", cg->out);
+            emit_value(cg, operands[i]->node, operands[i]->type);
+            fputs(", ", cg->out);
+        }
+    }
+
+    if (left.mode == OPERAND_TEXT) {
+        const char* compare = op == TOKEN_IGUAL ? "==" : op == TOKEN_DIFERENTE ? "!=" : NULL;
+        if (compare) {
+            fputs("(strcmp(", cg->out);
+            emit_operand(cg, &left);
+            fputs(", ", cg->out);
+            emit_operand(cg, &right);
+            fprintf(cg->out, ") %s 0)", compare);
+        } else {
+            fputs("(rt_erro(\"Operador não suportado para texto\"), 0)", cg->out);
+        }
+    } else if (op == TOKEN_DIV || op == TOKEN_POT) {
+        int decimal = node->data_type == TYPE_DECIMAL;
+        if (op == TOKEN_DIV) {
+            fputs(decimal ? "rt_div_decimal(" : "rt_div_inteiro(", cg->out);
+        } else {
+            fputs(decimal ? "pow(" : "(int32_t)pow(", cg->out);
+        }
+        emit_operand(cg, &left);
+        fputs(", ", cg->out);
+        emit_operand(cg, &right);
+        fputc(')', cg->out);
+    } else if (node->data_type == TYPE_INTEIRO &&
+               (op == TOKEN_MAIS || op == TOKEN_MENOS || op == TOKEN_MULT)) {
+        fputs(op == TOKEN_MAIS ? "rt_soma(" : op == TOKEN_MENOS ? "rt_subtrai(" : "rt_multiplica(",
+              cg->out);
+        emit_operand(cg, &left);
+        fputs(", ", cg->out);
+        emit_operand(cg, &right);
+        fputc(')', cg->out);
+    } else {
+        const char* symbol = "+";
+        switch (op) {
+            case TOKEN_MENOS: symbol = "-"; break;
+            case TOKEN_MULT: symbol = "*"; break;
+            case TOKEN_IGUAL: symbol = "=="; break;
+            case TOKEN_DIFERENTE: symbol = "!="; break;
+            case TOKEN_MENOR: symbol = "<"; break;
+            case TOKEN_MENOR_IGUAL: symbol = "<="; break;
+            case TOKEN_MAIOR: symbol = ">"; break;
+            case TOKEN_MAIOR_IGUAL: symbol = ">="; break;
+            /* Os dois lados são sempre avaliados, como no interpretador */
+            case TOKEN_E: symbol = "&"; break;
+            case TOKEN_OU: symbol = "|"; break;
+            default: break;
+        }
+        fputc('(', cg->out);
+        emit_operand(cg, &left);
+        fprintf(cg->out, " %s ", symbol);
+        emit_operand(cg, &right);
+        fputc(')', cg->out);
+    }
+
+    if (sequenced) fputc(')', cg->out);
+}
+
+static void emit_operand(CodegenC* cg, const Operand* operand) {
+    if (operand->mode == OPERAND_BOOL) {
+        fputc('(', cg->out);
+        if (operand->type == TYPE_TEXTO) {
+            if (operand->temp >= 0) {
+                emit_temp(cg, TYPE_TEXTO, operand->temp);
+                fputs(".s", cg->out);
+            } else {
+                emit_text_chars(cg, operand->node);
+            }
+            fputs("[0] != '\\0')", cg->out);
+        } else {
+            if (operand->temp >= 0) {
+                emit_temp(cg, operand->type, operand->temp);
+            } else {
+                emit_value(cg, operand->node, operand->type);
+            }
+            fputs(" != 0)", cg->out);
+        }
+    } else if (operand->temp >= 0) {
+        emit_temp(cg, operand->type, operand->temp);
+        if (operand->mode == OPERAND_TEXT) fputs(".s", cg->out);
+    } else if (operand->mode == OPERAND_TEXT) {
+        emit_text_chars(cg, operand->node);
+    } else {
+        emit_value(cg, operand->node, operand->type);
+    }
+}
+
+/* Expressão convertida ao tipo pedido (decimal para inteiro trunca) */
+static void emit_value(CodegenC* cg, ASTNode* node, DataType want) {
+    if (want == TYPE_TEXTO || node->data_type == TYPE_TEXTO) {
+        if (want != node->data_type) {
+            cg->ok = 0;
+            fputs("0", cg->out);
+            return;
+        }
+        emit_text_value(cg, node);
+        return;
+    }
+
+    int cast = want != node->data_type && want != TYPE_VOID;
+    if (cast) fprintf(cg->out, "((%s)", c_type(want));
+
+    switch (node->type) {
+        case AST_LITERAL:
+            if (node->data_type == TYPE_DECIMAL) {
+                emit_decimal(cg->out, node->data.literal.decimal_val);
+            } else {
+                fprintf(cg->out, "INT32_C(%d)", node->data.literal.int_val);
+            }
+            break;
+        case AST_IDENTIFIER:
+            emit_variable(cg, node->name_id);
+            break;
+        case AST_BINARY_OP:
+            emit_binary(cg, node);
+            break;
+        case AST_FUNCTION_CALL:
+            if (is_user_call(node)) {
+                emit_call(cg, node);
+                break;
+            }
+            /* fallthrough */
+        default:
+            cg->ok = 0;
+            fputs("0", cg->out);
+            break;
+    }
+
+    if (cast) fputc(')', cg->out);
+}
+
+/* Condição de se/para/enquanto, com a mesma verdade do interpretador */
+static void emit_condition(CodegenC* cg, ASTNode* node) {
+    Operand operand = {node, node->data_type, OPERAND_BOOL, -1};
+    emit_operand(cg, &operand);
+}
+
+static void emit_assignment(CodegenC* cg, ASTNode* node) {
+    ASTNode* target = ast_get_child(node, 0);
+    emit_variable(cg, target->name_id);
+    fputs(" = ", cg->out);
+    emit_value(cg, ast_get_child(node, 1), target->data_type);
+}
+
+static void emit_block(CodegenC* cg, ASTNode* node) {
+    fputs("{\n", cg->out);
+    cg->indent++;
+    for (int i = 0; i < node->child_count; i++) {
+        emit_statement(cg, ast_get_child(node, i));
+    }
+    cg->indent--;
+    emit_indent(cg);
+    fputc('}', cg->out);
+}
+
+/* escreva: cada argumento é avaliado e impresso antes do seguinte */
+static void emit_write(CodegenC* cg, ASTNode* node) {
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* arg = ast_get_child(node, i);
+        emit_indent(cg);
+        switch (arg->data_type) {
+            case TYPE_TEXTO:
+                fputs("rt_escreva_texto(", cg->out);
+                emit_text_chars(cg, arg);
+                break;
+            case TYPE_DECIMAL:
+                fputs("rt_escreva_decimal(", cg->out);
+                emit_value(cg, arg, TYPE_DECIMAL);
+                break;
+            default:
+                fputs("rt_escreva_inteiro(", cg->out);
+                emit_value(cg, arg, TYPE_INTEIRO);
+                break;
+        }
+        fputs(");\n", cg->out);
+    }
+    emit_indent(cg);
+    fputs("rt_escreva_fim();\n", cg->out);
+}
+
+static void emit_read(CodegenC* cg, ASTNode* node) {
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* arg = ast_get_child(node, i);
+        if (arg->type != AST_IDENTIFIER) continue;
+        emit_indent(cg);
+        switch (arg->data_type) {
+            case TYPE_TEXTO:
+                fputs("rt_leia_texto(", cg->out);
+                emit_variable(cg, arg->name_id);
+                fputs(".s, (int)sizeof(", cg->out);
+                emit_variable(cg, arg->name_id);
+                fputs(".s));\n", cg->out);
+                break;
+            case TYPE_DECIMAL:
+                fputs("rt_leia_decimal(&", cg->out);
+                emit_variable(cg, arg->name_id);
+                fputs(");\n", cg->out);
+                break;
+            default:
+                fputs("rt_leia_inteiro32(&", cg->out);
+                emit_variable(cg, arg->name_id);
+                fputs(");\n", cg->out);
+                break;
+        }
+    }
+}
+
+/* Declaração; se o inicializador lê uma variável externa de mesmo nome,
+ * ele é avaliado antes numa temporária, pois em C o novo nome já vale */
+static void emit_declaration(CodegenC* cg, ASTNode* node) {
+    DataType type = node->data.var_decl.var_type;
+    ASTNode* init = node->child_count > 0 ? ast_get_child(node, 0) : NULL;
+    int temp = -1;
+
+    if (init && uses_variable(init, node->name_id)) {
+        temp = new_temp(cg, type);
+        emit_indent(cg);
+        emit_temp(cg, type, temp);
+        fputs(" = ", cg->out);
+        emit_value(cg, init, type);
+        fputs(";\n", cg->out);
+    }
+
+    emit_indent(cg);
+    fprintf(cg->out, "%s ", c_type(type));
+    emit_variable(cg, node->name_id);
+    if (temp >= 0) {
+        fputs(" = ", cg->out);
+        emit_temp(cg, type, temp);
+    } else if (init) {
+        fputs(" = ", cg->out);
+        emit_value(cg, init, type);
+    } else if (type == TYPE_TEXTO) {
+        fputs(";\n", cg->out);
+        emit_indent(cg);
+        emit_variable(cg, node->name_id);
+        fputs(".s[0] = '\\0'", cg->out);
+    } else {
+        fputs(type == TYPE_DECIMAL ? " = 0.0" : " = 0", cg->out);
+    }
+    fputs(";\n", cg->out);
+}
+
+static void emit_zero(CodegenC* cg, DataType type) {
+    switch (type) {
+        case TYPE_DECIMAL: fputs("0.0", cg->out); break;
+        case TYPE_TEXTO: fputs("rt_texto_de(\"\")", cg->out); break;
+        default: fputs("0", cg->out); break;
+    }
+}
+
+static void emit_return(CodegenC* cg, ASTNode* node) {
+    ASTNode* value = node->child_count > 0 ? ast_get_child(node, 0) : NULL;
+
+    emit_indent(cg);
+    if (cg->in_principal) {
+        /* Valor de principal é descartado, mas a avaliação pode ter efeito */
+        if (value && has_effect(value)) {
+            fputs("(void)", cg->out);
+            emit_value(cg, value, value->data_type);
+            fputs(";\n", cg->out);
+            emit_indent(cg);
+        }
+        fputs("return;\n", cg->out);
+        return;
+    }
+
+    fputs("return ", cg->out);
+    if (value) {
+        emit_value(cg, value, cg->return_type);
+    } else {
+        emit_zero(cg, cg->return_type);
+    }
+    fputs(";\n", cg->out);
+}
+
+static void emit_statement(CodegenC* cg, ASTNode* node) {
+    switch (node->type) {
+        case AST_VAR_DECL:
+            emit_declaration(cg, node);
+            break;
+
+        case AST_ASSIGNMENT:
+            emit_indent(cg);
+            emit_assignment(cg, node);
+            fputs(";\n", cg->out);
+            break;
+
+        case AST_FUNCTION_CALL:
+            if (node->token.type == TOKEN_FUNCAO_ID) {
+                emit_indent(cg);
+                emit_call(cg, node);
+                fputs(";\n", cg->out);
+            } else if (node->token.type == TOKEN_ESCREVA) {
+                emit_write(cg, node);
+            } else {
+                emit_read(cg, node);
+            }
+            break;
+
+        case AST_IF_STMT:
+            emit_indent(cg);
+            fputs("if (", cg->out);
+            emit_condition(cg, ast_get_child(node, 0));
+            fputs(") ", cg->out);
+            emit_block(cg, ast_get_child(node, 1));
+            if (node->child_count > 2) {
+                fputs(" else ", cg->out);
+                emit_block(cg, ast_get_child(node, 2));
+            }
+            fputc('\n', cg->out);
+            break;
+
+        case AST_FOR_STMT:
+            emit_indent(cg);
+            fputs("for (", cg->out);
+            emit_assignment(cg, ast_get_child(node, 0));
+            fputs("; ", cg->out);
+            emit_condition(cg, ast_get_child(node, 1));
+            fputs("; ", cg->out);
+            emit_assignment(cg, ast_get_child(node, 2));
+            fputs(") ", cg->out);
+            emit_block(cg, ast_get_child(node, 3));
+            fputc('\n', cg->out);
+            break;
+
+        case AST_WHILE_STMT:
+            emit_indent(cg);
+            fputs("while (", cg->out);
+            emit_condition(cg, ast_get_child(node, 0));
+            fputs(") ", cg->out);
+            emit_block(cg, ast_get_child(node, 1));
+            fputc('\n', cg->out);
+            break;
+
+        case AST_RETURN_STMT:
+            emit_return(cg, node);
+            break;
+
+        case AST_BLOCK:
+            emit_indent(cg);
+            emit_block(cg, node);
+            fputc('\n', cg->out);
+            break;
+
+        default:
+            for (int i = 0; i < node->child_count; i++) {
+                emit_statement(cg, ast_get_child(node, i));
+            }
+            break;
+    }
+}
+
+static void emit_signature(FILE* out, ASTNode* function) {
+    if (strcmp(function->data.function->name, "principal") == 0) {
+        fputs("static void f_principal(void)", out);
+        return;
+    }
+
+    fprintf(out, "static %s ", c_type(function->data.function->return_type));
+    emit_function_name(out, function->data.function->name);
+    fputc('(', out);
+    for (int i = 0; i < function->data.function->param_count; i++) {
+        const char* name = intern_text(function->data.function->params[i].name_id);
+        if (i > 0) fputs(", ", out);
+        fprintf(out, "%s ", c_type(function->data.function->params[i].type));
+        emit_name(out, "v_", name[0] == '!' ? name + 1 : name);
+    }
+    if (function->data.function->param_count == 0) fputs("void", out);
+    fputc(')', out);
+}
+
+/* Função: corpo gerado num arquivo temporário para que as temporárias
+ * usadas sejam declaradas no início */
+static int emit_function(CodegenC* cg, ASTNode* function, FILE* out) {
+    FILE* body = tmpfile();
+    if (!body) return 0;
+
+    cg->out = body;
+    cg->indent = 1;
+    cg->in_principal = strcmp(function->data.function->name, "principal") == 0;
+    cg->return_type = function->data.function->return_type;
+    for (int i = 0; i < TEMP_KINDS; i++) cg->temps[i] = 0;
+
+    /* O bloco do corpo é um escopo próprio, como no interpretador, então
+     * locais podem ter o nome de parâmetros */
+    if (function->child_count > 0) {
+        emit_statement(cg, ast_get_child(function, 0));
+    }
+    if (!cg->in_principal) {
+        fputs("    return ", body);
+        emit_zero(cg, cg->return_type);
+        fputs(";\n", body);
+    }
+
+    emit_signature(out, function);
+    fputs(" {\n", out);
+    static const DataType temp_types[TEMP_KINDS] = {TYPE_INTEIRO, TYPE_DECIMAL, TYPE_TEXTO};
+    for (int kind = 0; kind < TEMP_KINDS; kind++) {
+        for (int i = 0; i < cg->temps[kind]; i++) {
+            cg->out = out;
+            fprintf(out, "    %s ", c_type(temp_types[kind]));
+            emit_temp(cg, temp_types[kind], i);
+            fputs(";\n", out);
+        }
+    }
+
+    char buffer[4096];
+    size_t size;
+    rewind(body);
+    while ((size = fread(buffer, 1, sizeof(buffer), body)) > 0) {
+        fwrite(buffer, 1, size, out);
+    }
+    fclose(body);
+    fputs("}\n\n", out);
+    return 1;
+}
+
+/* Gerar o programa C completo; retorna 0 se alguma construção não tem tradução */
+int codegen_c_emit(ASTNode* program, FILE* out) {
+    if (!program || !out || program->type != AST_PROGRAM) return 0;
+
+    CodegenC cg;
+    memset(&cg, 0, sizeof(cg));
+    cg.ok = 1;
+    cg.functions = (ASTNode**)MEMORY_ALLOC(g_memory_manager,
+                                           (size_t)(program->child_count + 1) * sizeof(ASTNode*));
+    if (!cg.functions) return 0;
+
+    ASTNode* principal = NULL;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type != AST_FUNCTION_DEF || child->data.function->body_pending) continue;
+        cg.functions[cg.function_count++] = child;
+        if (strcmp(child->data.function->name, "principal") == 0) principal = child;
+    }
+    if (!principal) {
+        memory_free(g_memory_manager, cg.functions);
+        return 0;
+    }
+
+    fprintf(out,
+            "/* Gerado pelo compilador a partir da AST verificada */\n"
+            "#include <stdint.h>\n"
+            "#include <string.h>\n"
+            "#include <math.h>\n"
+            "\n"
+            "#define RT_TEXTO_MAX %d\n"
+            "typedef struct { char s[RT_TEXTO_MAX]; } rt_texto;\n"
+            "\n"
+            "void rt_escreva_inteiro(int64_t valor);\n"
+            "void rt_escreva_decimal(double valor);\n"
+            "void rt_escreva_texto(const char* valor);\n"
+            "void rt_escreva_fim(void);\n"
+            "void rt_leia_inteiro(int64_t* destino);\n"
+            "void rt_leia_decimal(double* destino);\n"
+            "void rt_leia_texto(char* destino, int tamanho);\n"
+            "void rt_erro(const char* mensagem);\n"
+            "\n"
+            "static inline rt_texto rt_texto_de(const char* valor) {\n"
+            "    rt_texto texto;\n"
+            "    size_t i = 0;\n"
+            "    for (; valor[i] && i < RT_TEXTO_MAX - 1; i++) texto.s[i] = valor[i];\n"
+            "    texto.s[i] = '\\0';\n"
+            "    return texto;\n"
+            "}\n"
+            "\n"
+            "static inline void rt_leia_inteiro32(int32_t* destino) {\n"
+            "    int64_t valor = *destino;\n"
+            "    rt_leia_inteiro(&valor);\n"
+            "    *destino = (int32_t)valor;\n"
+            "}\n"
+            "\n"
+            "static inline int32_t rt_soma(int32_t a, int32_t b) {\n"
+            "    return (int32_t)((uint32_t)a + (uint32_t)b);\n"
+            "}\n"
+            "\n"
+            "static inline int32_t rt_subtrai(int32_t a, int32_t b) {\n"
+            "    return (int32_t)((uint32_t)a - (uint32_t)b);\n"
+            "}\n"
+            "\n"
+            "static inline int32_t rt_multiplica(int32_t a, int32_t b) {\n"
+            "    return (int32_t)((uint32_t)a * (uint32_t)b);\n"
+            "}\n"
+            "\n"
+            "static inline int32_t rt_div_inteiro(int32_t a, int32_t b) {\n"
+            "    if (b == 0) rt_erro(\"Divisão por zero\");\n"
+            "    if (b == -1) return rt_subtrai(0, a);\n"
+            "    return a / b;\n"
+            "}\n"
+            "\n"
+            "static inline double rt_div_decimal(double a, double b) {\n"
+            "    if (b == 0.0) rt_erro(\"Divisão por zero\");\n"
+            "    return a / b;\n"
+            "}\n"
+            "\n",
+            g_config.max_string_length);
+
+    for (int i = 0; i < cg.function_count; i++) {
+        emit_signature(out, cg.functions[i]);
+        fputs(";\n", out);
+    }
+    fputc('\n', out);
+
+    for (int i = 0; i < cg.function_count && cg.ok; i++) {
+        if (!emit_function(&cg, cg.functions[i], out)) cg.ok = 0;
+    }
+
+    fputs("int main(void) {\n"
+          "    f_principal();\n"
+          "    return 0;\n"
+          "}\n", out);
+
+    memory_free(g_memory_manager, cg.functions);
+    return cg.ok;
+}
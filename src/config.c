@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L  /* sysconf */
+#include "../include/compiler.h"
+#include <unistd.h>
+
+/* Configuração da execução atual */
+CompilerConfig g_config = {
+    MEMORY_MODE_STATS,
+    MAX_MEMORY_BYTES,
+    MAX_STRING_LENGTH,
+    MAX_TOKEN_LENGTH,
+    MAX_SYMBOL_TABLE_SIZE,
+    DEFAULT_VARIABLE_SLOTS,
+    0,
+    0,
+    DEFAULT_INLINE_MAX_NODES,
+    DEFAULT_MEMO_KB,
+    DEFAULT_JIT_CALLS,
+    DEFAULT_JIT_BACK_EDGES
+};
+
+/* Opção numérica: flag da linha de comando, variável de ambiente e faixa */
+typedef struct {
+    const char* flag;           /* Sem o "=" */
+    const char* env;
+    long min;
+    long max;
+    const char* description;
+} ConfigOption;
+
+enum {
+    OPTION_MEMORY_KB,
+    OPTION_STRING,
+    OPTION_TOKEN,
+    OPTION_SYMBOLS,
+    OPTION_VARIABLES,
+    OPTION_WORKERS,
+    OPTION_LAZY_BODIES,
+    OPTION_INLINE,
+    OPTION_MEMO_KB,
+    OPTION_JIT_CALLS,
+    OPTION_JIT_BACK_EDGES,
+    OPTION_COUNT
+};
+
+static const ConfigOption config_options[OPTION_COUNT] = {
+    {"--memoria-kb", "COMPILADOR_MEMORIA_KB", 16, 4L * 1024 * 1024, "limite de memória em KB"},
+    {"--max-string", "COMPILADOR_MAX_STRING", 2, 1L * 1024 * 1024, "tamanho máximo de strings em execução"},
+    {"--max-token", "COMPILADOR_MAX_TOKEN", 2, MAX_TOKEN_LENGTH, "tamanho máximo de tokens e literais"},
+    {"--tabela-simbolos", "COMPILADOR_TABELA_SIMBOLOS", 1, 1L << 20, "capacidade inicial da tabela de símbolos"},
+    {"--variaveis", "COMPILADOR_VARIAVEIS", 1, 1L << 20, "espaços iniciais de variáveis"},
+    {"--trabalhadores", "COMPILADOR_TRABALHADORES", 0, 256, "threads das fases paralelas, 0 = automático"},
+    {"--corpos-sob-demanda", "COMPILADOR_CORPOS_SOB_DEMANDA", 0, 1, "analisar só corpos alcançados a partir de principal"},
+    {"--expandir-funcoes", "COMPILADOR_EXPANDIR_FUNCOES", 0, 256, "nós máximos de função expandida na chamada, 0 = desligado"},
+    {"--memo-kb", "COMPILADOR_MEMO_KB", 0, 1L * 1024 * 1024, "cache de funções puras recursivas em KB, 0 = desligado"},
+    {"--jit-chamadas", "COMPILADOR_JIT_CHAMADAS", 0, 1L << 30, "chamadas até compilar a função no JIT, 0 = desligado"},
+    {"--jit-lacos", "COMPILADOR_JIT_LACOS", 0, 1L << 30, "voltas de laço até compilar o laço no JIT, 0 = desligado"}
+};
+
+/* Gravar valor já validado no campo correspondente */
+static void config_store(CompilerConfig* config, int option, long value) {
+    switch (option) {
+        case OPTION_MEMORY_KB: config->memory_limit = (size_t)value * 1024; break;
+        case OPTION_STRING: config->max_string_length = (int)value; break;
+        case OPTION_TOKEN: config->max_token_length = (int)value; break;
+        case OPTION_SYMBOLS: config->symbol_table_size = (int)value; break;
+        case OPTION_VARIABLES: config->initial_variable_slots = (int)value; break;
+        case OPTION_WORKERS: config->worker_threads = (int)value; break;
+        case OPTION_LAZY_BODIES: config->lazy_bodies = (int)value; break;
+        case OPTION_INLINE: config->inline_max_nodes = (int)value; break;
+        case OPTION_MEMO_KB: config->memo_kb = (int)value; break;
+        case OPTION_JIT_CALLS: config->jit_calls = (int)value; break;
+        case OPTION_JIT_BACK_EDGES: config->jit_back_edges = (int)value; break;
+        default: break;
+    }
+}
+
+/* Converter e validar valor de uma opção */
+static int config_set(CompilerConfig* config, int option, const char* text, const char* origin) {
+    const ConfigOption* opt = &config_options[option];
+    char* end = NULL;
+    long value = strtol(text, &end, 10);
+
+    if (!*text || *end != '\0' || value < opt->min || value > opt->max) {
+        fprintf(stderr, "Erro: Valor inválido '%s' para %s (%s, entre %ld e %ld)\n",
+                text, origin, opt->description, opt->min, opt->max);
+        return 0;
+    }
+
+    config_store(config, option, value);
+    return 1;
+}
+
+/* Valores padrão (os mesmos limites de compilação de antes) */
+void config_init_defaults(CompilerConfig* config) {
+    if (!config) return;
+
+    config->memory_mode = MEMORY_MODE_STATS;
+    config->memory_limit = MAX_MEMORY_BYTES;
+    config->max_string_length = MAX_STRING_LENGTH;
+    config->max_token_length = MAX_TOKEN_LENGTH;
+    config->symbol_table_size = MAX_SYMBOL_TABLE_SIZE;
+    config->initial_variable_slots = DEFAULT_VARIABLE_SLOTS;
+    config->worker_threads = 0;
+    config->lazy_bodies = 0;
+    config->inline_max_nodes = DEFAULT_INLINE_MAX_NODES;
+    config->memo_kb = DEFAULT_MEMO_KB;
+    config->jit_calls = DEFAULT_JIT_CALLS;
+    config->jit_back_edges = DEFAULT_JIT_BACK_EDGES;
+}
+
+/* Trabalhadores a usar para a quantidade de tarefas dada (no mínimo 1) */
+int config_worker_count(const CompilerConfig* config, int jobs) {
+    int workers = config ? config->worker_threads : 0;
+    if (workers <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (int)online : 1;
+    }
+    if (workers > jobs) workers = jobs;
+    return workers > 0 ? workers : 1;
+}
+
+/* Aplicar variáveis de ambiente; retorna 0 se alguma for inválida */
+int config_load_env(CompilerConfig* config) {
+    if (!config) return 0;
+
+    int ok = 1;
+    config->memory_mode = memory_mode_from_env();
+
+    for (int i = 0; i < OPTION_COUNT; i++) {
+        const char* value = getenv(config_options[i].env);
+        if (value && *value && !config_set(config, i, value, config_options[i].env)) {
+            ok = 0;
+        }
+    }
+
+    return ok;
+}
+
+/* Reconhecer opção da linha de comando.
+ * Retorna 1 se consumida, 0 se não é de configuração e -1 se inválida */
+int config_parse_option(CompilerConfig* config, const char* arg) {
+    if (!config || !arg) return 0;
+
+    if (strncmp(arg, "--modo-memoria=", 15) == 0) {
+        if (!memory_mode_parse(arg + 15, &config->memory_mode)) {
+            fprintf(stderr, "Erro: Modo de memória inválido '%s' (use off, stats ou debug)\n", arg + 15);
+            return -1;
+        }
+        return 1;
+    }
+
+    for (int i = 0; i < OPTION_COUNT; i++) {
+        size_t len = strlen(config_options[i].flag);
+        if (strncmp(arg, config_options[i].flag, len) == 0 && arg[len] == '=') {
+            return config_set(config, i, arg + len + 1, config_options[i].flag) ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+
+/* Imprimir opções de configuração disponíveis */
+void config_print_usage(void) {
+    printf("Opções de configuração (também por variável de ambiente):\n");
+    printf("  --modo-memoria=off|stats|debug  (%s)\n", MEMORY_MODE_ENV);
+    for (int i = 0; i < OPTION_COUNT; i++) {
+        printf("  %s=N  %s (%s)\n", config_options[i].flag,
+               config_options[i].description, config_options[i].env);
+    }
+}
@@ -0,0 +1,398 @@
+#include "../include/compiler.h"
+
+/* Capacidade mínima dos vetores do construtor */
+#define FLAT_AST_MIN_CAPACITY 16
+
+/* Blocos da arena de textos literais e definições de função */
+#define FLAT_AST_PAYLOAD_CHUNK 4096
+
+/* Tamanho do cabeçalho alinhado para os nós que vêm logo depois */
+#define FLAT_AST_HEADER_SIZE ((sizeof(FlatAST) + 7) & ~(size_t)7)
+
+/* Calcular tamanho do bloco único para as capacidades dadas */
+static size_t flat_ast_block_size(uint32_t node_capacity, uint32_t edge_capacity) {
+    return FLAT_AST_HEADER_SIZE +
+           (size_t)node_capacity * sizeof(ASTNode) +
+           (size_t)edge_capacity * sizeof(ASTIndex);
+}
+
+/* Reposicionar ponteiros internos após (re)alocação do bloco */
+static void flat_ast_bind(FlatAST* ast, uint32_t node_capacity) {
+    ast->nodes = (ASTNode*)((char*)ast + FLAT_AST_HEADER_SIZE);
+    ast->edges = (ASTIndex*)(ast->nodes + node_capacity);
+}
+
+/* Redimensionar bloco único preservando nós e arestas */
+static int flat_ast_grow(FlatASTBuilder* builder, uint32_t node_capacity, uint32_t edge_capacity) {
+    FlatAST* ast = builder->ast;
+    size_t edge_bytes = (size_t)ast->edge_count * sizeof(ASTIndex);
+
+    /* Arestas ficam depois dos nós: ao encolher, mover antes de realocar */
+    if (node_capacity < builder->node_capacity && edge_bytes > 0) {
+        memmove(ast->nodes + node_capacity, ast->edges, edge_bytes);
+    }
+
+    FlatAST* resized = (FlatAST*)MEMORY_REALLOC(g_memory_manager, ast,
+                                                flat_ast_block_size(node_capacity, edge_capacity));
+    if (!resized) {
+        if (node_capacity < builder->node_capacity && edge_bytes > 0) {
+            memmove(ast->edges, ast->nodes + node_capacity, edge_bytes);
+        }
+        return 0;
+    }
+
+    /* Ao crescer, as arestas ainda estão na posição antiga */
+    if (node_capacity > builder->node_capacity && edge_bytes > 0) {
+        flat_ast_bind(resized, builder->node_capacity);
+        ASTIndex* old_edges = resized->edges;
+        flat_ast_bind(resized, node_capacity);
+        memmove(resized->edges, old_edges, edge_bytes);
+    }
+    flat_ast_bind(resized, node_capacity);
+
+    builder->ast = resized;
+    builder->node_capacity = node_capacity;
+    builder->edge_capacity = edge_capacity;
+    return 1;
+}
+
+/* Garantir espaço para mais arestas no fim do vetor */
+static int ensure_edge_capacity(FlatASTBuilder* builder, uint32_t needed) {
+    if (needed <= builder->edge_capacity) return 1;
+
+    uint32_t new_capacity = builder->edge_capacity * 2;
+    while (new_capacity < needed) new_capacity *= 2;
+    return flat_ast_grow(builder, builder->node_capacity, new_capacity);
+}
+
+/* Alocar na arena da AST em construção (criada no primeiro uso) */
+static void* flat_ast_payload_alloc(FlatASTBuilder* builder, size_t size) {
+    FlatAST* ast = builder->ast;
+    if (!ast->payload) {
+        ast->payload = memory_arena_create(g_memory_manager, "ast_plana", FLAT_AST_PAYLOAD_CHUNK);
+        if (!ast->payload) return NULL;
+    }
+    return memory_arena_alloc(ast->payload, size);
+}
+
+/* Garantir espaço em uma pilha auxiliar de índices */
+static int ensure_index_capacity(uint32_t** items, uint32_t* capacity, uint32_t needed) {
+    if (needed <= *capacity) return 1;
+
+    uint32_t new_capacity = *capacity == 0 ? FLAT_AST_MIN_CAPACITY : *capacity * 2;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    uint32_t* new_items = (uint32_t*)MEMORY_REALLOC(g_memory_manager, *items,
+                                                    new_capacity * sizeof(uint32_t));
+    if (!new_items) return 0;
+
+    *items = new_items;
+    *capacity = new_capacity;
+    return 1;
+}
+
+/* Garantir espaço na pilha de nós abertos */
+static int ensure_open_capacity(FlatASTBuilder* builder, uint32_t needed) {
+    uint32_t nodes_capacity = builder->open_capacity;
+    if (!ensure_index_capacity(&builder->open_nodes, &nodes_capacity, needed)) return 0;
+    return ensure_index_capacity(&builder->open_bases, &builder->open_capacity, needed);
+}
+
+/* Criar construtor com estimativas de nós e arestas */
+FlatASTBuilder* flat_ast_builder_create(uint32_t node_hint, uint32_t edge_hint) {
+    FlatASTBuilder* builder = (FlatASTBuilder*)MEMORY_ALLOC(g_memory_manager, sizeof(FlatASTBuilder));
+    if (!builder) {
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar construtor da AST plana");
+        return NULL;
+    }
+
+    if (node_hint == 0) node_hint = FLAT_AST_MIN_CAPACITY;
+    if (edge_hint == 0) edge_hint = FLAT_AST_MIN_CAPACITY;
+
+    builder->ast = (FlatAST*)MEMORY_ALLOC(g_memory_manager, flat_ast_block_size(node_hint, edge_hint));
+    if (!builder->ast) {
+        memory_free(g_memory_manager, builder);
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar AST plana");
+        return NULL;
+    }
+
+    flat_ast_bind(builder->ast, node_hint);
+    builder->ast->node_count = 0;
+    builder->ast->edge_count = 0;
+    builder->ast->root = AST_INDEX_NONE;
+    builder->ast->payload = NULL;
+
+    builder->node_capacity = node_hint;
+    builder->edge_capacity = edge_hint;
+    builder->pending = NULL;
+    builder->pending_count = 0;
+    builder->pending_capacity = 0;
+    builder->open_nodes = NULL;
+    builder->open_bases = NULL;
+    builder->open_count = 0;
+    builder->open_capacity = 0;
+    builder->failed = 0;
+
+    return builder;
+}
+
+/* Destruir construtor (e a AST ainda não finalizada) */
+void flat_ast_builder_destroy(FlatASTBuilder* builder) {
+    if (!builder) return;
+
+    if (builder->ast) flat_ast_destroy(builder->ast);
+    if (builder->pending) memory_free(g_memory_manager, builder->pending);
+    if (builder->open_nodes) memory_free(g_memory_manager, builder->open_nodes);
+    if (builder->open_bases) memory_free(g_memory_manager, builder->open_bases);
+
+    memory_free(g_memory_manager, builder);
+}
+
+/* Abrir novo nó; filhos abertos até flat_ast_end_node pertencem a ele */
+ASTIndex flat_ast_begin_node(FlatASTBuilder* builder, ASTNodeType type, NodeToken token) {
+    if (!builder || builder->failed) return AST_INDEX_NONE;
+
+    FlatAST* ast = builder->ast;
+    if (ast->node_count >= builder->node_capacity) {
+        if (!flat_ast_grow(builder, builder->node_capacity * 2, builder->edge_capacity)) {
+            builder->failed = 1;
+            return AST_INDEX_NONE;
+        }
+        ast = builder->ast;
+    }
+
+    if (!ensure_open_capacity(builder, builder->open_count + 1)) {
+        builder->failed = 1;
+        return AST_INDEX_NONE;
+    }
+
+    ASTIndex index = ast->node_count++;
+    ASTNode* node = &ast->nodes[index];
+    memset(node, 0, sizeof(ASTNode));
+    node->type = type;
+    node->token = token;
+    node->data_type = TYPE_VOID;
+    node->first_child = AST_INDEX_NONE;
+
+    builder->open_nodes[builder->open_count] = index;
+    builder->open_bases[builder->open_count] = builder->pending_count;
+    builder->open_count++;
+
+    return index;
+}
+
+/* Abrir cópia de um nó (sem os filhos). Definição de função e texto
+ * literal vão para a arena da AST nova; nomes internados são compartilhados */
+ASTIndex flat_ast_begin_copy(FlatASTBuilder* builder, const ASTNode* source) {
+    ASTIndex index = flat_ast_begin_node(builder, source->type, source->token);
+    if (index == AST_INDEX_NONE) return index;
+
+    ASTNode* node = &builder->ast->nodes[index];
+    node->data_type = source->data_type;
+    node->name_id = source->name_id;
+    node->data = source->data;
+
+    if (source->type == AST_FUNCTION_DEF && source->data.function) {
+        const FunctionInfo* source_info = source->data.function;
+        size_t params_size = (size_t)source_info->param_count * sizeof(FunctionParam);
+        FunctionInfo* info = (FunctionInfo*)flat_ast_payload_alloc(builder, sizeof(FunctionInfo));
+        FunctionParam* params = params_size > 0
+            ? (FunctionParam*)flat_ast_payload_alloc(builder, params_size) : NULL;
+        if (info) {
+            *info = *source_info;
+            info->params = params;
+            if (params) memcpy(params, source_info->params, params_size);
+        }
+        node->data.function = info;
+        if (!info || (params_size > 0 && !params)) builder->failed = 1;
+    } else if (source->type == AST_LITERAL && source->data.literal.string_val) {
+        size_t length = strlen(source->data.literal.string_val) + 1;
+        char* text = (char*)flat_ast_payload_alloc(builder, length);
+        if (text) memcpy(text, source->data.literal.string_val, length);
+        node->data.literal.string_val = text;
+        if (!text) builder->failed = 1;
+    }
+
+    return index;
+}
+
+/* Acessar nó em construção (válido até o próximo flat_ast_begin_node) */
+ASTNode* flat_ast_builder_node(FlatASTBuilder* builder, ASTIndex index) {
+    if (!builder || index >= builder->ast->node_count) return NULL;
+    return &builder->ast->nodes[index];
+}
+
+/* Fechar nó aberto: seus filhos viram uma faixa contígua de arestas */
+void flat_ast_end_node(FlatASTBuilder* builder) {
+    if (!builder || builder->failed || builder->open_count == 0) return;
+
+    builder->open_count--;
+    ASTIndex index = builder->open_nodes[builder->open_count];
+    uint32_t base = builder->open_bases[builder->open_count];
+    uint32_t count = builder->pending_count - base;
+
+    if (!ensure_edge_capacity(builder, builder->ast->edge_count + count)) {
+        builder->failed = 1;
+        return;
+    }
+
+    FlatAST* ast = builder->ast;
+    ASTNode* node = &ast->nodes[index];
+    node->child_count = (int)count;
+    if (count > 0) {
+        node->first_child = ast->edge_count;
+        memcpy(&ast->edges[ast->edge_count], &builder->pending[base], count * sizeof(ASTIndex));
+        ast->edge_count += count;
+    }
+    builder->pending_count = base;
+
+    /* Nó fechado passa a ser filho pendente do nó aberto anterior */
+    if (builder->open_count == 0) {
+        ast->root = index;
+        return;
+    }
+
+    if (!ensure_index_capacity(&builder->pending, &builder->pending_capacity, builder->pending_count + 1)) {
+        builder->failed = 1;
+        return;
+    }
+    builder->pending[builder->pending_count++] = index;
+}
+
+/* Finalizar construção e entregar a AST plana */
+FlatAST* flat_ast_builder_finish(FlatASTBuilder* builder) {
+    if (!builder) return NULL;
+
+    if (builder->failed || builder->open_count > 0 || builder->ast->root == AST_INDEX_NONE) {
+        error_report(ERROR_MEMORY, 0, 0, "Construção da AST plana incompleta");
+        flat_ast_builder_destroy(builder);
+        return NULL;
+    }
+
+    /* Ajustar bloco ao tamanho exato */
+    FlatAST* ast = builder->ast;
+    if (ast->node_count < builder->node_capacity || ast->edge_count < builder->edge_capacity) {
+        uint32_t edge_capacity = ast->edge_count > 0 ? ast->edge_count : 1;
+        if (flat_ast_grow(builder, ast->node_count, edge_capacity)) {
+            ast = builder->ast;
+        }
+    }
+
+    /* Vincular nós ao bloco definitivo */
+    for (uint32_t i = 0; i < ast->node_count; i++) {
+        ast->nodes[i].flat = ast;
+        ast->nodes[i].children = NULL;
+        ast->nodes[i].child_capacity = 0;
+    }
+
+    builder->ast = NULL;
+    flat_ast_builder_destroy(builder);
+
+    return ast;
+}
+
+/* Contar nós e arestas de uma árvore */
+static void count_tree(const ASTNode* node, uint32_t* nodes, uint32_t* edges) {
+    if (!node) return;
+
+    (*nodes)++;
+    *edges += (uint32_t)node->child_count;
+    for (int i = 0; i < node->child_count; i++) {
+        count_tree(ast_get_child(node, i), nodes, edges);
+    }
+}
+
+/* Copiar subárvore para o construtor em pré-ordem */
+static ASTIndex flatten_tree(FlatASTBuilder* builder, const ASTNode* node) {
+    ASTIndex index = flat_ast_begin_copy(builder, node);
+    if (index == AST_INDEX_NONE) return index;
+
+    for (int i = 0; i < node->child_count; i++) {
+        const ASTNode* child = ast_get_child(node, i);
+        if (child) flatten_tree(builder, child);
+    }
+
+    flat_ast_end_node(builder);
+    return index;
+}
+
+/* Copiar subárvore como filha do nó aberto no construtor */
+ASTIndex flat_ast_copy_subtree(FlatASTBuilder* builder, const ASTNode* node) {
+    if (!builder || !node) return AST_INDEX_NONE;
+    return flatten_tree(builder, node);
+}
+
+/* Copiar subárvore como último filho de um nó já fechado (corpo de função
+ * analisado depois da definição). Exige um nó aberto, a raiz; os filhos
+ * do pai passam para uma faixa nova no fim das arestas */
+int flat_ast_attach_subtree(FlatASTBuilder* builder, ASTIndex parent, const ASTNode* node) {
+    if (!builder || !node || builder->failed || builder->open_count == 0 ||
+        parent >= builder->ast->node_count) {
+        return 0;
+    }
+
+    /* A cópia fecha como filha pendente do nó aberto: retirá-la de lá */
+    uint32_t pending = builder->pending_count;
+    ASTIndex index = flatten_tree(builder, node);
+    if (builder->failed || index == AST_INDEX_NONE) return 0;
+    builder->pending_count = pending;
+
+    uint32_t count = (uint32_t)builder->ast->nodes[parent].child_count;
+    if (!ensure_edge_capacity(builder, builder->ast->edge_count + count + 1)) {
+        builder->failed = 1;
+        return 0;
+    }
+
+    FlatAST* ast = builder->ast;
+    ASTNode* target = &ast->nodes[parent];
+    if (count > 0) {
+        memcpy(&ast->edges[ast->edge_count], &ast->edges[target->first_child], count * sizeof(ASTIndex));
+    }
+    ast->edges[ast->edge_count + count] = index;
+    target->first_child = ast->edge_count;
+    target->child_count = (int)count + 1;
+    ast->edge_count += count + 1;
+    return 1;
+}
+
+/* Converter árvore mantendo só os filhos da raiz marcados em keep
+ * (NULL mantém todos) */
+FlatAST* flat_ast_from_tree_filtered(ASTNode* root, const unsigned char* keep) {
+    if (!root) return NULL;
+
+    uint32_t node_count = 1;
+    uint32_t edge_count = 0;
+    for (int i = 0; i < root->child_count; i++) {
+        if (keep && !keep[i]) continue;
+        edge_count++;
+        count_tree(ast_get_child(root, i), &node_count, &edge_count);
+    }
+
+    FlatASTBuilder* builder = flat_ast_builder_create(node_count, edge_count);
+    if (!builder) return NULL;
+
+    ASTIndex index = flat_ast_begin_copy(builder, root);
+    if (index != AST_INDEX_NONE) {
+        for (int i = 0; i < root->child_count; i++) {
+            const ASTNode* child = ast_get_child(root, i);
+            if (child && (!keep || keep[i])) flatten_tree(builder, child);
+        }
+
+        flat_ast_end_node(builder);
+    }
+
+    return flat_ast_builder_finish(builder);
+}
+
+/* Destruir AST plana: o bloco único e a arena dos dados dos nós */
+void flat_ast_destroy(FlatAST* ast) {
+    if (!ast) return;
+    if (ast->payload) memory_arena_destroy(ast->payload);
+    memory_free(g_memory_manager, ast);
+}
+
+/* Nó raiz da AST plana */
+ASTNode* flat_ast_root(const FlatAST* ast) {
+    if (!ast || ast->root == AST_INDEX_NONE) return NULL;
+    return &ast->nodes[ast->root];
+}
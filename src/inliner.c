@@ -0,0 +1,312 @@
+#include "../include/compiler.h"
+
+/* Função expansível: corpo reduzido a uma única expressão em que só os
+ * parâmetros continuam livres. Variáveis locais já foram substituídas
+ * pelas suas inicializações, então nenhum nome do corpo chega ao
+ * chamador e não há captura de variáveis dele. */
+typedef struct {
+    const ASTNode* body;        /* NULL se a função não é expansível */
+    InternId param_ids[MAX_FUNCTION_PARAMS];
+    int has_effect;             /* Corpo ainda contém chamada ou divisão */
+} InlineFunction;
+
+/* Nome ligado a uma subárvore já expandida */
+typedef struct {
+    InternId name_id;
+    const ASTNode* value;
+} InlineBinding;
+
+/* Estado da expansão */
+typedef struct {
+    const CallGraph* graph;
+    InlineFunction* functions;  /* Mesmos índices do grafo */
+    MemoryArena* arena;         /* Corpos expandidos */
+    MemoryArena* scratch;       /* Expansão de um ponto de chamada */
+    int max_nodes;
+    int expanded;
+    int failed;
+} Inliner;
+
+/* Operando sem custo nem efeito: pode ser repetido ou descartado */
+static int is_simple(const ASTNode* node) {
+    return node->type == AST_IDENTIFIER || node->type == AST_LITERAL;
+}
+
+/* Chamada a uma função do programa */
+static int is_user_call(const ASTNode* node) {
+    return node->type == AST_FUNCTION_CALL && node->token.type == TOKEN_FUNCAO_ID;
+}
+
+static int count_nodes(const ASTNode* node) {
+    int count = 1;
+    for (int i = 0; i < node->child_count; i++) {
+        count += count_nodes(ast_get_child(node, i));
+    }
+    return count;
+}
+
+/* Expressão com efeito visível: chamada (pode escrever ou falhar) ou
+ * divisão (pode falhar por zero). Mudar a ordem de duas delas muda o que
+ * o programa imprime */
+static int has_effect(const ASTNode* node) {
+    if (node->type == AST_FUNCTION_CALL) return 1;
+    if (node->type == AST_BINARY_OP && node->data.binary_op.operator == TOKEN_DIV) return 1;
+    for (int i = 0; i < node->child_count; i++) {
+        if (has_effect(ast_get_child(node, i))) return 1;
+    }
+    return 0;
+}
+
+/* Ocorrências de uma variável na expressão */
+static int count_uses(const ASTNode* node, InternId name_id) {
+    int count = node->type == AST_IDENTIFIER && node->name_id == name_id;
+    for (int i = 0; i < node->child_count; i++) {
+        count += count_uses(ast_get_child(node, i), name_id);
+    }
+    return count;
+}
+
+/* Copiar nó sem os filhos */
+static ASTNode* clone_node(Inliner* inl, MemoryArena* arena, const ASTNode* source) {
+    ASTNode* node = ast_create_node_in(arena, source->type);
+    if (!node) {
+        inl->failed = 1;
+        return NULL;
+    }
+    node->token = source->token;
+    node->name_id = source->name_id;
+    node->data_type = source->data_type;
+    node->data = source->data;
+    return node;
+}
+
+/* Copiar expressão trocando variáveis ligadas pelos seus valores. Os valores
+ * são compartilhados, não copiados: as árvores da expansão só são lidas. */
+static const ASTNode* substitute(Inliner* inl, MemoryArena* arena, const ASTNode* node,
+                                 const InlineBinding* bindings, int binding_count) {
+    if (node->type == AST_IDENTIFIER) {
+        for (int i = binding_count - 1; i >= 0; i--) {
+            if (bindings[i].name_id == node->name_id) return bindings[i].value;
+        }
+    }
+
+    ASTNode* copy = clone_node(inl, arena, node);
+    if (!copy) return NULL;
+
+    for (int i = 0; i < node->child_count; i++) {
+        const ASTNode* child = substitute(inl, arena, ast_get_child(node, i), bindings, binding_count);
+        if (!child) return NULL;
+        ast_add_child(copy, (ASTNode*)child);
+    }
+    return copy;
+}
+
+/* Argumentos podem tomar o lugar dos parâmetros sem mudar o resultado:
+ * mesmos tipos (sem conversão implícita), expressões com custo usadas uma
+ * única vez e no máximo uma fonte de efeitos entre corpo e argumentos. O
+ * argumento passa a ser avaliado no ponto de uso, depois do que o corpo
+ * avalia antes dele; com um único efeito a ordem visível não muda */
+static int can_substitute(const InlineFunction* function, const ASTNode* definition,
+                          const ASTNode** args) {
+    int effects = function->has_effect;
+
+    for (int i = 0; i < definition->data.function->param_count; i++) {
+        if (args[i]->data_type != definition->data.function->params[i].type) return 0;
+        if (!is_simple(args[i]) && count_uses(function->body, function->param_ids[i]) != 1) return 0;
+        if (has_effect(args[i]) && ++effects > 1) return 0;
+    }
+    return 1;
+}
+
+static const ASTNode* expand(Inliner* inl, MemoryArena* arena, const ASTNode* node);
+
+/* Expandir chamada: argumentos primeiro, depois o corpo da função chamada */
+static const ASTNode* expand_call(Inliner* inl, MemoryArena* arena, const ASTNode* call) {
+    const ASTNode* args[MAX_FUNCTION_PARAMS];
+    int arg_count = call->child_count < MAX_FUNCTION_PARAMS ? call->child_count : MAX_FUNCTION_PARAMS;
+
+    for (int i = 0; i < arg_count; i++) {
+        args[i] = expand(inl, arena, ast_get_child(call, i));
+        if (!args[i]) return NULL;
+    }
+
+    int index = call_graph_find(inl->graph, call->name_id);
+    const InlineFunction* function = index >= 0 ? &inl->functions[index] : NULL;
+    if (function && function->body) {
+        const ASTNode* definition = inl->graph->nodes[index].function;
+        if (arg_count == definition->data.function->param_count &&
+            can_substitute(function, definition, args)) {
+            InlineBinding bindings[MAX_FUNCTION_PARAMS];
+            for (int i = 0; i < arg_count; i++) {
+                bindings[i].name_id = function->param_ids[i];
+                bindings[i].value = args[i];
+            }
+            inl->expanded++;
+            return substitute(inl, arena, function->body, bindings, arg_count);
+        }
+    }
+
+    ASTNode* copy = clone_node(inl, arena, call);
+    if (!copy) return NULL;
+    for (int i = 0; i < arg_count; i++) {
+        ast_add_child(copy, (ASTNode*)args[i]);
+    }
+    return copy;
+}
+
+/* Copiar expressão expandindo as chamadas possíveis */
+static const ASTNode* expand(Inliner* inl, MemoryArena* arena, const ASTNode* node) {
+    if (is_user_call(node)) return expand_call(inl, arena, node);
+
+    ASTNode* copy = clone_node(inl, arena, node);
+    if (!copy) return NULL;
+
+    for (int i = 0; i < node->child_count; i++) {
+        const ASTNode* child = expand(inl, arena, ast_get_child(node, i));
+        if (!child) return NULL;
+        ast_add_child(copy, (ASTNode*)child);
+    }
+    return copy;
+}
+
+/* Reduzir o corpo de uma função a uma expressão, se ele for só
+ * declarações inicializadas seguidas de um retorno e couber no limite */
+static void inline_prepare(Inliner* inl, int index, InternId main_id) {
+    const CallGraphNode* node = &inl->graph->nodes[index];
+    const ASTNode* definition = node->function;
+    InlineFunction* function = &inl->functions[index];
+
+    /* Recursivas nunca são expandidas: a expansão não terminaria */
+    if (node->recursive || definition->name_id == main_id || definition->child_count == 0) return;
+
+    const ASTNode* block = ast_get_child(definition, 0);
+    if (block->type != AST_BLOCK || block->child_count == 0) return;
+
+    const ASTNode* last = ast_get_child(block, block->child_count - 1);
+    if (last->type != AST_RETURN_STMT || last->child_count == 0) return;
+    if (ast_get_child(last, 0)->data_type != definition->data.function->return_type) return;
+
+    int local_count = block->child_count - 1;
+    const ASTNode** values = NULL;
+    if (local_count > 0) {
+        values = (const ASTNode**)memory_arena_alloc(inl->arena, (size_t)local_count * sizeof(ASTNode*));
+        if (!values) {
+            inl->failed = 1;
+            return;
+        }
+    }
+
+    /* Inicializações e retorno, com chamadas já expandidas */
+    int effects = 0;
+    for (int i = 0; i < local_count; i++) {
+        const ASTNode* decl = ast_get_child(block, i);
+        if (decl->type != AST_VAR_DECL || decl->child_count == 0) return;
+        if (ast_get_child(decl, 0)->data_type != decl->data.var_decl.var_type) return;
+
+        values[i] = expand(inl, inl->arena, ast_get_child(decl, 0));
+        if (!values[i]) return;
+        effects += has_effect(values[i]);
+    }
+
+    const ASTNode* body = expand(inl, inl->arena, ast_get_child(last, 0));
+    if (!body) return;
+    effects += has_effect(body);
+    if (effects > 1) return;
+
+    /* Locais da última para a primeira: o valor inserido pode citar
+     * locais anteriores, substituídos nos passos seguintes */
+    for (int i = local_count - 1; i >= 0; i--) {
+        const ASTNode* decl = ast_get_child(block, i);
+        if (!is_simple(values[i]) && count_uses(body, decl->name_id) != 1) return;
+
+        InlineBinding binding = {decl->name_id, values[i]};
+        body = substitute(inl, inl->arena, body, &binding, 1);
+        if (!body) return;
+    }
+
+    if (count_nodes(body) > inl->max_nodes) return;
+
+    for (int i = 0; i < definition->data.function->param_count; i++) {
+        function->param_ids[i] = definition->data.function->params[i].name_id;
+    }
+    function->has_effect = has_effect(body);
+    function->body = body;
+}
+
+/* Copiar nó para a AST nova; chamadas em posição de expressão são
+ * expandidas (chamadas como comando mantêm a chamada) */
+static void inline_emit(Inliner* inl, FlatASTBuilder* builder, const ASTNode* node, int in_expression) {
+    if (in_expression && is_user_call(node)) {
+        const ASTNode* tree = expand(inl, inl->scratch, node);
+        if (tree) flat_ast_copy_subtree(builder, tree);
+        memory_arena_reset(inl->scratch);
+        return;
+    }
+
+    ASTIndex index = flat_ast_begin_copy(builder, node);
+    if (index == AST_INDEX_NONE) return;
+
+    int child_in_expression = node->type != AST_PROGRAM && node->type != AST_FUNCTION_DEF &&
+                              node->type != AST_BLOCK;
+    for (int i = 0; i < node->child_count && !inl->failed; i++) {
+        inline_emit(inl, builder, ast_get_child(node, i), child_in_expression);
+    }
+
+    flat_ast_end_node(builder);
+}
+
+/* Expandir chamadas a funções pequenas e não recursivas. Retorna a nova AST
+ * plana, ou NULL se nada foi expandido ou se faltou memória (marcado em
+ * out_of_memory); nos dois casos o programa original continua valendo */
+FlatAST* inline_functions(const CallGraph* graph, ASTNode* program, int* expanded, int* out_of_memory) {
+    if (expanded) *expanded = 0;
+    if (out_of_memory) *out_of_memory = 0;
+    if (!graph || !program || graph->node_count == 0 || g_config.inline_max_nodes <= 0) return NULL;
+
+    Inliner inl;
+    memset(&inl, 0, sizeof(Inliner));
+    inl.graph = graph;
+    inl.max_nodes = g_config.inline_max_nodes;
+    inl.functions = (InlineFunction*)MEMORY_ALLOC(g_memory_manager,
+                                                  (size_t)graph->node_count * sizeof(InlineFunction));
+    inl.arena = memory_arena_create(g_memory_manager, "expansao", MEMORY_ARENA_CHUNK_SIZE);
+    inl.scratch = memory_arena_create(g_memory_manager, "expansao_chamada", MEMORY_ARENA_CHUNK_SIZE);
+
+    FlatAST* result = NULL;
+    if (!inl.functions || !inl.arena || !inl.scratch) {
+        inl.failed = 1;
+    } else {
+        memset(inl.functions, 0, (size_t)graph->node_count * sizeof(InlineFunction));
+
+        /* Funções chamadas antes de quem as chama */
+        InternId main_id = intern_lookup("principal");
+        for (int i = 0; i < graph->node_count && !inl.failed; i++) {
+            inline_prepare(&inl, graph->order[i], main_id);
+        }
+
+        /* Contagem da preparação não vale: só pontos de chamada do programa */
+        inl.expanded = 0;
+        uint32_t node_hint = program->flat ? program->flat->node_count : 0;
+        uint32_t edge_hint = program->flat ? program->flat->edge_count : 0;
+        FlatASTBuilder* builder = inl.failed ? NULL : flat_ast_builder_create(node_hint, edge_hint);
+        if (!builder) {
+            inl.failed = 1;
+        } else {
+            inline_emit(&inl, builder, program, 0);
+            if (inl.failed || inl.expanded == 0) {
+                flat_ast_builder_destroy(builder);
+            } else {
+                result = flat_ast_builder_finish(builder);
+                if (!result) inl.failed = 1;
+            }
+        }
+    }
+
+    if (out_of_memory) *out_of_memory = inl.failed;
+    if (expanded && result) *expanded = inl.expanded;
+
+    if (inl.scratch) memory_arena_destroy(inl.scratch);
+    if (inl.arena) memory_arena_destroy(inl.arena);
+    if (inl.functions) memory_free(g_memory_manager, inl.functions);
+    return result;
+}
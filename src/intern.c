@@ -0,0 +1,226 @@
+#include "../include/compiler.h"
+#include <pthread.h>
+
+/* Capacidades da tabela de internação: cada página tem o dobro de
+ * entradas da anterior, então poucas páginas cobrem todos os ids */
+#define INTERN_FIRST_PAGE_BITS 6
+#define INTERN_FIRST_PAGE_SIZE (1 << INTERN_FIRST_PAGE_BITS)
+#define INTERN_MAX_PAGES 24
+#define INTERN_INITIAL_BUCKETS 128
+#define INTERN_ARENA_CHUNK 4096
+
+/* Texto internado: cópia única e hash calculado uma vez */
+typedef struct {
+    const char* text;
+    unsigned int hash;
+    int length;
+} InternEntry;
+
+/* Tabela global: ids são índices + 1 nas páginas; buckets guarda ids.
+ * Páginas são alocadas no primeiro uso e nunca mudam de lugar, então texto
+ * e hash de um id já entregue podem ser lidos sem trava; inserção e busca
+ * por texto usam a trava. */
+typedef struct {
+    pthread_mutex_t lock;
+    MemoryArena* arena;         /* Textos internados */
+    InternEntry* pages[INTERN_MAX_PAGES];
+    int entry_count;
+    InternId* buckets;          /* Endereçamento aberto, potência de 2 */
+    int bucket_count;
+} InternTable;
+
+static InternTable* g_intern_table = NULL;
+static pthread_mutex_t g_intern_create_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Posição de um índice: a página p começa no índice
+ * INTERN_FIRST_PAGE_SIZE * (2^p - 1), logo o bit mais alto de
+ * índice + INTERN_FIRST_PAGE_SIZE identifica a página */
+static int intern_page_of(int index, int* offset) {
+    unsigned int slot = (unsigned int)index + INTERN_FIRST_PAGE_SIZE;
+    int top = 31 - __builtin_clz(slot);
+    *offset = (int)(slot - (1u << top));
+    return top - INTERN_FIRST_PAGE_BITS;
+}
+
+/* Entrada de um id válido */
+static InternEntry* intern_entry(const InternTable* table, InternId id) {
+    int offset;
+    int page = intern_page_of((int)id - 1, &offset);
+    return &table->pages[page][offset];
+}
+
+/* Criar tabela sob demanda no gerenciador global */
+static InternTable* intern_table_get(void) {
+    InternTable* table = __atomic_load_n(&g_intern_table, __ATOMIC_ACQUIRE);
+    if (table) return table;
+
+    pthread_mutex_lock(&g_intern_create_lock);
+    table = g_intern_table;
+    if (table) {
+        pthread_mutex_unlock(&g_intern_create_lock);
+        return table;
+    }
+
+    MemoryArena* arena = memory_arena_create(g_memory_manager, "internacao", INTERN_ARENA_CHUNK);
+    table = arena ? (InternTable*)memory_arena_alloc(arena, sizeof(InternTable)) : NULL;
+    InternId* buckets = table ? (InternId*)MEMORY_ALLOC(g_memory_manager,
+                                    INTERN_INITIAL_BUCKETS * sizeof(InternId)) : NULL;
+    if (!buckets) {
+        if (arena) memory_arena_destroy(arena);
+        pthread_mutex_unlock(&g_intern_create_lock);
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar tabela de internação");
+        return NULL;
+    }
+
+    memset(table, 0, sizeof(InternTable));
+    memset(buckets, 0, INTERN_INITIAL_BUCKETS * sizeof(InternId));
+    pthread_mutex_init(&table->lock, NULL);
+    table->arena = arena;
+    table->entry_count = 0;
+    table->buckets = buckets;
+    table->bucket_count = INTERN_INITIAL_BUCKETS;
+
+    __atomic_store_n(&g_intern_table, table, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_intern_create_lock);
+    return table;
+}
+
+/* Localizar balde do texto: o que contém seu id ou o primeiro vazio */
+static int intern_find_bucket(const InternTable* table, const char* text, int length, unsigned int hash) {
+    int mask = table->bucket_count - 1;
+    int index = (int)(hash & (unsigned int)mask);
+
+    while (table->buckets[index] != INTERN_NONE) {
+        const InternEntry* entry = intern_entry(table, table->buckets[index]);
+        if (entry->hash == hash && entry->length == length && memcmp(entry->text, text, (size_t)length) == 0) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+/* Dobrar vetor de baldes e redistribuir ids */
+static int intern_grow_buckets(InternTable* table) {
+    int bucket_count = table->bucket_count * 2;
+    InternId* buckets = (InternId*)MEMORY_ALLOC(g_memory_manager, (size_t)bucket_count * sizeof(InternId));
+    if (!buckets) return 0;
+    memset(buckets, 0, (size_t)bucket_count * sizeof(InternId));
+
+    int mask = bucket_count - 1;
+    for (int i = 1; i <= table->entry_count; i++) {
+        int index = (int)(intern_entry(table, (InternId)i)->hash & (unsigned int)mask);
+        while (buckets[index] != INTERN_NONE) {
+            index = (index + 1) & mask;
+        }
+        buckets[index] = (InternId)i;
+    }
+
+    memory_free(g_memory_manager, table->buckets);
+    table->buckets = buckets;
+    table->bucket_count = bucket_count;
+    return 1;
+}
+
+/* Acrescentar entrada nova (com a trava); INTERN_NONE se faltar memória */
+static InternId intern_append(InternTable* table, const char* text, int length, unsigned int hash) {
+    int offset;
+    int page = intern_page_of(table->entry_count, &offset);
+
+    if (page >= INTERN_MAX_PAGES) return INTERN_NONE;
+    if (!table->pages[page]) {
+        size_t entries = (size_t)INTERN_FIRST_PAGE_SIZE << page;
+        table->pages[page] = (InternEntry*)memory_arena_alloc(table->arena, entries * sizeof(InternEntry));
+        if (!table->pages[page]) return INTERN_NONE;
+    }
+
+    char* copy = memory_arena_strdup(table->arena, text);
+    if (!copy) return INTERN_NONE;
+
+    InternEntry* entry = &table->pages[page][offset];
+    entry->text = copy;
+    entry->hash = hash;
+    entry->length = length;
+    table->entry_count++;
+
+    return (InternId)table->entry_count;
+}
+
+/* Internar texto: mesmo conteúdo, mesmo id, por toda a execução */
+InternId intern_string(const char* text) {
+    if (!text) return INTERN_NONE;
+
+    InternTable* table = intern_table_get();
+    if (!table) return INTERN_NONE;
+
+    int length = (int)strlen(text);
+    unsigned int hash = symbol_hash(text);
+
+    pthread_mutex_lock(&table->lock);
+
+    int index = intern_find_bucket(table, text, length, hash);
+    InternId id = table->buckets[index];
+    if (id == INTERN_NONE) {
+        /* Manter fator de carga abaixo de 1/2 */
+        if ((table->entry_count + 1) * 2 > table->bucket_count) {
+            if (intern_grow_buckets(table)) {
+                index = intern_find_bucket(table, text, length, hash);
+            } else {
+                index = -1;
+            }
+        }
+
+        id = index >= 0 ? intern_append(table, text, length, hash) : INTERN_NONE;
+        if (id != INTERN_NONE) {
+            table->buckets[index] = id;
+        }
+    }
+
+    pthread_mutex_unlock(&table->lock);
+
+    if (id == INTERN_NONE) {
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao internar texto");
+    }
+    return id;
+}
+
+/* Id de um texto já internado, sem inserir; INTERN_NONE se ausente */
+InternId intern_lookup(const char* text) {
+    InternTable* table = __atomic_load_n(&g_intern_table, __ATOMIC_ACQUIRE);
+    if (!text || !table) return INTERN_NONE;
+
+    int length = (int)strlen(text);
+    unsigned int hash = symbol_hash(text);
+
+    pthread_mutex_lock(&table->lock);
+    InternId id = table->buckets[intern_find_bucket(table, text, length, hash)];
+    pthread_mutex_unlock(&table->lock);
+
+    return id;
+}
+
+/* Texto de um id (estável até intern_table_destroy) */
+const char* intern_text(InternId id) {
+    InternTable* table = __atomic_load_n(&g_intern_table, __ATOMIC_ACQUIRE);
+    if (!table || id == INTERN_NONE) return "";
+    return intern_entry(table, id)->text;
+}
+
+/* Hash pré-calculado de um id */
+unsigned int intern_hash(InternId id) {
+    InternTable* table = __atomic_load_n(&g_intern_table, __ATOMIC_ACQUIRE);
+    if (!table || id == INTERN_NONE) return 0;
+    return intern_entry(table, id)->hash;
+}
+
+/* Liberar tabela global (antes de destruir o gerenciador) */
+void intern_table_destroy(void) {
+    InternTable* table = g_intern_table;
+    if (!table) return;
+
+    g_intern_table = NULL;
+    pthread_mutex_destroy(&table->lock);
+    memory_free(g_memory_manager, table->buckets);
+    memory_arena_destroy(table->arena);
+}
@@ -14,11 +14,48 @@ typedef struct RuntimeValue {
 
 /* Variável em tempo de execução */
 typedef struct RuntimeVariable {
-    char name[MAX_IDENTIFIER_LENGTH];
+    InternId name_id;
     RuntimeValue value;
     int scope_level;
 } RuntimeVariable;
 
+/* Função executável: definição e ids dos parâmetros */
+typedef struct RuntimeFunction {
+    ASTNode* definition;
+    InternId param_ids[MAX_FUNCTION_PARAMS];
+    int memoize;                /* Pura e recursiva: resultados vão para o cache
+                                 * enquanto a função não estiver no JIT */
+    long calls;                 /* Chamadas, para o JIT */
+    long back_edges;            /* Voltas de laço no corpo, para o JIT */
+} RuntimeFunction;
+
+/* Parâmetros máximos de função memorizada (limita o tamanho da entrada) */
+#define MEMO_MAX_ARGS 4
+#define MEMO_MIN_ENTRIES 16
+
+/* Resultado memorizado: função, argumentos já convertidos e retorno */
+typedef struct MemoEntry {
+    int function;               /* Índice em functions; -1 se vazia */
+    unsigned int hash;
+    RuntimeValue args[MEMO_MAX_ARGS];
+    RuntimeValue result;
+} MemoEntry;
+
+/* Cache de mapeamento direto: uma entrada por posição, a nova substitui
+ * a antiga. Começa pequeno e dobra conforme enche, até o teto do orçamento. */
+typedef struct MemoCache {
+    MemoEntry* entries;
+    int capacity;               /* Potência de 2; 0 enquanto não usado */
+    int max_capacity;           /* Teto de entradas dentro do orçamento */
+    int used;
+    size_t bytes;               /* Entradas e textos copiados */
+    size_t budget;
+    long lookups;
+    long hits;
+    long replaced;
+    long rejected;              /* Não guardados por falta de orçamento */
+} MemoCache;
+
 /* Estrutura para contexto de execução */
 typedef struct ExecutionContext {
     SymbolTable* symbol_table;
@@ -26,6 +63,18 @@ typedef struct ExecutionContext {
     RuntimeVariable* variables;
     int variable_count;
     int max_variables;
+    int frame_base;             /* Primeira variável da chamada atual */
+    int call_depth;
+    RuntimeFunction* functions;
+    int function_count;
+    int* function_by_id;        /* Id do nome -> índice em functions */
+    InternId max_function_id;
+    MemoCache memo;
+    JitCompiler* jit;           /* NULL se desligado ou sem suporte */
+    ASTNode** jit_definitions;  /* Definições na ordem de functions */
+    int current_function;       /* Função cujo corpo está executando (-1 fora) */
+    int tail_function;          /* Chamada de cauda pendente (-1 se nenhuma) */
+    RuntimeValue tail_args[MAX_FUNCTION_PARAMS];
     int current_scope;
     int return_flag;
     RuntimeValue return_value;
@@ -38,29 +87,33 @@ typedef struct ExecutionContext {
 /* Protótipos das funções */
 static ExecutionContext* create_execution_context(SymbolTable* st, MemoryManager* mm);
 static void destroy_execution_context(ExecutionContext* ctx);
-static RuntimeVariable* get_variable(ExecutionContext* ctx, const char* name);
-static void set_variable(ExecutionContext* ctx, const char* name, RuntimeValue value);
-static void declare_variable(ExecutionContext* ctx, const char* name, RuntimeValue value);
+static RuntimeVariable* get_variable(ExecutionContext* ctx, InternId name_id);
+static void set_variable(ExecutionContext* ctx, InternId name_id, RuntimeValue value);
+static void declare_variable(ExecutionContext* ctx, InternId name_id, RuntimeValue value);
 static void enter_scope(ExecutionContext* ctx);
 static void exit_scope(ExecutionContext* ctx);
 static RuntimeValue execute_expression(ExecutionContext* ctx, ASTNode* node);
 static void execute_statement(ExecutionContext* ctx, ASTNode* node);
 static void execute_block(ExecutionContext* ctx, ASTNode* node);
-static void execute_function_call(ExecutionContext* ctx, ASTNode* node);
+static RuntimeValue execute_function_call(ExecutionContext* ctx, ASTNode* node);
+static void execute_return_statement(ExecutionContext* ctx, ASTNode* node);
+static void prepare_tail_call(ExecutionContext* ctx, ASTNode* node);
 static void execute_if_statement(ExecutionContext* ctx, ASTNode* node);
 static void execute_for_statement(ExecutionContext* ctx, ASTNode* node);
 static void execute_while_statement(ExecutionContext* ctx, ASTNode* node);
 static void execute_io_statement(ExecutionContext* ctx, ASTNode* node);
 static void execute_assignment(ExecutionContext* ctx, ASTNode* node);
 static RuntimeValue create_runtime_value(DataType type);
+static RuntimeValue convert_runtime_value(RuntimeValue value, DataType type);
 static void copy_runtime_value(RuntimeValue* dest, RuntimeValue* src);
 static void free_runtime_value(RuntimeValue* value);
 static int runtime_value_to_bool(RuntimeValue* value);
 static void runtime_error(ExecutionContext* ctx, const char* message);
+static void memo_destroy(ExecutionContext* ctx);
 
 /* Criar contexto de execução */
 static ExecutionContext* create_execution_context(SymbolTable* st, MemoryManager* mm) {
-    ExecutionContext* ctx = (ExecutionContext*)memory_alloc(mm, sizeof(ExecutionContext));
+    ExecutionContext* ctx = (ExecutionContext*)MEMORY_ALLOC(mm, sizeof(ExecutionContext));
     if (!ctx) {
         return NULL;
     }
@@ -68,7 +121,19 @@ static ExecutionContext* create_execution_context(SymbolTable* st, MemoryManager
     ctx->symbol_table = st;
     ctx->memory_manager = mm;
     ctx->variable_count = 0;
-    ctx->max_variables = 1024;
+    ctx->frame_base = 0;
+    ctx->call_depth = 0;
+    ctx->functions = NULL;
+    ctx->function_count = 0;
+    ctx->function_by_id = NULL;
+    ctx->max_function_id = INTERN_NONE;
+    memset(&ctx->memo, 0, sizeof(MemoCache));
+    ctx->jit = NULL;
+    ctx->jit_definitions = NULL;
+    ctx->current_function = -1;
+    ctx->tail_function = -1;
+    ctx->max_variables = g_config.initial_variable_slots > 0 ? g_config.initial_variable_slots
+                                                             : DEFAULT_VARIABLE_SLOTS;
     ctx->current_scope = 0;
     ctx->return_flag = 0;
     ctx->break_flag = 0;
@@ -76,7 +141,7 @@ static ExecutionContext* create_execution_context(SymbolTable* st, MemoryManager
     ctx->error_flag = 0;
     ctx->error_message[0] = '\0';
     
-    ctx->variables = (RuntimeVariable*)memory_alloc(mm, sizeof(RuntimeVariable) * ctx->max_variables);
+    ctx->variables = (RuntimeVariable*)MEMORY_ALLOC(mm, sizeof(RuntimeVariable) * ctx->max_variables);
     if (!ctx->variables) {
         memory_free(mm, ctx);
         return NULL;
@@ -97,6 +162,11 @@ static void destroy_execution_context(ExecutionContext* ctx) {
     }
     
     memory_free(ctx->memory_manager, ctx->variables);
+    memo_destroy(ctx);
+    jit_destroy(ctx->jit);
+    if (ctx->jit_definitions) memory_free(ctx->memory_manager, ctx->jit_definitions);
+    if (ctx->functions) memory_free(ctx->memory_manager, ctx->functions);
+    if (ctx->function_by_id) memory_free(ctx->memory_manager, ctx->function_by_id);
     free_runtime_value(&ctx->return_value);
     memory_free(ctx->memory_manager, ctx);
 }
@@ -124,6 +194,18 @@ static RuntimeValue create_runtime_value(DataType type) {
     return value;
 }
 
+/* Converter valor numérico para o tipo de destino (inteiro <-> decimal) */
+static RuntimeValue convert_runtime_value(RuntimeValue value, DataType type) {
+    if (value.type == TYPE_INTEIRO && type == TYPE_DECIMAL) {
+        value.value.decimal_val = (double)value.value.int_val;
+        value.type = TYPE_DECIMAL;
+    } else if (value.type == TYPE_DECIMAL && type == TYPE_INTEIRO) {
+        value.value.int_val = (int)value.value.decimal_val;
+        value.type = TYPE_INTEIRO;
+    }
+    return value;
+}
+
 /* Copiar valor de runtime */
 static void copy_runtime_value(RuntimeValue* dest, RuntimeValue* src) {
     if (!dest || !src) return;
@@ -163,19 +245,22 @@ static void free_runtime_value(RuntimeValue* value) {
 }
 
 /* Obter variável */
-static RuntimeVariable* get_variable(ExecutionContext* ctx, const char* name) {
-    for (int i = ctx->variable_count - 1; i >= 0; i--) {
-        if (strcmp(ctx->variables[i].name, name) == 0) {
+static RuntimeVariable* get_variable(ExecutionContext* ctx, InternId name_id) {
+    if (name_id == INTERN_NONE) return NULL;
+    
+    /* Só as variáveis da chamada atual são visíveis */
+    for (int i = ctx->variable_count - 1; i >= ctx->frame_base; i--) {
+        if (ctx->variables[i].name_id == name_id) {
             return &ctx->variables[i];
         }
     }
     return NULL;
 }
 
-static void declare_variable(ExecutionContext* ctx, const char* name, RuntimeValue value) {
+static void declare_variable(ExecutionContext* ctx, InternId name_id, RuntimeValue value) {
     if (ctx->variable_count >= ctx->max_variables) {
         int new_max = ctx->max_variables * 2;
-        RuntimeVariable* new_vars = (RuntimeVariable*)memory_realloc(ctx->memory_manager,
+        RuntimeVariable* new_vars = (RuntimeVariable*)MEMORY_REALLOC(ctx->memory_manager,
                                                                      ctx->variables,
                                                                      sizeof(RuntimeVariable) * new_max);
         if (!new_vars) {
@@ -187,15 +272,14 @@ static void declare_variable(ExecutionContext* ctx, const char* name, RuntimeVal
     }
 
     RuntimeVariable* var = &ctx->variables[ctx->variable_count++];
-    strncpy(var->name, name, MAX_IDENTIFIER_LENGTH - 1);
-    var->name[MAX_IDENTIFIER_LENGTH - 1] = '\0';
+    var->name_id = name_id;
     copy_runtime_value(&var->value, &value);
     var->scope_level = ctx->current_scope;
 }
 
 /* Definir variável */
-static void set_variable(ExecutionContext* ctx, const char* name, RuntimeValue value) {
-    RuntimeVariable* var = get_variable(ctx, name);
+static void set_variable(ExecutionContext* ctx, InternId name_id, RuntimeValue value) {
+    RuntimeVariable* var = get_variable(ctx, name_id);
     if (!var) {
         runtime_error(ctx, "Variável não declarada");
         return;
@@ -275,8 +359,7 @@ static RuntimeValue execute_expression(ExecutionContext* ctx, ASTNode* node) {
             break;
             
         case AST_IDENTIFIER: {
-            const char* var_name = node->data.literal.string_val;
-            RuntimeVariable* var = get_variable(ctx, var_name);
+            RuntimeVariable* var = get_variable(ctx, node->name_id);
 
             if (!var) {
                 runtime_error(ctx, "Variável não declarada");
@@ -288,8 +371,8 @@ static RuntimeValue execute_expression(ExecutionContext* ctx, ASTNode* node) {
         }
         
         case AST_BINARY_OP: {
-            RuntimeValue left = execute_expression(ctx, node->children[0]);
-            RuntimeValue right = execute_expression(ctx, node->children[1]);
+            RuntimeValue left = execute_expression(ctx, ast_get_child(node, 0));
+            RuntimeValue right = execute_expression(ctx, ast_get_child(node, 1));
             
             if (ctx->error_flag) {
                 free_runtime_value(&left);
@@ -334,17 +417,20 @@ static RuntimeValue execute_expression(ExecutionContext* ctx, ASTNode* node) {
                     
                     switch (op) {
                         case TOKEN_MAIS:
-                            result.value.int_val = left.value.int_val + right.value.int_val;
+                            result.value.int_val = (int)((unsigned int)left.value.int_val + (unsigned int)right.value.int_val);
                             break;
                         case TOKEN_MENOS:
-                            result.value.int_val = left.value.int_val - right.value.int_val;
+                            result.value.int_val = (int)((unsigned int)left.value.int_val - (unsigned int)right.value.int_val);
                             break;
                         case TOKEN_MULT:
-                            result.value.int_val = left.value.int_val * right.value.int_val;
+                            result.value.int_val = (int)((unsigned int)left.value.int_val * (unsigned int)right.value.int_val);
                             break;
                         case TOKEN_DIV:
                             if (right.value.int_val == 0) {
                                 runtime_error(ctx, "Divisão por zero");
+                            } else if (right.value.int_val == -1) {
+                                /* -2147483648 / -1 dá a volta, como na soma */
+                                result.value.int_val = (int)(0u - (unsigned int)left.value.int_val);
                             } else {
                                 result.value.int_val = left.value.int_val / right.value.int_val;
                             }
@@ -429,9 +515,7 @@ static RuntimeValue execute_expression(ExecutionContext* ctx, ASTNode* node) {
         }
         
         case AST_FUNCTION_CALL:
-            /* Implementar chamada de função */
-            runtime_error(ctx, "Chamada de função não implementada ainda");
-            break;
+            return execute_function_call(ctx, node);
             
         default:
             runtime_error(ctx, "Tipo de expressão não suportado");
@@ -448,7 +532,7 @@ static void execute_io_statement(ExecutionContext* ctx, ASTNode* node) {
     if (node->token.type == TOKEN_ESCREVA) {
         /* Comando escreva */
         for (int i = 0; i < node->child_count; i++) {
-            RuntimeValue value = execute_expression(ctx, node->children[i]);
+            RuntimeValue value = execute_expression(ctx, ast_get_child(node, i));
             
             if (ctx->error_flag) {
                 free_runtime_value(&value);
@@ -479,9 +563,8 @@ static void execute_io_statement(ExecutionContext* ctx, ASTNode* node) {
     } else if (node->token.type == TOKEN_LEIA) {
         /* Comando leia */
         for (int i = 0; i < node->child_count; i++) {
-            if (node->children[i]->type == AST_IDENTIFIER) {
-                const char* var_name = node->children[i]->data.literal.string_val;
-                RuntimeVariable* var = get_variable(ctx, var_name);
+            if (ast_get_child(node, i)->type == AST_IDENTIFIER) {
+                RuntimeVariable* var = get_variable(ctx, ast_get_child(node, i)->name_id);
 
                 if (!var) {
                     runtime_error(ctx, "Variável não declarada");
@@ -500,9 +583,16 @@ static void execute_io_statement(ExecutionContext* ctx, ASTNode* node) {
                         break;
                     case TYPE_TEXTO:
                         if (!var->value.value.string_val) {
-                            var->value.value.string_val = memory_alloc(ctx->memory_manager, MAX_STRING_LENGTH);
+                            var->value.value.string_val = MEMORY_ALLOC(ctx->memory_manager,
+                                                                       g_config.max_string_length);
+                            /* Leitura sem entrada não toca o buffer */
+                            if (var->value.value.string_val) var->value.value.string_val[0] = '\0';
+                        }
+                        if (var->value.value.string_val) {
+                            char format[32];
+                            snprintf(format, sizeof(format), "%%%ds", g_config.max_string_length - 1);
+                            scanf(format, var->value.value.string_val);
                         }
-                        scanf("%s", var->value.value.string_val);
                         break;
                     default:
                         break;
@@ -518,20 +608,19 @@ static void execute_io_statement(ExecutionContext* ctx, ASTNode* node) {
 static void execute_assignment(ExecutionContext* ctx, ASTNode* node) {
     if (!node || ctx->error_flag || node->child_count < 2) return;
     
-    if (node->children[0]->type != AST_IDENTIFIER) {
+    if (ast_get_child(node, 0)->type != AST_IDENTIFIER) {
         runtime_error(ctx, "Lado esquerdo da atribuição deve ser uma variável");
         return;
     }
     
-    const char* var_name = node->children[0]->data.literal.string_val;
-    RuntimeVariable* var = get_variable(ctx, var_name);
+    RuntimeVariable* var = get_variable(ctx, ast_get_child(node, 0)->name_id);
 
     if (!var) {
         runtime_error(ctx, "Variável não declarada");
         return;
     }
     
-    RuntimeValue value = execute_expression(ctx, node->children[1]);
+    RuntimeValue value = execute_expression(ctx, ast_get_child(node, 1));
     
     if (ctx->error_flag) {
         free_runtime_value(&value);
@@ -557,10 +646,14 @@ static void execute_assignment(ExecutionContext* ctx, ASTNode* node) {
         case TYPE_TEXTO:
             if (value.type == TYPE_TEXTO && value.value.string_val) {
                 if (!var->value.value.string_val) {
-                    var->value.value.string_val = memory_alloc(ctx->memory_manager, MAX_STRING_LENGTH);
+                    var->value.value.string_val = MEMORY_ALLOC(ctx->memory_manager,
+                                                               g_config.max_string_length);
+                }
+                if (var->value.value.string_val) {
+                    strncpy(var->value.value.string_val, value.value.string_val,
+                            g_config.max_string_length - 1);
+                    var->value.value.string_val[g_config.max_string_length - 1] = '\0';
                 }
-                strncpy(var->value.value.string_val, value.value.string_val, MAX_STRING_LENGTH - 1);
-                var->value.value.string_val[MAX_STRING_LENGTH - 1] = '\0';
             }
             break;
         default:
@@ -579,9 +672,11 @@ static void execute_statement(ExecutionContext* ctx, ASTNode* node) {
         case AST_VAR_DECL: {
             RuntimeValue init_val = create_runtime_value(node->data.var_decl.var_type);
             if (node->child_count > 0) {
-                init_val = execute_expression(ctx, node->children[0]);
+                /* Valor inicial no tipo declarado, como na atribuição */
+                init_val = convert_runtime_value(execute_expression(ctx, ast_get_child(node, 0)),
+                                                 node->data.var_decl.var_type);
             }
-            declare_variable(ctx, node->token.value, init_val);
+            declare_variable(ctx, node->name_id, init_val);
             free_runtime_value(&init_val);
             break;
         }
@@ -591,7 +686,29 @@ static void execute_statement(ExecutionContext* ctx, ASTNode* node) {
             break;
 
         case AST_FUNCTION_CALL:
-            execute_io_statement(ctx, node);
+            if (node->token.type == TOKEN_FUNCAO_ID) {
+                /* Chamada como comando: valor de retorno descartado */
+                RuntimeValue value = execute_function_call(ctx, node);
+                free_runtime_value(&value);
+            } else {
+                execute_io_statement(ctx, node);
+            }
+            break;
+
+        case AST_IF_STMT:
+            execute_if_statement(ctx, node);
+            break;
+
+        case AST_FOR_STMT:
+            execute_for_statement(ctx, node);
+            break;
+
+        case AST_WHILE_STMT:
+            execute_while_statement(ctx, node);
+            break;
+
+        case AST_RETURN_STMT:
+            execute_return_statement(ctx, node);
             break;
 
         case AST_BLOCK:
@@ -601,7 +718,7 @@ static void execute_statement(ExecutionContext* ctx, ASTNode* node) {
         default:
             /* Para outros tipos de comando */
             for (int i = 0; i < node->child_count; i++) {
-                execute_statement(ctx, node->children[i]);
+                execute_statement(ctx, ast_get_child(node, i));
                 if (ctx->error_flag) break;
             }
             break;
@@ -614,15 +731,601 @@ static void execute_block(ExecutionContext* ctx, ASTNode* node) {
 
     enter_scope(ctx);
     for (int i = 0; i < node->child_count; i++) {
-        execute_statement(ctx, node->children[i]);
+        execute_statement(ctx, ast_get_child(node, i));
         if (ctx->error_flag || ctx->return_flag) break;
     }
     exit_scope(ctx);
 }
 
+/* Executar condicional */
+static void execute_if_statement(ExecutionContext* ctx, ASTNode* node) {
+    if (node->child_count < 2) return;
+    
+    RuntimeValue condition = execute_expression(ctx, ast_get_child(node, 0));
+    int taken = runtime_value_to_bool(&condition);
+    free_runtime_value(&condition);
+    if (ctx->error_flag) return;
+    
+    if (taken) {
+        execute_block(ctx, ast_get_child(node, 1));
+    } else if (node->child_count > 2) {
+        execute_block(ctx, ast_get_child(node, 2));
+    }
+}
+
+/* Avaliar condição de laço */
+static int loop_condition(ExecutionContext* ctx, ASTNode* condition) {
+    RuntimeValue value = execute_expression(ctx, condition);
+    int result = runtime_value_to_bool(&value);
+    free_runtime_value(&value);
+    return result && !ctx->error_flag;
+}
+
+/* Volta de laço: conta no corpo da função atual e, com a função quente,
+ * tenta continuar o laço no código nativo a partir da condição. Retorna 1
+ * se o laço terminou lá (com as variáveis externas já atualizadas) */
+static int run_native_loop(ExecutionContext* ctx, ASTNode* node) {
+    if (!ctx->jit || ctx->current_function < 0 || g_config.jit_back_edges <= 0 ||
+        ++ctx->functions[ctx->current_function].back_edges < g_config.jit_back_edges) {
+        return 0;
+    }
+    
+    const JitLoop* loop = jit_compile_loop(ctx->jit, ctx->current_function, node);
+    if (!loop) return 0;
+    
+    /* Variáveis externas precisam ser inteiros já inicializados; os
+     * ponteiros continuam válidos, o código nativo não declara nada aqui */
+    const InternId* ids;
+    int count = jit_loop_inputs(loop, &ids);
+    RuntimeVariable* vars[JIT_MAX_LOOP_VARS];
+    int32_t values[JIT_MAX_LOOP_VARS];
+    for (int i = 0; i < count; i++) {
+        vars[i] = get_variable(ctx, ids[i]);
+        if (!vars[i] || vars[i]->value.type != TYPE_INTEIRO || !vars[i]->value.is_initialized) return 0;
+        values[i] = vars[i]->value.value.int_val;
+    }
+    
+    JitState state = {JIT_ERROR_NONE, ctx->call_depth, 0};
+    int32_t returned;
+    int ok = jit_run_loop(ctx->jit, loop, values, &state, &returned);
+    for (int i = 0; i < count; i++) vars[i]->value.value.int_val = values[i];
+    
+    if (!ok) {
+        runtime_error(ctx, jit_error_message(state.error));
+    } else if (state.returned) {
+        free_runtime_value(&ctx->return_value);
+        ctx->return_value = create_runtime_value(TYPE_INTEIRO);
+        ctx->return_value.value.int_val = returned;
+        ctx->return_value.is_initialized = 1;
+        ctx->return_flag = 1;
+    }
+    return 1;
+}
+
+/* Executar laço para: inicialização, condição, incremento e corpo */
+static void execute_for_statement(ExecutionContext* ctx, ASTNode* node) {
+    if (node->child_count < 4) return;
+    
+    execute_assignment(ctx, ast_get_child(node, 0));
+    while (!ctx->error_flag && loop_condition(ctx, ast_get_child(node, 1))) {
+        execute_block(ctx, ast_get_child(node, 3));
+        if (ctx->error_flag || ctx->return_flag) break;
+        execute_assignment(ctx, ast_get_child(node, 2));
+        if (run_native_loop(ctx, node)) break;
+    }
+}
+
+/* Executar laço enquanto */
+static void execute_while_statement(ExecutionContext* ctx, ASTNode* node) {
+    if (node->child_count < 2) return;
+    
+    while (loop_condition(ctx, ast_get_child(node, 0))) {
+        execute_block(ctx, ast_get_child(node, 1));
+        if (ctx->error_flag || ctx->return_flag) break;
+        if (run_native_loop(ctx, node)) break;
+    }
+}
+
+/* Executar retorno: guarda o valor e interrompe a função */
+static void execute_return_statement(ExecutionContext* ctx, ASTNode* node) {
+    /* Chamada de cauda marcada na análise semântica; a expansão de funções
+     * pode ter trocado a chamada por uma expressão, então o nó é conferido */
+    ASTNode* value_node = node->child_count > 0 ? ast_get_child(node, 0) : NULL;
+    if (value_node && node->data.return_stmt.tail_call && ctx->call_depth > 0 &&
+        value_node->type == AST_FUNCTION_CALL && value_node->token.type == TOKEN_FUNCAO_ID) {
+        prepare_tail_call(ctx, value_node);
+        return;
+    }
+    
+    RuntimeValue value = create_runtime_value(TYPE_VOID);
+    if (node->child_count > 0) {
+        value = execute_expression(ctx, ast_get_child(node, 0));
+        if (ctx->error_flag) {
+            free_runtime_value(&value);
+            return;
+        }
+    }
+    
+    free_runtime_value(&ctx->return_value);
+    ctx->return_value = value;
+    ctx->return_flag = 1;
+}
+
+/* Bytes de texto copiados para um valor guardado no cache */
+static size_t memo_value_bytes(const RuntimeValue* value) {
+    if (value->type != TYPE_TEXTO || !value->value.string_val) return 0;
+    return strlen(value->value.string_val) + 1;
+}
+
+/* Hash da função e dos argumentos; decimais pelos bits exatos (0.0 e -0.0
+ * são impressos de forma diferente, então não podem compartilhar entrada) */
+static unsigned int memo_hash(int function, const RuntimeValue* args, int count) {
+    unsigned int hash = 2166136261u ^ (unsigned int)function;
+
+    for (int i = 0; i < count; i++) {
+        const unsigned char* bytes = NULL;
+        size_t length = 0;
+        switch (args[i].type) {
+            case TYPE_INTEIRO:
+                bytes = (const unsigned char*)&args[i].value.int_val;
+                length = sizeof(int);
+                break;
+            case TYPE_DECIMAL:
+                bytes = (const unsigned char*)&args[i].value.decimal_val;
+                length = sizeof(double);
+                break;
+            case TYPE_TEXTO:
+                bytes = (const unsigned char*)args[i].value.string_val;
+                length = bytes ? strlen(args[i].value.string_val) : 0;
+                break;
+            default:
+                break;
+        }
+
+        hash = (hash ^ (unsigned int)args[i].type) * 16777619u;
+        for (size_t b = 0; b < length; b++) {
+            hash = (hash ^ bytes[b]) * 16777619u;
+        }
+    }
+
+    return hash;
+}
+
+/* Mesmo valor de argumento, com a mesma exatidão do hash */
+static int memo_same_value(const RuntimeValue* a, const RuntimeValue* b) {
+    if (a->type != b->type || a->is_initialized != b->is_initialized) return 0;
+
+    switch (a->type) {
+        case TYPE_INTEIRO:
+            return a->value.int_val == b->value.int_val;
+        case TYPE_DECIMAL:
+            return memcmp(&a->value.decimal_val, &b->value.decimal_val, sizeof(double)) == 0;
+        case TYPE_TEXTO:
+            if (!a->value.string_val || !b->value.string_val) {
+                return a->value.string_val == b->value.string_val;
+            }
+            return strcmp(a->value.string_val, b->value.string_val) == 0;
+        default:
+            return 1;
+    }
+}
+
+/* Preparar cache no primeiro uso. O orçamento configurado é limitado a um
+ * quarto da memória ainda livre sob o limite; as entradas ocupam no máximo
+ * metade dele e o resto fica para textos copiados. Só MEMO_MIN_ENTRIES são
+ * alocadas agora; memo_grow dobra a tabela até o teto. Retorna 0 se desligado. */
+static int memo_ready(ExecutionContext* ctx) {
+    MemoCache* memo = &ctx->memo;
+    if (memo->capacity != 0) return memo->capacity > 0;
+
+    MemoryManager* mm = ctx->memory_manager;
+    size_t budget = (size_t)g_config.memo_kb * 1024;
+    size_t available = mm->limit > mm->allocated ? mm->limit - mm->allocated : 0;
+    if (budget > available / 4) budget = available / 4;
+
+    if ((size_t)MEMO_MIN_ENTRIES * sizeof(MemoEntry) > budget / 2) {
+        memo->capacity = -1;
+        return 0;
+    }
+
+    int max_capacity = MEMO_MIN_ENTRIES;
+    while ((size_t)max_capacity * 2 * sizeof(MemoEntry) <= budget / 2) max_capacity *= 2;
+
+    memo->entries = (MemoEntry*)MEMORY_ALLOC(mm, (size_t)MEMO_MIN_ENTRIES * sizeof(MemoEntry));
+    if (!memo->entries) {
+        memo->capacity = -1;
+        return 0;
+    }
+
+    for (int i = 0; i < MEMO_MIN_ENTRIES; i++) {
+        memo->entries[i].function = -1;
+    }
+    memo->capacity = MEMO_MIN_ENTRIES;
+    memo->max_capacity = max_capacity;
+    memo->bytes = (size_t)MEMO_MIN_ENTRIES * sizeof(MemoEntry);
+    memo->budget = budget;
+    return 1;
+}
+
+/* Dobrar a tabela quando metade estiver ocupada. Com mapeamento direto, a
+ * entrada da posição i vai para i ou i + capacidade antiga, sem colisões.
+ * Se faltar orçamento ou memória, segue com o tamanho atual. */
+static void memo_grow(ExecutionContext* ctx) {
+    MemoCache* memo = &ctx->memo;
+    if (memo->capacity >= memo->max_capacity || memo->used * 2 < memo->capacity) return;
+
+    int old_capacity = memo->capacity;
+    size_t added = (size_t)old_capacity * sizeof(MemoEntry);
+    if (memo->bytes + added > memo->budget) return;
+
+    /* Crescer é opcional: perto do limite, nem tenta (falhar reportaria erro) */
+    MemoryManager* mm = ctx->memory_manager;
+    size_t available = mm->limit > mm->allocated ? mm->limit - mm->allocated : 0;
+    if (added > available / 2) return;
+
+    MemoEntry* entries = (MemoEntry*)MEMORY_REALLOC(mm, memo->entries, added * 2);
+    if (!entries) return;
+
+    for (int i = 0; i < old_capacity; i++) {
+        entries[old_capacity + i].function = -1;
+        if (entries[i].function >= 0 && (entries[i].hash & (unsigned int)old_capacity)) {
+            entries[old_capacity + i] = entries[i];
+            entries[i].function = -1;
+        }
+    }
+    memo->entries = entries;
+    memo->capacity = old_capacity * 2;
+    memo->bytes += added;
+}
+
+/* Procurar resultado memorizado; em caso de acerto, copia para result */
+static int memo_lookup(ExecutionContext* ctx, int function, const RuntimeValue* args, int count,
+                       unsigned int hash, RuntimeValue* result) {
+    MemoCache* memo = &ctx->memo;
+    MemoEntry* entry = &memo->entries[hash & (unsigned int)(memo->capacity - 1)];
+
+    memo->lookups++;
+    if (entry->function != function || entry->hash != hash) return 0;
+    for (int i = 0; i < count; i++) {
+        if (!memo_same_value(&entry->args[i], &args[i])) return 0;
+    }
+
+    copy_runtime_value(result, &entry->result);
+    memo->hits++;
+    return 1;
+}
+
+/* Liberar valores de uma entrada ocupada */
+static void memo_clear_entry(MemoCache* memo, MemoEntry* entry, int count) {
+    for (int i = 0; i < count; i++) {
+        memo->bytes -= memo_value_bytes(&entry->args[i]);
+        free_runtime_value(&entry->args[i]);
+    }
+    memo->bytes -= memo_value_bytes(&entry->result);
+    free_runtime_value(&entry->result);
+    entry->function = -1;
+}
+
+/* Guardar resultado, substituindo a entrada da mesma posição; recusa se
+ * os textos copiados não couberem no orçamento */
+static void memo_store(ExecutionContext* ctx, int function, const RuntimeValue* args, int count,
+                       unsigned int hash, RuntimeValue* result) {
+    MemoCache* memo = &ctx->memo;
+    memo_grow(ctx);
+    MemoEntry* entry = &memo->entries[hash & (unsigned int)(memo->capacity - 1)];
+
+    size_t needed = memo_value_bytes(result);
+    for (int i = 0; i < count; i++) needed += memo_value_bytes(&args[i]);
+
+    size_t released = 0;
+    int old_count = 0;
+    if (entry->function >= 0) {
+        old_count = ctx->functions[entry->function].definition->data.function->param_count;
+        released = memo_value_bytes(&entry->result);
+        for (int i = 0; i < old_count; i++) released += memo_value_bytes(&entry->args[i]);
+    }
+
+    if (memo->bytes - released + needed > memo->budget) {
+        memo->rejected++;
+        return;
+    }
+
+    if (entry->function >= 0) {
+        memo_clear_entry(memo, entry, old_count);
+        memo->replaced++;
+    } else {
+        memo->used++;
+    }
+
+    for (int i = 0; i < count; i++) {
+        copy_runtime_value(&entry->args[i], (RuntimeValue*)&args[i]);
+        memo->bytes += memo_value_bytes(&entry->args[i]);
+    }
+    copy_runtime_value(&entry->result, result);
+    memo->bytes += memo_value_bytes(&entry->result);
+    entry->function = function;
+    entry->hash = hash;
+}
+
+/* Liberar cache */
+static void memo_destroy(ExecutionContext* ctx) {
+    MemoCache* memo = &ctx->memo;
+    if (!memo->entries) return;
+
+    for (int i = 0; i < memo->capacity; i++) {
+        MemoEntry* entry = &memo->entries[i];
+        if (entry->function >= 0) {
+            memo_clear_entry(memo, entry, ctx->functions[entry->function].definition->data.function->param_count);
+        }
+    }
+    memory_free(ctx->memory_manager, memo->entries);
+    memo->entries = NULL;
+}
+
+/* Estatísticas do cache de funções puras */
+static void memo_report(const ExecutionContext* ctx) {
+    const MemoCache* memo = &ctx->memo;
+    if (memo->lookups == 0) return;
+
+    printf("=== CACHE DE FUNÇÕES PURAS ===\n");
+    printf("Consultas: %ld (acertos: %ld, %.1f%%; faltas: %ld)\n", memo->lookups, memo->hits,
+           100.0 * (double)memo->hits / (double)memo->lookups, memo->lookups - memo->hits);
+    printf("Entradas: %d de %d (substituídas: %ld, recusadas: %ld)\n",
+           memo->used, memo->capacity, memo->replaced, memo->rejected);
+    printf("Memória: %zu de %zu bytes\n", memo->bytes, memo->budget);
+    printf("==============================\n");
+}
+
+/* Função chamada pelo nó, conferindo o número de argumentos; -1 em erro */
+static int resolve_call(ExecutionContext* ctx, ASTNode* node) {
+    int index = (node->name_id != INTERN_NONE && node->name_id <= ctx->max_function_id)
+              ? ctx->function_by_id[node->name_id] : -1;
+    if (index < 0) {
+        runtime_error(ctx, "Função não declarada");
+        return -1;
+    }
+    
+    if (node->child_count != ctx->functions[index].definition->data.function->param_count) {
+        runtime_error(ctx, "Número incorreto de argumentos");
+        return -1;
+    }
+    return index;
+}
+
+/* Avaliar argumentos no quadro atual, já convertidos para os tipos dos
+ * parâmetros; em erro, nada fica alocado */
+static int evaluate_arguments(ExecutionContext* ctx, ASTNode* node, int index, RuntimeValue* args) {
+    const ASTNode* definition = ctx->functions[index].definition;
+    
+    for (int i = 0; i < node->child_count; i++) {
+        args[i] = execute_expression(ctx, ast_get_child(node, i));
+        if (ctx->error_flag) {
+            for (int j = 0; j <= i; j++) free_runtime_value(&args[j]);
+            return 0;
+        }
+        args[i] = convert_runtime_value(args[i], definition->data.function->params[i].type);
+    }
+    return 1;
+}
+
+/* Liberar argumentos avaliados */
+static void free_arguments(RuntimeValue* args, int count) {
+    for (int i = 0; i < count; i++) free_runtime_value(&args[i]);
+}
+
+/* Função quente no código nativo: compilada ao atingir o limite de
+ * chamadas. Retorna 0 para seguir no interpretador (JIT recusou a função
+ * ou argumento não inicializado) */
+static int run_native_function(ExecutionContext* ctx, int index, const RuntimeValue* args, RuntimeValue* result) {
+    RuntimeFunction* function = &ctx->functions[index];
+    if (!ctx->jit) return 0;
+    if (!jit_function_ready(ctx->jit, index)) {
+        if (g_config.jit_calls <= 0 || ++function->calls < g_config.jit_calls ||
+            !jit_compile_function(ctx->jit, index)) {
+            return 0;
+        }
+    }
+    
+    int32_t values[MAX_FUNCTION_PARAMS];
+    int count = function->definition->data.function->param_count;
+    for (int i = 0; i < count; i++) {
+        if (args[i].type != TYPE_INTEIRO || !args[i].is_initialized) return 0;
+        values[i] = args[i].value.int_val;
+    }
+    
+    JitState state = {JIT_ERROR_NONE, ctx->call_depth, 0};
+    int32_t value;
+    if (!jit_call(ctx->jit, index, values, &state, &value)) {
+        runtime_error(ctx, jit_error_message(state.error));
+        *result = create_runtime_value(TYPE_VOID);
+        return 1;
+    }
+    *result = create_runtime_value(TYPE_INTEIRO);
+    result->value.int_val = value;
+    result->is_initialized = 1;
+    return 1;
+}
+
+/* Executar função com argumentos já avaliados, em um quadro novo que só
+ * enxerga as próprias variáveis. Uma chamada de cauda deixada pelo corpo
+ * é executada aqui mesmo, no lugar do quadro que terminou: recursão de
+ * cauda, direta ou mútua, não aumenta a pilha de C nem a profundidade. */
+static RuntimeValue invoke_function(ExecutionContext* ctx, int index, RuntimeValue* args) {
+    RuntimeValue result = create_runtime_value(TYPE_VOID);
+    const int first_index = index;
+    const int first_count = ctx->functions[index].definition->data.function->param_count;
+    
+    /* Função pura: mesmos argumentos, mesmo resultado. Só a primeira
+     * chamada usa o cache; consultar a cada passo de uma cadeia de cauda
+     * custa mais do que os acertos raros economizam. Compilada no JIT, a
+     * função não passa mais pelo cache: o código nativo é mais rápido que
+     * a consulta e as chamadas recursivas dele nem voltam ao interpretador. */
+    unsigned int hash = 0;
+    int memoize = ctx->functions[index].memoize &&
+                  !(ctx->jit && jit_function_ready(ctx->jit, index)) && memo_ready(ctx);
+    if (memoize) {
+        hash = memo_hash(index, args, first_count);
+        if (memo_lookup(ctx, index, args, first_count, hash, &result)) {
+            free_arguments(args, first_count);
+            return result;
+        }
+    }
+    
+    RuntimeValue tail_args[MAX_FUNCTION_PARAMS];
+    RuntimeValue* call_args = args;
+    int saved_base = ctx->frame_base;
+    int saved_function = ctx->current_function;
+    ctx->call_depth++;
+    
+    for (;;) {
+        const RuntimeFunction* function = &ctx->functions[index];
+        ASTNode* definition = function->definition;
+        int param_count = definition->data.function->param_count;
+        
+        RuntimeValue native;
+        if (run_native_function(ctx, index, call_args, &native)) {
+            free_runtime_value(&result);
+            result = native;
+            if (call_args == tail_args) free_arguments(tail_args, param_count);
+            break;
+        }
+        
+        ctx->current_function = index;
+        ctx->frame_base = ctx->variable_count;
+        enter_scope(ctx);
+        for (int i = 0; i < param_count; i++) {
+            declare_variable(ctx, function->param_ids[i], call_args[i]);
+        }
+        if (call_args == tail_args) free_arguments(tail_args, param_count);
+        
+        if (!ctx->error_flag && definition->child_count > 0) {
+            execute_block(ctx, ast_get_child(definition, 0));
+        }
+        
+        /* Valor de retorno passa para o chamador */
+        free_runtime_value(&result);
+        result = convert_runtime_value(ctx->return_value, definition->data.function->return_type);
+        ctx->return_value = create_runtime_value(TYPE_VOID);
+        ctx->return_flag = 0;
+        exit_scope(ctx);
+        
+        if (ctx->tail_function < 0) break;
+        
+        /* Chamada de cauda: argumentos já avaliados no quadro que terminou */
+        index = ctx->tail_function;
+        ctx->tail_function = -1;
+        int tail_count = ctx->functions[index].definition->data.function->param_count;
+        memcpy(tail_args, ctx->tail_args, (size_t)tail_count * sizeof(RuntimeValue));
+        call_args = tail_args;
+        
+        if (ctx->error_flag) {
+            free_arguments(tail_args, tail_count);
+            break;
+        }
+    }
+    
+    ctx->call_depth--;
+    ctx->frame_base = saved_base;
+    ctx->current_function = saved_function;
+    
+    if (memoize && !ctx->error_flag) {
+        memo_store(ctx, first_index, args, first_count, hash, &result);
+    }
+    free_arguments(args, first_count);
+    
+    return result;
+}
+
+/* Executar chamada: argumentos avaliados no chamador */
+static RuntimeValue execute_function_call(ExecutionContext* ctx, ASTNode* node) {
+    RuntimeValue result = create_runtime_value(TYPE_VOID);
+    
+    int index = resolve_call(ctx, node);
+    if (index < 0) return result;
+    
+    if (ctx->call_depth >= MAX_CALL_DEPTH) {
+        runtime_error(ctx, "Profundidade máxima de chamadas excedida");
+        return result;
+    }
+    
+    RuntimeValue args[MAX_FUNCTION_PARAMS];
+    if (!evaluate_arguments(ctx, node, index, args)) return result;
+    
+    return invoke_function(ctx, index, args);
+}
+
+/* Preparar chamada de cauda: argumentos avaliados ainda neste quadro; a
+ * chamada é feita por invoke_function depois que o corpo atual termina */
+static void prepare_tail_call(ExecutionContext* ctx, ASTNode* node) {
+    int index = resolve_call(ctx, node);
+    if (index < 0) return;
+    
+    RuntimeValue args[MAX_FUNCTION_PARAMS];
+    if (!evaluate_arguments(ctx, node, index, args)) return;
+    
+    memcpy(ctx->tail_args, args, (size_t)node->child_count * sizeof(RuntimeValue));
+    ctx->tail_function = index;
+    ctx->return_flag = 1;
+}
+
+/* Montar tabela de funções do programa, indexada pelo id do nome */
+static int build_function_table(ExecutionContext* ctx, ASTNode* program) {
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type != AST_FUNCTION_DEF) continue;
+        ctx->function_count++;
+        if (child->name_id > ctx->max_function_id) ctx->max_function_id = child->name_id;
+    }
+    
+    ctx->functions = (RuntimeFunction*)MEMORY_ALLOC(ctx->memory_manager,
+                                                    (size_t)(ctx->function_count + 1) * sizeof(RuntimeFunction));
+    ctx->function_by_id = (int*)MEMORY_ALLOC(ctx->memory_manager,
+                                             ((size_t)ctx->max_function_id + 1) * sizeof(int));
+    if (!ctx->functions || !ctx->function_by_id) return 0;
+    
+    for (InternId id = 0; id <= ctx->max_function_id; id++) ctx->function_by_id[id] = -1;
+    
+    int count = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type != AST_FUNCTION_DEF) continue;
+        
+        RuntimeFunction* function = &ctx->functions[count];
+        function->definition = child;
+        for (int p = 0; p < child->data.function->param_count; p++) {
+            function->param_ids[p] = child->data.function->params[p].name_id;
+        }
+        function->memoize = child->data.function->pure && child->data.function->recursive &&
+                            child->data.function->param_count <= MEMO_MAX_ARGS && g_config.memo_kb > 0;
+        function->calls = 0;
+        function->back_edges = 0;
+        if (child->name_id != INTERN_NONE && ctx->function_by_id[child->name_id] < 0) {
+            ctx->function_by_id[child->name_id] = count;
+        }
+        count++;
+    }
+    
+    return 1;
+}
+
+/* Preparar o JIT, que compila também as funções memorizadas. Sem suporte
+ * na plataforma, tudo segue interpretado */
+static void create_jit(ExecutionContext* ctx) {
+    if ((g_config.jit_calls <= 0 && g_config.jit_back_edges <= 0) || ctx->function_count == 0) return;
+    
+    ctx->jit_definitions = (ASTNode**)MEMORY_ALLOC(ctx->memory_manager,
+                                                   (size_t)ctx->function_count * sizeof(ASTNode*));
+    if (!ctx->jit_definitions) return;
+    
+    for (int i = 0; i < ctx->function_count; i++) {
+        ctx->jit_definitions[i] = ctx->functions[i].definition;
+    }
+    ctx->jit = jit_create(ctx->jit_definitions, ctx->function_count);
+}
+
 /* Criar interpretador */
 Interpreter* interpreter_create(ASTNode* ast, SymbolTable* st) {
-    Interpreter* interpreter = (Interpreter*)memory_alloc(g_memory_manager, sizeof(Interpreter));
+    Interpreter* interpreter = (Interpreter*)MEMORY_ALLOC(g_memory_manager, sizeof(Interpreter));
     if (!interpreter) {
         error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar interpretador");
         return NULL;
@@ -668,17 +1371,27 @@ int interpreter_execute(Interpreter* interpreter) {
         return 0;
     }
     
+    if (!build_function_table(ctx, interpreter->ast)) {
+        printf("ERRO DE EXECUÇÃO: Falha ao alocar tabela de funções\n");
+        destroy_execution_context(ctx);
+        return 0;
+    }
+    
     /* Executar função principal */
     /* Esta implementação é simplificada - uma implementação completa 
        precisaria de mais lógica para executar funções propriamente */
     
     for (int i = 0; i < interpreter->ast->child_count; i++) {
-        ASTNode* node = interpreter->ast->children[i];
+        ASTNode* node = ast_get_child(interpreter->ast, i);
         if (node->type == AST_FUNCTION_DEF && 
-            strcmp(node->data.function.name, "principal") == 0) {
+            strcmp(node->data.function->name, "principal") == 0) {
             
+            create_jit(ctx);
+            if (node->name_id != INTERN_NONE && node->name_id <= ctx->max_function_id) {
+                ctx->current_function = ctx->function_by_id[node->name_id];
+            }
             if (node->child_count > 0) {
-                execute_block(ctx, node->children[0]);
+                execute_block(ctx, ast_get_child(node, 0));
             }
             break;
         }
@@ -691,6 +1404,8 @@ int interpreter_execute(Interpreter* interpreter) {
     } else {
         printf("=== EXECUÇÃO CONCLUÍDA COM SUCESSO ===\n");
     }
+    memo_report(ctx);
+    jit_report(ctx->jit);
     
     destroy_execution_context(ctx);
     interpreter->running = 0;
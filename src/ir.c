@@ -0,0 +1,1330 @@
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime */
+#include "../include/compiler.h"
+
+/* Representação intermediária em SSA. Cada função é baixada da AST para
+ * instruções de três endereços em blocos básicos, com as arestas do grafo
+ * de controle explícitas (succs/preds). O SSA é montado durante a descida
+ * (Braun et al.): cada leitura de variável procura a definição no bloco e,
+ * se não houver, nos predecessores, criando phis nas junções. Blocos de
+ * laço só são selados depois da aresta de volta; phis criados antes disso
+ * recebem os operandos no selo. Phis triviais saem no fim da construção.
+ *
+ * Os tipos seguem os geradores nativos: operandos já convertidos ao tipo
+ * da operação, do parâmetro ou da variável, com IR_CONVERT explícito. */
+
+#define IR_ARENA_CHUNK 65536
+
+/* Definição de variável em um bloco, na tabela aberta do construtor */
+typedef struct {
+    int block;                  /* -1 se vazia */
+    int var;
+    int value;
+} IrDefinition;
+
+/* Variável visível no escopo atual */
+typedef struct {
+    InternId name_id;
+    int var;
+} IrScopeEntry;
+
+/* Phi criado em bloco ainda não selado */
+typedef struct {
+    int block;
+    int var;
+    int phi;
+} IrIncompletePhi;
+
+typedef struct {
+    IrModule* module;
+    IrFunction* function;
+    MemoryArena* arena;
+    int current;                /* Bloco que recebe as instruções */
+    IrScopeEntry* scope;
+    int scope_count;
+    int scope_capacity;
+    DataType* var_types;
+    int var_count;
+    int var_capacity;
+    IrDefinition* definitions;
+    int definition_count;
+    int definition_capacity;    /* Potência de 2 */
+    IrIncompletePhi* incomplete;
+    int incomplete_count;
+    int incomplete_capacity;
+    int ok;
+} IrBuilder;
+
+static int simplify_phis(IrModule* module, IrFunction* function);
+
+/* ================================
+   TABELAS NA ARENA
+   ================================ */
+
+/* Garantir espaço para mais um item; o vetor antigo fica na arena */
+static void* ir_reserve(MemoryArena* arena, void* items, int count, int* capacity, size_t size) {
+    if (count < *capacity) return items;
+    int grown = *capacity ? *capacity * 2 : 4;
+    void* copy = memory_arena_alloc(arena, (size_t)grown * size);
+    if (!copy) return NULL;
+    if (count > 0) memcpy(copy, items, (size_t)count * size);
+    *capacity = grown;
+    return copy;
+}
+
+static int is_terminator(IrOp op) {
+    return op == IR_JUMP || op == IR_BRANCH || op == IR_RETURN;
+}
+
+static int new_instr(MemoryArena* arena, IrFunction* function, IrOp op, DataType type) {
+    IrInstr* instrs = (IrInstr*)ir_reserve(arena, function->instrs, function->instr_count,
+                                           &function->instr_capacity, sizeof(IrInstr));
+    if (!instrs) return -1;
+    function->instrs = instrs;
+
+    IrInstr* instr = &function->instrs[function->instr_count];
+    memset(instr, 0, sizeof(IrInstr));
+    instr->op = op;
+    instr->type = type;
+    instr->targets[0] = instr->targets[1] = -1;
+    instr->block = -1;
+    return function->instr_count++;
+}
+
+static int add_operand(MemoryArena* arena, IrFunction* function, int id, int value) {
+    IrInstr* instr = &function->instrs[id];
+    int* operands = (int*)ir_reserve(arena, instr->operands, instr->operand_count,
+                                     &instr->operand_capacity, sizeof(int));
+    if (!operands) return 0;
+    instr->operands = operands;
+    instr->operands[instr->operand_count++] = value;
+    return 1;
+}
+
+/* Inserir instrução no bloco: no fim, ou no começo (depois dos phis) */
+static int place_instr(MemoryArena* arena, IrFunction* function, int block, int id, int at_front) {
+    IrBlock* target = &function->blocks[block];
+    int* instrs = (int*)ir_reserve(arena, target->instrs, target->instr_count,
+                                   &target->instr_capacity, sizeof(int));
+    if (!instrs) return 0;
+    target->instrs = instrs;
+
+    int position = target->instr_count;
+    if (at_front) {
+        position = 0;
+        while (position < target->instr_count &&
+               function->instrs[target->instrs[position]].op == IR_PHI) {
+            position++;
+        }
+        memmove(&target->instrs[position + 1], &target->instrs[position],
+                (size_t)(target->instr_count - position) * sizeof(int));
+    }
+    target->instrs[position] = id;
+    target->instr_count++;
+    function->instrs[id].block = block;
+    return 1;
+}
+
+static int new_block(MemoryArena* arena, IrFunction* function) {
+    IrBlock* blocks = (IrBlock*)ir_reserve(arena, function->blocks, function->block_count,
+                                           &function->block_capacity, sizeof(IrBlock));
+    if (!blocks) return -1;
+    function->blocks = blocks;
+    memset(&function->blocks[function->block_count], 0, sizeof(IrBlock));
+    return function->block_count++;
+}
+
+static int add_edge(MemoryArena* arena, IrFunction* function, int from, int to) {
+    IrBlock* target = &function->blocks[to];
+    int* preds = (int*)ir_reserve(arena, target->preds, target->pred_count,
+                                  &target->pred_capacity, sizeof(int));
+    if (!preds) return 0;
+    target->preds = preds;
+    target->preds[target->pred_count++] = from;
+    function->blocks[from].succs[function->blocks[from].succ_count++] = to;
+    return 1;
+}
+
+/* Tirar a aresta de pred: a entrada em preds e o operando dos phis */
+static void remove_pred_at(IrFunction* function, int block, int index) {
+    IrBlock* target = &function->blocks[block];
+    for (int i = 0; i < target->instr_count; i++) {
+        IrInstr* phi = &function->instrs[target->instrs[i]];
+        if (phi->op != IR_PHI) break;
+        if (index < phi->operand_count) {
+            memmove(&phi->operands[index], &phi->operands[index + 1],
+                    (size_t)(phi->operand_count - index - 1) * sizeof(int));
+            phi->operand_count--;
+        }
+    }
+    memmove(&target->preds[index], &target->preds[index + 1],
+            (size_t)(target->pred_count - index - 1) * sizeof(int));
+    target->pred_count--;
+}
+
+static void remove_edge(IrFunction* function, int from, int to) {
+    IrBlock* source = &function->blocks[from];
+    for (int i = 0; i < source->succ_count; i++) {
+        if (source->succs[i] != to) continue;
+        source->succs[i] = source->succs[--source->succ_count];
+        break;
+    }
+    IrBlock* target = &function->blocks[to];
+    for (int i = target->pred_count - 1; i >= 0; i--) {
+        if (target->preds[i] == from) {
+            remove_pred_at(function, to, i);
+            break;
+        }
+    }
+}
+
+/* Tirar instruções marcadas (keep[id] == 0) das listas dos blocos */
+static int sweep_instrs(IrFunction* function, const unsigned char* keep) {
+    int removed = 0;
+    for (int b = 0; b < function->block_count; b++) {
+        IrBlock* block = &function->blocks[b];
+        int count = 0;
+        for (int i = 0; i < block->instr_count; i++) {
+            int id = block->instrs[i];
+            if (keep[id]) {
+                block->instrs[count++] = id;
+            } else {
+                function->instrs[id].block = -1;
+                removed++;
+            }
+        }
+        block->instr_count = count;
+    }
+    return removed;
+}
+
+/* ================================
+   CONSTRUÇÃO DO SSA
+   ================================ */
+
+static int emit(IrBuilder* b, IrOp op, DataType type) {
+    int id = new_instr(b->arena, b->function, op, type);
+    if (id < 0 || !place_instr(b->arena, b->function, b->current, id, 0)) {
+        b->ok = 0;
+        return -1;
+    }
+    return id;
+}
+
+static void operand(IrBuilder* b, int id, int value) {
+    if (id < 0 || value < 0 || !add_operand(b->arena, b->function, id, value)) b->ok = 0;
+}
+
+static int emit_undef(IrBuilder* b, int block, DataType type) {
+    int id = new_instr(b->arena, b->function, IR_UNDEF, type);
+    if (id < 0 || !place_instr(b->arena, b->function, block, id, 1)) {
+        b->ok = 0;
+        return -1;
+    }
+    return id;
+}
+
+static int block(IrBuilder* b) {
+    int id = new_block(b->arena, b->function);
+    if (id < 0) b->ok = 0;
+    return id;
+}
+
+static void edge(IrBuilder* b, int from, int to) {
+    if (from < 0 || to < 0 || !add_edge(b->arena, b->function, from, to)) b->ok = 0;
+}
+
+static void jump_to(IrBuilder* b, int target) {
+    int id = emit(b, IR_JUMP, TYPE_VOID);
+    if (id < 0) return;
+    b->function->instrs[id].targets[0] = target;
+    edge(b, b->current, target);
+}
+
+static void branch_to(IrBuilder* b, int condition, int if_true, int if_false) {
+    int id = emit(b, IR_BRANCH, TYPE_VOID);
+    if (id < 0) return;
+    operand(b, id, condition);
+    b->function->instrs[id].targets[0] = if_true;
+    b->function->instrs[id].targets[1] = if_false;
+    edge(b, b->current, if_true);
+    edge(b, b->current, if_false);
+}
+
+static unsigned int definition_hash(int block, int var) {
+    return ((unsigned int)block * 2654435761u) ^ ((unsigned int)var * 40503u);
+}
+
+static IrDefinition* find_definition(IrBuilder* b, int block, int var) {
+    unsigned int mask = (unsigned int)b->definition_capacity - 1;
+    unsigned int slot = definition_hash(block, var) & mask;
+    while (b->definitions[slot].block >= 0) {
+        if (b->definitions[slot].block == block && b->definitions[slot].var == var) break;
+        slot = (slot + 1) & mask;
+    }
+    return &b->definitions[slot];
+}
+
+static int grow_definitions(IrBuilder* b) {
+    int capacity = b->definition_capacity ? b->definition_capacity * 2 : 256;
+    IrDefinition* old = b->definitions;
+    int old_capacity = b->definition_capacity;
+
+    b->definitions = (IrDefinition*)memory_arena_alloc(b->arena, (size_t)capacity * sizeof(IrDefinition));
+    if (!b->definitions) return 0;
+    b->definition_capacity = capacity;
+    for (int i = 0; i < capacity; i++) b->definitions[i].block = -1;
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].block >= 0) *find_definition(b, old[i].block, old[i].var) = old[i];
+    }
+    return 1;
+}
+
+static void write_variable(IrBuilder* b, int var, int block, int value) {
+    if (b->definition_count * 2 >= b->definition_capacity && !grow_definitions(b)) {
+        b->ok = 0;
+        return;
+    }
+    IrDefinition* definition = find_definition(b, block, var);
+    if (definition->block < 0) b->definition_count++;
+    definition->block = block;
+    definition->var = var;
+    definition->value = value;
+}
+
+static int new_phi(IrBuilder* b, int block, int var) {
+    int id = new_instr(b->arena, b->function, IR_PHI, b->var_types[var]);
+    if (id < 0 || !place_instr(b->arena, b->function, block, id, 1)) {
+        b->ok = 0;
+        return -1;
+    }
+    return id;
+}
+
+static int read_variable(IrBuilder* b, int var, int block);
+
+static void add_phi_operands(IrBuilder* b, int var, int phi) {
+    int block = b->function->instrs[phi].block;
+    for (int i = 0; i < b->function->blocks[block].pred_count && b->ok; i++) {
+        int value = read_variable(b, var, b->function->blocks[block].preds[i]);
+        operand(b, phi, value);
+    }
+}
+
+static int read_variable(IrBuilder* b, int var, int block) {
+    if (!b->ok) return -1;
+    if (b->definition_capacity > 0) {
+        IrDefinition* definition = find_definition(b, block, var);
+        if (definition->block >= 0) return definition->value;
+    }
+
+    IrBlock* current = &b->function->blocks[block];
+    int value;
+    if (!current->sealed) {
+        /* Predecessores ainda incompletos: operandos vêm no selo */
+        value = new_phi(b, block, var);
+        IrIncompletePhi* incomplete = (IrIncompletePhi*)ir_reserve(b->arena, b->incomplete, b->incomplete_count,
+                                                                   &b->incomplete_capacity, sizeof(IrIncompletePhi));
+        if (!incomplete) {
+            b->ok = 0;
+            return -1;
+        }
+        b->incomplete = incomplete;
+        b->incomplete[b->incomplete_count].block = block;
+        b->incomplete[b->incomplete_count].var = var;
+        b->incomplete[b->incomplete_count].phi = value;
+        b->incomplete_count++;
+    } else if (current->pred_count == 0) {
+        value = emit_undef(b, block, b->var_types[var]);
+    } else if (current->pred_count == 1) {
+        value = read_variable(b, var, current->preds[0]);
+    } else {
+        /* Definido antes dos operandos, para fechar ciclos de laço */
+        value = new_phi(b, block, var);
+        write_variable(b, var, block, value);
+        add_phi_operands(b, var, value);
+    }
+    write_variable(b, var, block, value);
+    return value;
+}
+
+static void seal(IrBuilder* b, int block) {
+    for (int i = 0; i < b->incomplete_count && b->ok; i++) {
+        if (b->incomplete[i].block != block) continue;
+        add_phi_operands(b, b->incomplete[i].var, b->incomplete[i].phi);
+        b->incomplete[i] = b->incomplete[--b->incomplete_count];
+        i--;
+    }
+    b->function->blocks[block].sealed = 1;
+}
+
+/* Bloco novo já selado e sem predecessores: recebe o que vem depois de um
+ * retorno, até ser descartado como inalcançável */
+static void start_unreachable(IrBuilder* b) {
+    int next = block(b);
+    if (next < 0) return;
+    b->current = next;
+    seal(b, next);
+}
+
+static int declare(IrBuilder* b, InternId name_id, DataType type) {
+    DataType* types = (DataType*)ir_reserve(b->arena, b->var_types, b->var_count,
+                                            &b->var_capacity, sizeof(DataType));
+    IrScopeEntry* scope = types ? (IrScopeEntry*)ir_reserve(b->arena, b->scope, b->scope_count,
+                                                           &b->scope_capacity, sizeof(IrScopeEntry)) : NULL;
+    if (!types || !scope) {
+        b->ok = 0;
+        return -1;
+    }
+    b->var_types = types;
+    b->scope = scope;
+    b->var_types[b->var_count] = type;
+    b->scope[b->scope_count].name_id = name_id;
+    b->scope[b->scope_count].var = b->var_count;
+    b->scope_count++;
+    return b->var_count++;
+}
+
+static int lookup(IrBuilder* b, InternId name_id) {
+    for (int i = b->scope_count - 1; i >= 0; i--) {
+        if (b->scope[i].name_id == name_id) return b->scope[i].var;
+    }
+    return -1;
+}
+
+/* ================================
+   DESCIDA DA AST
+   ================================ */
+
+static int lower_expression(IrBuilder* b, ASTNode* node);
+static void lower_statement(IrBuilder* b, ASTNode* node);
+
+static IrFunction* find_function(IrModule* module, InternId name_id) {
+    for (int i = 0; i < module->function_count; i++) {
+        if (module->functions[i].name_id == name_id) return &module->functions[i];
+    }
+    return NULL;
+}
+
+static int is_numeric(DataType type) {
+    return type == TYPE_INTEIRO || type == TYPE_DECIMAL;
+}
+
+/* Valor no tipo pedido; só entre inteiro e decimal há conversão */
+static int convert(IrBuilder* b, int value, DataType type) {
+    if (value < 0) return value;
+    DataType from = b->function->instrs[value].type;
+    if (from == type || !is_numeric(from) || !is_numeric(type)) return value;
+    int id = emit(b, IR_CONVERT, type);
+    operand(b, id, value);
+    return id;
+}
+
+static int lower_call(IrBuilder* b, ASTNode* node, int tail) {
+    IrFunction* callee = find_function(b->module, node->name_id);
+    const ASTNode* definition = callee ? callee->definition : NULL;
+    int args[MAX_FUNCTION_PARAMS];
+    int count = node->child_count < MAX_FUNCTION_PARAMS ? node->child_count : MAX_FUNCTION_PARAMS;
+
+    for (int i = 0; i < count; i++) {
+        args[i] = lower_expression(b, ast_get_child(node, i));
+        if (definition && i < definition->data.function->param_count) {
+            args[i] = convert(b, args[i], definition->data.function->params[i].type);
+        }
+    }
+
+    int id = emit(b, IR_CALL, callee ? callee->return_type : node->data_type);
+    if (id < 0) return -1;
+    b->function->instrs[id].name_id = node->name_id;
+    b->function->instrs[id].tail = tail;
+    for (int i = 0; i < count; i++) operand(b, id, args[i]);
+    return id;
+}
+
+static int lower_binary(IrBuilder* b, ASTNode* node) {
+    TokenType op = node->data.binary_op.operator;
+    ASTNode* left_node = ast_get_child(node, 0);
+    ASTNode* right_node = ast_get_child(node, 1);
+    int left = lower_expression(b, left_node);
+    int right = lower_expression(b, right_node);
+
+    DataType operand_type;
+    DataType result_type = TYPE_INTEIRO;
+    switch (op) {
+        case TOKEN_IGUAL: case TOKEN_DIFERENTE: case TOKEN_MENOR:
+        case TOKEN_MENOR_IGUAL: case TOKEN_MAIOR: case TOKEN_MAIOR_IGUAL:
+            if (left_node->data_type == TYPE_TEXTO && right_node->data_type == TYPE_TEXTO) {
+                operand_type = TYPE_TEXTO;
+            } else if (left_node->data_type == TYPE_INTEIRO && right_node->data_type == TYPE_INTEIRO) {
+                operand_type = TYPE_INTEIRO;
+            } else {
+                operand_type = TYPE_DECIMAL;
+            }
+            break;
+        case TOKEN_E: case TOKEN_OU:
+            /* Verdade de cada lado, no tipo que tiver */
+            operand_type = TYPE_VOID;
+            break;
+        default:
+            operand_type = result_type = node->data_type;
+            break;
+    }
+
+    if (operand_type != TYPE_VOID) {
+        left = convert(b, left, operand_type);
+        right = convert(b, right, operand_type);
+    }
+    int id = emit(b, IR_BINARY, result_type);
+    if (id < 0) return -1;
+    b->function->instrs[id].operator = op;
+    operand(b, id, left);
+    operand(b, id, right);
+    return id;
+}
+
+static int lower_expression(IrBuilder* b, ASTNode* node) {
+    if (!b->ok) return -1;
+
+    int id;
+    switch (node->type) {
+        case AST_LITERAL:
+            id = emit(b, IR_CONST, node->data_type);
+            if (id < 0) return -1;
+            switch (node->data_type) {
+                case TYPE_DECIMAL:
+                    b->function->instrs[id].constant.decimal_val = node->data.literal.decimal_val;
+                    break;
+                case TYPE_TEXTO:
+                    b->function->instrs[id].constant.text_val = memory_arena_strdup(b->arena, node->data.literal.string_val);
+                    if (!b->function->instrs[id].constant.text_val) b->ok = 0;
+                    break;
+                default:
+                    b->function->instrs[id].constant.int_val = node->data.literal.int_val;
+                    break;
+            }
+            return id;
+
+        case AST_IDENTIFIER: {
+            int var = lookup(b, node->name_id);
+            if (var < 0) return emit_undef(b, b->current, node->data_type);
+            return read_variable(b, var, b->current);
+        }
+
+        case AST_BINARY_OP:
+            return lower_binary(b, node);
+
+        case AST_FUNCTION_CALL:
+            if (node->token.type == TOKEN_FUNCAO_ID) return lower_call(b, node, 0);
+            break;
+
+        default:
+            break;
+    }
+    return emit_undef(b, b->current, node->data_type);
+}
+
+static void lower_block(IrBuilder* b, ASTNode* node) {
+    int scope = b->scope_count;
+    for (int i = 0; i < node->child_count && b->ok; i++) {
+        lower_statement(b, ast_get_child(node, i));
+    }
+    b->scope_count = scope;
+}
+
+static void lower_assignment(IrBuilder* b, ASTNode* node) {
+    int var = lookup(b, ast_get_child(node, 0)->name_id);
+    int value = lower_expression(b, ast_get_child(node, 1));
+    if (var < 0) return;
+    write_variable(b, var, b->current, convert(b, value, b->var_types[var]));
+}
+
+static void lower_io(IrBuilder* b, ASTNode* node) {
+    if (node->token.type == TOKEN_ESCREVA) {
+        /* Cada argumento sai logo depois de avaliado, como no interpretador */
+        for (int i = 0; i < node->child_count && b->ok; i++) {
+            int value = lower_expression(b, ast_get_child(node, i));
+            operand(b, emit(b, IR_WRITE, TYPE_VOID), value);
+        }
+        emit(b, IR_WRITE, TYPE_VOID);
+        return;
+    }
+
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* arg = ast_get_child(node, i);
+        int var = arg->type == AST_IDENTIFIER ? lookup(b, arg->name_id) : -1;
+        if (var < 0) continue;
+        int previous = read_variable(b, var, b->current);
+        int id = emit(b, IR_READ, b->var_types[var]);
+        operand(b, id, previous);
+        write_variable(b, var, b->current, id);
+    }
+}
+
+/* Laço a partir do cabeçalho: condição, corpo e (no para) incremento */
+static void lower_loop(IrBuilder* b, ASTNode* condition, ASTNode* body, ASTNode* step) {
+    int header = block(b);
+    int inner = block(b);
+    int exit = block(b);
+    if (!b->ok) return;
+
+    jump_to(b, header);
+    b->current = header;
+    int value = lower_expression(b, condition);
+    branch_to(b, value, inner, exit);
+
+    seal(b, inner);
+    b->current = inner;
+    lower_block(b, body);
+    if (step) lower_assignment(b, step);
+    jump_to(b, header);
+
+    seal(b, header);
+    seal(b, exit);
+    b->current = exit;
+}
+
+static void lower_statement(IrBuilder* b, ASTNode* node) {
+    if (!b->ok) return;
+
+    switch (node->type) {
+        case AST_VAR_DECL: {
+            DataType type = node->data.var_decl.var_type;
+            int value = node->child_count > 0
+                      ? convert(b, lower_expression(b, ast_get_child(node, 0)), type)
+                      : emit_undef(b, b->current, type);
+            int var = declare(b, node->name_id, type);
+            if (var >= 0) write_variable(b, var, b->current, value);
+            break;
+        }
+
+        case AST_ASSIGNMENT:
+            lower_assignment(b, node);
+            break;
+
+        case AST_FUNCTION_CALL:
+            if (node->token.type == TOKEN_FUNCAO_ID) {
+                lower_call(b, node, 0);
+            } else {
+                lower_io(b, node);
+            }
+            break;
+
+        case AST_IF_STMT: {
+            int value = lower_expression(b, ast_get_child(node, 0));
+            int then_block = block(b);
+            int join = block(b);
+            int else_block = node->child_count > 2 ? block(b) : join;
+            if (!b->ok) return;
+
+            branch_to(b, value, then_block, else_block);
+            seal(b, then_block);
+            b->current = then_block;
+            lower_block(b, ast_get_child(node, 1));
+            jump_to(b, join);
+
+            if (else_block != join) {
+                seal(b, else_block);
+                b->current = else_block;
+                lower_block(b, ast_get_child(node, 2));
+                jump_to(b, join);
+            }
+            seal(b, join);
+            b->current = join;
+            break;
+        }
+
+        case AST_WHILE_STMT:
+            lower_loop(b, ast_get_child(node, 0), ast_get_child(node, 1), NULL);
+            break;
+
+        case AST_FOR_STMT:
+            lower_assignment(b, ast_get_child(node, 0));
+            lower_loop(b, ast_get_child(node, 1), ast_get_child(node, 3), ast_get_child(node, 2));
+            break;
+
+        case AST_RETURN_STMT: {
+            ASTNode* value_node = node->child_count > 0 ? ast_get_child(node, 0) : NULL;
+            int value = -1;
+            if (value_node) {
+                int tail = node->data.return_stmt.tail_call && value_node->type == AST_FUNCTION_CALL &&
+                           value_node->token.type == TOKEN_FUNCAO_ID;
+                value = tail ? lower_call(b, value_node, 1) : lower_expression(b, value_node);
+            }
+            /* Em principal o valor é descartado, mas avaliado */
+            int id = emit(b, IR_RETURN, TYPE_VOID);
+            if (value >= 0 && b->function->return_type != TYPE_VOID) {
+                operand(b, id, convert(b, value, b->function->return_type));
+                /* A conversão entrou depois do retorno: trocar de lugar */
+                IrBlock* current = &b->function->blocks[b->current];
+                if (current->instr_count >= 2 && current->instrs[current->instr_count - 1] != id) {
+                    current->instrs[current->instr_count - 2] = current->instrs[current->instr_count - 1];
+                    current->instrs[current->instr_count - 1] = id;
+                }
+            }
+            start_unreachable(b);
+            break;
+        }
+
+        case AST_BLOCK:
+            lower_block(b, node);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static int lower_function(IrModule* module, IrFunction* function) {
+    IrBuilder b;
+    memset(&b, 0, sizeof(b));
+    b.module = module;
+    b.function = function;
+    b.arena = module->arena;
+    b.ok = 1;
+
+    const ASTNode* definition = function->definition;
+    b.current = block(&b);
+    if (!b.ok) return 0;
+    seal(&b, b.current);
+
+    for (int i = 0; i < definition->data.function->param_count && b.ok; i++) {
+        DataType type = definition->data.function->params[i].type;
+        int id = emit(&b, IR_PARAM, type);
+        if (id < 0) break;
+        function->instrs[id].constant.param = i;
+        int var = declare(&b, definition->data.function->params[i].name_id, type);
+        if (var >= 0) write_variable(&b, var, b.current, id);
+    }
+
+    if (definition->child_count > 0) lower_statement(&b, ast_get_child(definition, 0));
+
+    /* Fim do corpo sem retorno: retorna sem valor */
+    IrBlock* last = &function->blocks[b.current];
+    if (b.ok && (last->instr_count == 0 ||
+                 !is_terminator(function->instrs[last->instrs[last->instr_count - 1]].op))) {
+        emit(&b, IR_RETURN, TYPE_VOID);
+    }
+
+    if (b.ok) simplify_phis(module, function);
+    return b.ok;
+}
+
+/* Baixar as funções do programa para SSA. Funções com corpo ainda não
+ * analisado ficam de fora */
+IrModule* ir_build(ASTNode* program) {
+    if (!program || program->type != AST_PROGRAM) return NULL;
+
+    IrModule* module = (IrModule*)MEMORY_ALLOC(g_memory_manager, sizeof(IrModule));
+    if (!module) return NULL;
+    memset(module, 0, sizeof(IrModule));
+
+    module->arena = memory_arena_create(g_memory_manager, "ir", IR_ARENA_CHUNK);
+    int count = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type == AST_FUNCTION_DEF && !child->data.function->body_pending) count++;
+    }
+    if (module->arena && count > 0) {
+        module->functions = (IrFunction*)memory_arena_alloc(module->arena, (size_t)count * sizeof(IrFunction));
+    }
+    if (!module->arena || (count > 0 && !module->functions)) {
+        ir_destroy(module);
+        return NULL;
+    }
+
+    /* Assinaturas primeiro: chamadas podem vir antes da definição */
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = ast_get_child(program, i);
+        if (child->type != AST_FUNCTION_DEF || child->data.function->body_pending) continue;
+        IrFunction* function = &module->functions[module->function_count++];
+        memset(function, 0, sizeof(IrFunction));
+        function->definition = child;
+        function->name = child->data.function->name;
+        function->name_id = child->name_id;
+        function->return_type = strcmp(child->data.function->name, "principal") == 0
+                              ? TYPE_VOID : child->data.function->return_type;
+    }
+
+    for (int i = 0; i < module->function_count; i++) {
+        if (!lower_function(module, &module->functions[i])) {
+            error_report(ERROR_MEMORY, 0, 0, "Falha ao construir a representação intermediária");
+            ir_destroy(module);
+            return NULL;
+        }
+    }
+    return module;
+}
+
+void ir_destroy(IrModule* module) {
+    if (!module) return;
+    if (module->arena) memory_arena_destroy(module->arena);
+    memory_free(g_memory_manager, module);
+}
+
+/* ================================
+   PASSOS
+   ================================ */
+
+static int resolve(const int* alias, int value) {
+    while (alias[value] != value) value = alias[value];
+    return value;
+}
+
+/* Phis triviais (todos os operandos iguais, fora o próprio phi) trocados
+ * pelo valor único, até não haver mais; depois os usos são reescritos */
+static int simplify_phis(IrModule* module, IrFunction* function) {
+    int* alias = (int*)MEMORY_ALLOC(g_memory_manager, (size_t)(function->instr_count + 1) * sizeof(int));
+    unsigned char* keep = (unsigned char*)MEMORY_ALLOC(g_memory_manager, (size_t)function->instr_count + 1);
+    if (!alias || !keep) {
+        if (alias) memory_free(g_memory_manager, alias);
+        if (keep) memory_free(g_memory_manager, keep);
+        return 0;
+    }
+    int count = function->instr_count;
+    for (int i = 0; i < count; i++) {
+        alias[i] = i;
+        keep[i] = 1;
+    }
+
+    int removed = 0;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int id = 0; id < count; id++) {
+            IrInstr* phi = &function->instrs[id];
+            if (phi->op != IR_PHI || phi->block < 0 || !keep[id]) continue;
+
+            int same = -1;
+            int trivial = 1;
+            for (int i = 0; i < phi->operand_count; i++) {
+                int value = resolve(alias, phi->operands[i]);
+                if (value == id || value == same) continue;
+                if (same >= 0) {
+                    trivial = 0;
+                    break;
+                }
+                same = value;
+            }
+            if (!trivial) continue;
+
+            if (same < 0) {
+                /* Só se referia a si mesmo: laço sem definição de fora */
+                same = new_instr(module->arena, function, IR_UNDEF, function->instrs[id].type);
+                if (same < 0 || !place_instr(module->arena, function, function->instrs[id].block, same, 1)) break;
+            }
+            alias[id] = same;
+            keep[id] = 0;
+            removed++;
+            changed = 1;
+        }
+    }
+
+    if (removed > 0) {
+        for (int id = 0; id < function->instr_count; id++) {
+            IrInstr* instr = &function->instrs[id];
+            if (instr->block < 0) continue;
+            for (int i = 0; i < instr->operand_count; i++) {
+                instr->operands[i] = instr->operands[i] < count ? resolve(alias, instr->operands[i]) : instr->operands[i];
+            }
+        }
+        /* Indefinidos criados acima entram como mantidos */
+        unsigned char* all = keep;
+        if (function->instr_count > count) {
+            all = (unsigned char*)MEMORY_ALLOC(g_memory_manager, (size_t)function->instr_count);
+            if (all) {
+                memcpy(all, keep, (size_t)count);
+                memset(all + count, 1, (size_t)(function->instr_count - count));
+            }
+        }
+        if (all) sweep_instrs(function, all);
+        if (all && all != keep) memory_free(g_memory_manager, all);
+    }
+
+    memory_free(g_memory_manager, alias);
+    memory_free(g_memory_manager, keep);
+    return removed;
+}
+
+static int constant_truth(const IrInstr* instr) {
+    switch (instr->type) {
+        case TYPE_DECIMAL: return instr->constant.decimal_val != 0.0;
+        case TYPE_TEXTO: return instr->constant.text_val && instr->constant.text_val[0] != '\0';
+        default: return instr->constant.int_val != 0;
+    }
+}
+
+/* Operação entre constantes, com a aritmética de 32 bits do
+ * interpretador. Divisão por zero fica para a execução */
+static int fold_binary(IrInstr* instr, const IrInstr* left, const IrInstr* right) {
+    TokenType op = instr->operator;
+    int result = 0;
+
+    if (op == TOKEN_E || op == TOKEN_OU) {
+        int a = constant_truth(left);
+        int c = constant_truth(right);
+        result = op == TOKEN_E ? (a && c) : (a || c);
+    } else if (left->type == TYPE_TEXTO || right->type == TYPE_TEXTO) {
+        if (left->type != right->type || (op != TOKEN_IGUAL && op != TOKEN_DIFERENTE)) return 0;
+        int equal = strcmp(left->constant.text_val, right->constant.text_val) == 0;
+        result = op == TOKEN_IGUAL ? equal : !equal;
+    } else if (left->type == TYPE_DECIMAL || right->type == TYPE_DECIMAL) {
+        if (left->type != right->type) return 0;
+        double a = left->constant.decimal_val;
+        double c = right->constant.decimal_val;
+        switch (op) {
+            case TOKEN_MAIS: instr->constant.decimal_val = a + c; break;
+            case TOKEN_MENOS: instr->constant.decimal_val = a - c; break;
+            case TOKEN_MULT: instr->constant.decimal_val = a * c; break;
+            case TOKEN_DIV:
+                if (c == 0.0) return 0;
+                instr->constant.decimal_val = a / c;
+                break;
+            case TOKEN_IGUAL: result = a == c; break;
+            case TOKEN_DIFERENTE: result = a != c; break;
+            case TOKEN_MENOR: result = a < c; break;
+            case TOKEN_MENOR_IGUAL: result = a <= c; break;
+            case TOKEN_MAIOR: result = a > c; break;
+            case TOKEN_MAIOR_IGUAL: result = a >= c; break;
+            default: return 0;
+        }
+        if (instr->type == TYPE_DECIMAL) return 1;
+    } else {
+        int a = left->constant.int_val;
+        int c = right->constant.int_val;
+        switch (op) {
+            case TOKEN_MAIS: result = (int)((unsigned int)a + (unsigned int)c); break;
+            case TOKEN_MENOS: result = (int)((unsigned int)a - (unsigned int)c); break;
+            case TOKEN_MULT: result = (int)((unsigned int)a * (unsigned int)c); break;
+            case TOKEN_DIV:
+                if (c == 0 || (a == INT32_MIN && c == -1)) return 0;
+                result = a / c;
+                break;
+            case TOKEN_IGUAL: result = a == c; break;
+            case TOKEN_DIFERENTE: result = a != c; break;
+            case TOKEN_MENOR: result = a < c; break;
+            case TOKEN_MENOR_IGUAL: result = a <= c; break;
+            case TOKEN_MAIOR: result = a > c; break;
+            case TOKEN_MAIOR_IGUAL: result = a >= c; break;
+            default: return 0;
+        }
+    }
+
+    if (instr->type != TYPE_INTEIRO) return 0;
+    instr->constant.int_val = result;
+    return 1;
+}
+
+/* Dobrar operações e conversões de constantes; desvio com condição
+ * constante vira salto, e a aresta não tomada sai do grafo */
+static int fold_constants(IrModule* module, IrFunction* function) {
+    (void)module;
+    int changes = 0;
+    int changed = 1;
+
+    while (changed) {
+        changed = 0;
+        for (int id = 0; id < function->instr_count; id++) {
+            IrInstr* instr = &function->instrs[id];
+            if (instr->block < 0) continue;
+
+            if (instr->op == IR_BINARY) {
+                const IrInstr* left = &function->instrs[instr->operands[0]];
+                const IrInstr* right = &function->instrs[instr->operands[1]];
+                if (left->op != IR_CONST || right->op != IR_CONST) continue;
+                IrInstr folded = *instr;
+                if (!fold_binary(&folded, left, right)) continue;
+                instr->constant = folded.constant;
+            } else if (instr->op == IR_CONVERT) {
+                const IrInstr* source = &function->instrs[instr->operands[0]];
+                if (source->op != IR_CONST) continue;
+                if (instr->type == TYPE_DECIMAL && source->type == TYPE_INTEIRO) {
+                    instr->constant.decimal_val = (double)source->constant.int_val;
+                } else if (instr->type == TYPE_INTEIRO && source->type == TYPE_DECIMAL) {
+                    instr->constant.int_val = (int)source->constant.decimal_val;
+                } else {
+                    continue;
+                }
+            } else if (instr->op == IR_BRANCH) {
+                const IrInstr* condition = &function->instrs[instr->operands[0]];
+                if (condition->op != IR_CONST) continue;
+                int taken = instr->targets[constant_truth(condition) ? 0 : 1];
+                int dropped = instr->targets[constant_truth(condition) ? 1 : 0];
+                remove_edge(function, instr->block, dropped);
+                instr->op = IR_JUMP;
+                instr->targets[0] = taken;
+                instr->targets[1] = -1;
+                instr->operand_count = 0;
+                changes++;
+                changed = 1;
+                continue;
+            } else {
+                continue;
+            }
+
+            instr->op = IR_CONST;
+            instr->operand_count = 0;
+            changes++;
+            changed = 1;
+        }
+    }
+    return changes;
+}
+
+/* Blocos que a entrada não alcança saem do grafo, com suas arestas */
+static int remove_unreachable(IrModule* module, IrFunction* function) {
+    (void)module;
+    if (function->block_count == 0) return 0;
+
+    unsigned char* reached = (unsigned char*)MEMORY_ALLOC(g_memory_manager, (size_t)function->block_count);
+    int* stack = (int*)MEMORY_ALLOC(g_memory_manager, (size_t)function->block_count * sizeof(int));
+    if (!reached || !stack) {
+        if (reached) memory_free(g_memory_manager, reached);
+        if (stack) memory_free(g_memory_manager, stack);
+        return 0;
+    }
+    memset(reached, 0, (size_t)function->block_count);
+
+    int top = 0;
+    stack[top++] = 0;
+    reached[0] = 1;
+    while (top > 0) {
+        const IrBlock* block = &function->blocks[stack[--top]];
+        for (int i = 0; i < block->succ_count; i++) {
+            if (!reached[block->succs[i]]) {
+                reached[block->succs[i]] = 1;
+                stack[top++] = block->succs[i];
+            }
+        }
+    }
+
+    int removed = 0;
+    for (int b = 0; b < function->block_count; b++) {
+        IrBlock* block = &function->blocks[b];
+        if (reached[b] || block->removed) continue;
+        while (block->succ_count > 0) remove_edge(function, b, block->succs[0]);
+        for (int i = 0; i < block->instr_count; i++) function->instrs[block->instrs[i]].block = -1;
+        block->instr_count = 0;
+        block->pred_count = 0;
+        block->removed = 1;
+        removed++;
+    }
+
+    memory_free(g_memory_manager, reached);
+    memory_free(g_memory_manager, stack);
+    return removed;
+}
+
+/* Efeito observável: entrada e saída, chamadas, controle e divisões que
+ * podem falhar na execução */
+static int has_effect(const IrFunction* function, const IrInstr* instr) {
+    switch (instr->op) {
+        case IR_CALL: case IR_READ: case IR_WRITE:
+        case IR_JUMP: case IR_BRANCH: case IR_RETURN:
+            return 1;
+        case IR_BINARY:
+            if (instr->operator == TOKEN_DIV) {
+                const IrInstr* divisor = &function->instrs[instr->operands[1]];
+                return divisor->op != IR_CONST || divisor->type == TYPE_TEXTO ||
+                       (divisor->type == TYPE_DECIMAL ? divisor->constant.decimal_val == 0.0
+                                                      : divisor->constant.int_val == 0);
+            }
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+/* Remover valores que nenhuma instrução com efeito usa */
+static int eliminate_dead_code(IrModule* module, IrFunction* function) {
+    (void)module;
+    if (function->instr_count == 0) return 0;
+
+    unsigned char* live = (unsigned char*)MEMORY_ALLOC(g_memory_manager, (size_t)function->instr_count);
+    int* worklist = (int*)MEMORY_ALLOC(g_memory_manager, (size_t)function->instr_count * sizeof(int));
+    if (!live || !worklist) {
+        if (live) memory_free(g_memory_manager, live);
+        if (worklist) memory_free(g_memory_manager, worklist);
+        return 0;
+    }
+    memset(live, 0, (size_t)function->instr_count);
+
+    int top = 0;
+    for (int id = 0; id < function->instr_count; id++) {
+        if (function->instrs[id].block >= 0 && has_effect(function, &function->instrs[id])) {
+            live[id] = 1;
+            worklist[top++] = id;
+        }
+    }
+    while (top > 0) {
+        const IrInstr* instr = &function->instrs[worklist[--top]];
+        for (int i = 0; i < instr->operand_count; i++) {
+            int value = instr->operands[i];
+            if (!live[value]) {
+                live[value] = 1;
+                worklist[top++] = value;
+            }
+        }
+    }
+
+    int removed = sweep_instrs(function, live);
+    memory_free(g_memory_manager, live);
+    memory_free(g_memory_manager, worklist);
+    return removed;
+}
+
+/* ================================
+   GERENCIADOR DE PASSOS
+   ================================ */
+
+static double ir_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+IrPassManager* ir_pass_manager_create(void) {
+    IrPassManager* pm = (IrPassManager*)MEMORY_ALLOC(g_memory_manager, sizeof(IrPassManager));
+    if (pm) memset(pm, 0, sizeof(IrPassManager));
+    return pm;
+}
+
+void ir_pass_manager_destroy(IrPassManager* pm) {
+    if (!pm) return;
+    if (pm->passes) memory_free(g_memory_manager, pm->passes);
+    memory_free(g_memory_manager, pm);
+}
+
+int ir_pass_manager_add(IrPassManager* pm, const char* name, IrPassFunction run) {
+    if (!pm || !name || !run) return 0;
+    if (pm->pass_count >= pm->pass_capacity) {
+        int capacity = pm->pass_capacity ? pm->pass_capacity * 2 : 8;
+        IrPass* passes = (IrPass*)MEMORY_REALLOC(g_memory_manager, pm->passes, (size_t)capacity * sizeof(IrPass));
+        if (!passes) return 0;
+        pm->passes = passes;
+        pm->pass_capacity = capacity;
+    }
+    IrPass* pass = &pm->passes[pm->pass_count++];
+    pass->name = name;
+    pass->run = run;
+    pass->seconds = 0.0;
+    pass->changes = 0;
+    return 1;
+}
+
+/* Sequência padrão: dobrar antes de podar o grafo, que deixa phis
+ * triviais e valores sem uso para os passos seguintes */
+int ir_pass_manager_add_defaults(IrPassManager* pm) {
+    return ir_pass_manager_add(pm, "dobra-constantes", fold_constants) &&
+           ir_pass_manager_add(pm, "remove-inalcancaveis", remove_unreachable) &&
+           ir_pass_manager_add(pm, "simplifica-phi", simplify_phis) &&
+           ir_pass_manager_add(pm, "elimina-codigo-morto", eliminate_dead_code);
+}
+
+/* Executar cada passo sobre todas as funções, na ordem de inclusão */
+int ir_pass_manager_run(IrPassManager* pm, IrModule* module) {
+    if (!pm || !module) return 0;
+    int changes = 0;
+    for (int p = 0; p < pm->pass_count; p++) {
+        IrPass* pass = &pm->passes[p];
+        double start = ir_now();
+        for (int f = 0; f < module->function_count; f++) {
+            int count = pass->run(module, &module->functions[f]);
+            pass->changes += count;
+            changes += count;
+        }
+        pass->seconds += ir_now() - start;
+    }
+    return changes;
+}
+
+void ir_pass_manager_report(const IrPassManager* pm, FILE* out) {
+    if (!pm || !out) return;
+    fprintf(out, "=== PASSOS DA IR ===\n");
+    for (int p = 0; p < pm->pass_count; p++) {
+        fprintf(out, "%-24s %10.3f ms  %ld alterações\n", pm->passes[p].name,
+                pm->passes[p].seconds * 1000.0, pm->passes[p].changes);
+    }
+    fprintf(out, "====================\n");
+}
+
+/* ================================
+   VERIFICAÇÃO E IMPRESSÃO
+   ================================ */
+
+static int verify_fail(const IrFunction* function, int block, const char* message) {
+    printf("IR inválida em %s, b%d: %s\n", function->name, block, message);
+    return 0;
+}
+
+/* Conferir a forma da IR: terminador no fim de cada bloco, phis no começo
+ * com um operando por predecessor, arestas nos dois sentidos e operandos
+ * definidos */
+static int verify_function(const IrFunction* function) {
+    for (int b = 0; b < function->block_count; b++) {
+        const IrBlock* block = &function->blocks[b];
+        if (block->removed) continue;
+        if (block->instr_count == 0) return verify_fail(function, b, "bloco vazio");
+
+        int phis_done = 0;
+        for (int i = 0; i < block->instr_count; i++) {
+            const IrInstr* instr = &function->instrs[block->instrs[i]];
+            int last = i == block->instr_count - 1;
+            if (instr->block != b) return verify_fail(function, b, "instrução fora do seu bloco");
+            if (is_terminator(instr->op) != last) return verify_fail(function, b, "terminador fora do fim");
+            if (instr->op == IR_PHI) {
+                if (phis_done) return verify_fail(function, b, "phi depois de outra instrução");
+                if (instr->operand_count != block->pred_count) {
+                    return verify_fail(function, b, "phi sem um operando por predecessor");
+                }
+            } else {
+                phis_done = 1;
+            }
+            for (int o = 0; o < instr->operand_count; o++) {
+                int value = instr->operands[o];
+                if (value < 0 || value >= function->instr_count || function->instrs[value].block < 0) {
+                    return verify_fail(function, b, "operando sem definição");
+                }
+            }
+        }
+
+        const IrInstr* terminator = &function->instrs[block->instrs[block->instr_count - 1]];
+        int expected = terminator->op == IR_JUMP ? 1 : terminator->op == IR_BRANCH ? 2 : 0;
+        if (block->succ_count != expected) return verify_fail(function, b, "sucessores não batem com o terminador");
+        for (int s = 0; s < block->succ_count; s++) {
+            const IrBlock* succ = &function->blocks[block->succs[s]];
+            int found = 0;
+            for (int p = 0; p < succ->pred_count; p++) found |= succ->preds[p] == b;
+            if (!found || succ->removed) return verify_fail(function, b, "aresta sem predecessor correspondente");
+        }
+    }
+    return 1;
+}
+
+int ir_verify(const IrModule* module) {
+    if (!module) return 0;
+    int ok = 1;
+    for (int i = 0; i < module->function_count; i++) ok &= verify_function(&module->functions[i]);
+    return ok;
+}
+
+static const char* operator_symbol(TokenType op) {
+    switch (op) {
+        case TOKEN_MAIS: return "+";
+        case TOKEN_MENOS: return "-";
+        case TOKEN_MULT: return "*";
+        case TOKEN_DIV: return "/";
+        case TOKEN_POT: return "^";
+        case TOKEN_IGUAL: return "==";
+        case TOKEN_DIFERENTE: return "<>";
+        case TOKEN_MENOR: return "<";
+        case TOKEN_MENOR_IGUAL: return "<=";
+        case TOKEN_MAIOR: return ">";
+        case TOKEN_MAIOR_IGUAL: return ">=";
+        case TOKEN_E: return "&&";
+        case TOKEN_OU: return "||";
+        default: return "?";
+    }
+}
+
+static void print_operands(const IrInstr* instr, FILE* out) {
+    for (int i = 0; i < instr->operand_count; i++) {
+        fprintf(out, "%s%%%d", i > 0 ? ", " : "", instr->operands[i]);
+    }
+}
+
+static void print_instr(const IrFunction* function, int id, FILE* out) {
+    const IrInstr* instr = &function->instrs[id];
+    fputs("    ", out);
+    if (instr->type != TYPE_VOID && !is_terminator(instr->op) && instr->op != IR_WRITE) {
+        fprintf(out, "%%%d: %s = ", id, data_type_to_string(instr->type));
+    }
+
+    switch (instr->op) {
+        case IR_CONST:
+            if (instr->type == TYPE_DECIMAL) {
+                fprintf(out, "%g", instr->constant.decimal_val);
+            } else if (instr->type == TYPE_TEXTO) {
+                fprintf(out, "\"%s\"", instr->constant.text_val);
+            } else {
+                fprintf(out, "%d", instr->constant.int_val);
+            }
+            break;
+        case IR_PARAM:
+            fprintf(out, "parametro %d", instr->constant.param);
+            break;
+        case IR_UNDEF:
+            fputs("indefinido", out);
+            break;
+        case IR_PHI: {
+            const IrBlock* block = &function->blocks[instr->block];
+            fputs("phi ", out);
+            for (int i = 0; i < instr->operand_count; i++) {
+                fprintf(out, "%s[%%%d, b%d]", i > 0 ? ", " : "", instr->operands[i], block->preds[i]);
+            }
+            break;
+        }
+        case IR_BINARY:
+            fprintf(out, "%%%d %s %%%d", instr->operands[0], operator_symbol(instr->operator), instr->operands[1]);
+            break;
+        case IR_CONVERT:
+            fprintf(out, "converte %%%d", instr->operands[0]);
+            break;
+        case IR_CALL:
+            fprintf(out, "chama %s(", intern_text(instr->name_id));
+            print_operands(instr, out);
+            fputs(instr->tail ? ") cauda" : ")", out);
+            break;
+        case IR_READ:
+            fputs("leia ", out);
+            print_operands(instr, out);
+            break;
+        case IR_WRITE:
+            if (instr->operand_count == 0) {
+                fputs("quebra-linha", out);
+            } else {
+                fputs("escreva ", out);
+                print_operands(instr, out);
+            }
+            break;
+        case IR_JUMP:
+            fprintf(out, "salta b%d", instr->targets[0]);
+            break;
+        case IR_BRANCH:
+            fprintf(out, "desvia %%%d, b%d, b%d", instr->operands[0], instr->targets[0], instr->targets[1]);
+            break;
+        case IR_RETURN:
+            fputs("retorna", out);
+            if (instr->operand_count > 0) fprintf(out, " %%%d", instr->operands[0]);
+            break;
+    }
+    fputc('\n', out);
+}
+
+void ir_print(const IrModule* module, FILE* out) {
+    if (!module || !out) return;
+
+    fprintf(out, "=== REPRESENTAÇÃO INTERMEDIÁRIA (SSA) ===\n");
+    for (int f = 0; f < module->function_count; f++) {
+        const IrFunction* function = &module->functions[f];
+        const ASTNode* definition = function->definition;
+
+        fprintf(out, "%s %s(", function->return_type == TYPE_VOID ? "funcao" :
+                data_type_to_string(function->return_type), function->name);
+        for (int i = 0; i < definition->data.function->param_count; i++) {
+            fprintf(out, "%s%s", i > 0 ? ", " : "", data_type_to_string(definition->data.function->params[i].type));
+        }
+        fputs(")\n", out);
+
+        for (int b = 0; b < function->block_count; b++) {
+            const IrBlock* block = &function->blocks[b];
+            if (block->removed) continue;
+            fprintf(out, "  b%d:", b);
+            if (block->pred_count > 0) {
+                fputs("  ; de", out);
+                for (int p = 0; p < block->pred_count; p++) fprintf(out, " b%d", block->preds[p]);
+            }
+            fputc('\n', out);
+            for (int i = 0; i < block->instr_count; i++) print_instr(function, block->instrs[i], out);
+        }
+    }
+    fprintf(out, "=========================================\n");
+}
@@ -0,0 +1,563 @@
+#include "../include/compiler.h"
+
+/* Execução direta da IR (--executar-ir). Cada chamada tem um quadro com
+ * uma posição por valor da função, numa pilha em segmentos que cresce com
+ * a profundidade; constantes são lidas da própria instrução e não ocupam
+ * posição. Os blocos são percorridos a partir da entrada e, ao entrar
+ * num bloco, os phis leem juntos o operando do predecessor de onde se
+ * veio.
+ *
+ * Aritmética, conversões, escrita, leitura e erros seguem o
+ * interpretador. Chamada de cauda cujo valor é retornado direto reusa o
+ * quadro e não conta para o limite de chamadas aninhadas. Valores sem
+ * definição (variável declarada sem valor, função sem retorno) não são
+ * escritos, como no interpretador. */
+
+#define IR_EXEC_ARENA_CHUNK 16384
+#define IR_STACK_SEGMENT 2048   /* Valores por segmento da pilha */
+
+/* Valor em trânsito; no quadro fica só a palavra e a marca de definido,
+ * o tipo é o da instrução que o define */
+typedef union {
+    int int_val;
+    double decimal_val;
+    const char* text_val;
+} IrWord;
+
+typedef struct {
+    DataType type;
+    int initialized;            /* 0 para valores indefinidos */
+    IrWord as;
+} IrValue;
+
+/* Segmento da pilha de quadros: quadros não mudam de lugar, então a
+ * pilha cresce sem copiar os anteriores */
+typedef struct IrStackSegment {
+    struct IrStackSegment* previous;
+    int capacity;
+    int used;
+    IrWord* words;
+    unsigned char* defined;
+} IrStackSegment;
+
+typedef struct {
+    IrWord* words;
+    unsigned char* defined;
+} IrFrame;
+
+/* Topo da pilha, para desempilhar tudo o que veio depois */
+typedef struct {
+    IrStackSegment* segment;
+    int used;
+} IrStackMark;
+
+/* Função preparada: posição de cada valor no quadro (-1 se constante ou
+ * sem valor) */
+typedef struct {
+    const IrFunction* function;
+    int* slots;
+    int frame_size;
+    int param_count;
+} IrExecFunction;
+
+typedef struct {
+    IrExecFunction* functions;
+    int function_count;
+    int* function_by_id;        /* Id do nome -> índice em functions */
+    InternId max_function_id;
+    IrStackSegment* stack;      /* Segmento do topo */
+    IrStackSegment* spare;      /* Último segmento esvaziado, para reuso */
+    int depth;
+    MemoryArena* arena;         /* Tabelas de posições e textos lidos */
+    char* read_buffer;          /* max_string_length bytes para leia texto */
+    const char* error;          /* NULL enquanto não houver erro */
+} IrExecutor;
+
+static void exec_error(IrExecutor* ex, const char* message) {
+    if (!ex->error) ex->error = message;
+}
+
+/* ================================
+   PREPARAÇÃO
+   ================================ */
+
+static int defines_value(const IrInstr* instr) {
+    switch (instr->op) {
+        case IR_PARAM: case IR_UNDEF: case IR_PHI: case IR_BINARY:
+        case IR_CONVERT: case IR_CALL: case IR_READ:
+            return instr->block >= 0;
+        default:
+            return 0;
+    }
+}
+
+static int prepare_function(IrExecutor* ex, IrExecFunction* prepared, const IrFunction* function) {
+    prepared->function = function;
+    prepared->param_count = function->definition->data.function->param_count;
+    prepared->frame_size = 0;
+    prepared->slots = NULL;
+    if (function->instr_count == 0) return 1;
+
+    prepared->slots = (int*)memory_arena_alloc(ex->arena, (size_t)function->instr_count * sizeof(int));
+    if (!prepared->slots) return 0;
+    for (int id = 0; id < function->instr_count; id++) {
+        prepared->slots[id] = defines_value(&function->instrs[id]) ? prepared->frame_size++ : -1;
+    }
+    return 1;
+}
+
+static int prepare(IrExecutor* ex, const IrModule* module) {
+    ex->arena = memory_arena_create(g_memory_manager, "ir-execucao", IR_EXEC_ARENA_CHUNK);
+    if (!ex->arena) return 0;
+
+    ex->read_buffer = (char*)memory_arena_alloc(ex->arena, (size_t)g_config.max_string_length);
+    ex->function_count = module->function_count;
+    ex->functions = module->function_count > 0
+        ? (IrExecFunction*)memory_arena_alloc(ex->arena, (size_t)module->function_count * sizeof(IrExecFunction))
+        : NULL;
+    if (!ex->read_buffer || (module->function_count > 0 && !ex->functions)) return 0;
+
+    for (int i = 0; i < module->function_count; i++) {
+        if (module->functions[i].name_id > ex->max_function_id) ex->max_function_id = module->functions[i].name_id;
+    }
+    ex->function_by_id = (int*)memory_arena_alloc(ex->arena, ((size_t)ex->max_function_id + 1) * sizeof(int));
+    if (!ex->function_by_id) return 0;
+    for (InternId id = 0; id <= ex->max_function_id; id++) ex->function_by_id[id] = -1;
+
+    for (int i = 0; i < module->function_count; i++) {
+        if (!prepare_function(ex, &ex->functions[i], &module->functions[i])) return 0;
+        InternId id = module->functions[i].name_id;
+        if (id != INTERN_NONE && ex->function_by_id[id] < 0) ex->function_by_id[id] = i;
+    }
+    return 1;
+}
+
+/* ================================
+   PILHA DE QUADROS
+   ================================ */
+
+static IrStackMark stack_mark(const IrExecutor* ex) {
+    IrStackMark mark = {ex->stack, ex->stack ? ex->stack->used : 0};
+    return mark;
+}
+
+/* Desempilhar até a marca; o último segmento esvaziado fica de reserva */
+static void stack_release(IrExecutor* ex, IrStackMark mark) {
+    while (ex->stack && ex->stack != mark.segment) {
+        IrStackSegment* segment = ex->stack;
+        ex->stack = segment->previous;
+        if (ex->spare) memory_free(g_memory_manager, ex->spare);
+        segment->used = 0;
+        ex->spare = segment;
+    }
+    if (ex->stack) ex->stack->used = mark.used;
+}
+
+/* Quadro de count valores, todos indefinidos */
+static int push_frame(IrExecutor* ex, int count, IrFrame* frame) {
+    IrStackSegment* segment = ex->stack;
+    if (!segment || segment->capacity - segment->used < count) {
+        if (ex->spare && ex->spare->capacity >= count) {
+            segment = ex->spare;
+            ex->spare = NULL;
+        } else {
+            int capacity = count > IR_STACK_SEGMENT ? count : IR_STACK_SEGMENT;
+            segment = (IrStackSegment*)MEMORY_ALLOC(g_memory_manager, sizeof(IrStackSegment) +
+                                                    (size_t)capacity * (sizeof(IrWord) + 1));
+            if (!segment) {
+                exec_error(ex, "Falha ao alocar quadro de chamada");
+                return 0;
+            }
+            segment->capacity = capacity;
+            segment->words = (IrWord*)(segment + 1);
+            segment->defined = (unsigned char*)(segment->words + capacity);
+        }
+        segment->used = 0;
+        segment->previous = ex->stack;
+        ex->stack = segment;
+    }
+
+    frame->words = segment->words + segment->used;
+    frame->defined = segment->defined + segment->used;
+    memset(frame->defined, 0, (size_t)count);
+    segment->used += count;
+    return 1;
+}
+
+static void stack_destroy(IrExecutor* ex) {
+    while (ex->stack) {
+        IrStackSegment* previous = ex->stack->previous;
+        memory_free(g_memory_manager, ex->stack);
+        ex->stack = previous;
+    }
+    if (ex->spare) memory_free(g_memory_manager, ex->spare);
+    ex->spare = NULL;
+}
+
+/* ================================
+   VALORES
+   ================================ */
+
+static IrValue undefined_value(DataType type) {
+    IrValue value;
+    memset(&value, 0, sizeof(value));
+    value.type = type;
+    return value;
+}
+
+/* Valor do operando: constante da instrução ou posição do quadro */
+static IrValue operand_value(const IrExecFunction* fn, const IrFrame* frame, int id) {
+    const IrInstr* instr = &fn->function->instrs[id];
+    IrValue value = undefined_value(instr->type);
+    if (instr->op == IR_CONST) {
+        value.initialized = 1;
+        switch (instr->type) {
+            case TYPE_DECIMAL: value.as.decimal_val = instr->constant.decimal_val; break;
+            case TYPE_TEXTO: value.as.text_val = instr->constant.text_val; break;
+            default: value.as.int_val = instr->constant.int_val; break;
+        }
+    } else if (fn->slots[id] >= 0) {
+        value.initialized = frame->defined[fn->slots[id]];
+        value.as = frame->words[fn->slots[id]];
+    }
+    return value;
+}
+
+static void store_value(const IrExecFunction* fn, IrFrame* frame, int id, const IrValue* value) {
+    int slot = fn->slots[id];
+    if (slot < 0) return;
+    frame->words[slot] = value->as;
+    frame->defined[slot] = (unsigned char)value->initialized;
+}
+
+static int value_truth(const IrValue* value) {
+    if (!value->initialized) return 0;
+    switch (value->type) {
+        case TYPE_INTEIRO: return value->as.int_val != 0;
+        case TYPE_DECIMAL: return value->as.decimal_val != 0.0;
+        case TYPE_TEXTO: return value->as.text_val != NULL && value->as.text_val[0] != '\0';
+        default: return 0;
+    }
+}
+
+static double value_number(const IrValue* value) {
+    if (value->type == TYPE_DECIMAL) return value->as.decimal_val;
+    return value->type == TYPE_INTEIRO ? value->as.int_val : 0;
+}
+
+static IrValue convert_value(IrValue value, DataType type) {
+    if (value.type == TYPE_INTEIRO && type == TYPE_DECIMAL) {
+        value.as.decimal_val = (double)value.as.int_val;
+        value.type = TYPE_DECIMAL;
+    } else if (value.type == TYPE_DECIMAL && type == TYPE_INTEIRO) {
+        value.as.int_val = (int)value.as.decimal_val;
+        value.type = TYPE_INTEIRO;
+    }
+    return value;
+}
+
+/* Operação binária com a aritmética de 32 bits do interpretador; os
+ * operandos já chegam no tipo da operação */
+static IrValue binary_value(IrExecutor* ex, const IrInstr* instr, const IrValue* left, const IrValue* right) {
+    IrValue result = undefined_value(TYPE_INTEIRO);
+    result.initialized = 1;
+    TokenType op = instr->operator;
+
+    switch (op) {
+        case TOKEN_MAIS: case TOKEN_MENOS: case TOKEN_MULT: case TOKEN_DIV:
+            if (instr->type == TYPE_DECIMAL) {
+                double a = value_number(left);
+                double c = value_number(right);
+                result.type = TYPE_DECIMAL;
+                if (op == TOKEN_MAIS) result.as.decimal_val = a + c;
+                else if (op == TOKEN_MENOS) result.as.decimal_val = a - c;
+                else if (op == TOKEN_MULT) result.as.decimal_val = a * c;
+                else if (c == 0.0) exec_error(ex, "Divisão por zero");
+                else result.as.decimal_val = a / c;
+            } else {
+                unsigned int a = (unsigned int)left->as.int_val;
+                unsigned int c = (unsigned int)right->as.int_val;
+                if (op == TOKEN_MAIS) result.as.int_val = (int)(a + c);
+                else if (op == TOKEN_MENOS) result.as.int_val = (int)(a - c);
+                else if (op == TOKEN_MULT) result.as.int_val = (int)(a * c);
+                else if (right->as.int_val == 0) exec_error(ex, "Divisão por zero");
+                else if (right->as.int_val == -1) result.as.int_val = (int)(0u - a);
+                else result.as.int_val = left->as.int_val / right->as.int_val;
+            }
+            return result;
+
+        case TOKEN_IGUAL: case TOKEN_DIFERENTE: case TOKEN_MENOR:
+        case TOKEN_MENOR_IGUAL: case TOKEN_MAIOR: case TOKEN_MAIOR_IGUAL:
+            if (left->type == TYPE_TEXTO && right->type == TYPE_TEXTO) {
+                int equal = strcmp(left->as.text_val ? left->as.text_val : "",
+                                   right->as.text_val ? right->as.text_val : "") == 0;
+                if (op == TOKEN_IGUAL) result.as.int_val = equal;
+                else if (op == TOKEN_DIFERENTE) result.as.int_val = !equal;
+                else exec_error(ex, "Operador não suportado para texto");
+            } else {
+                double a = value_number(left);
+                double c = value_number(right);
+                switch (op) {
+                    case TOKEN_IGUAL: result.as.int_val = a == c; break;
+                    case TOKEN_DIFERENTE: result.as.int_val = a != c; break;
+                    case TOKEN_MENOR: result.as.int_val = a < c; break;
+                    case TOKEN_MENOR_IGUAL: result.as.int_val = a <= c; break;
+                    case TOKEN_MAIOR: result.as.int_val = a > c; break;
+                    default: result.as.int_val = a >= c; break;
+                }
+            }
+            return result;
+
+        case TOKEN_E:
+            result.as.int_val = value_truth(left) && value_truth(right);
+            return result;
+        case TOKEN_OU:
+            result.as.int_val = value_truth(left) || value_truth(right);
+            return result;
+
+        default:
+            /* Operador sem avaliação no interpretador: valor indefinido */
+            return undefined_value(instr->type);
+    }
+}
+
+/* escreva: cada operando sai sem separador; sem operandos, a quebra de linha */
+static void write_values(const IrExecFunction* fn, const IrFrame* frame, const IrInstr* instr) {
+    if (instr->operand_count == 0) {
+        printf("\n");
+        return;
+    }
+    for (int i = 0; i < instr->operand_count; i++) {
+        IrValue value = operand_value(fn, frame, instr->operands[i]);
+        if (!value.initialized) continue;
+        switch (value.type) {
+            case TYPE_INTEIRO: printf("%d", value.as.int_val); break;
+            case TYPE_DECIMAL: printf("%.2f", value.as.decimal_val); break;
+            case TYPE_TEXTO: if (value.as.text_val) printf("%s", value.as.text_val); break;
+            default: break;
+        }
+    }
+}
+
+/* leia: sem entrada, o valor anterior da variável fica */
+static IrValue read_value(IrExecutor* ex, const IrInstr* instr, IrValue previous) {
+    IrValue value = undefined_value(instr->type);
+    value.initialized = 1;
+    if (previous.initialized && previous.type == instr->type) value.as = previous.as;
+
+    printf("Digite um valor: ");
+    fflush(stdout);
+
+    switch (instr->type) {
+        case TYPE_INTEIRO:
+            if (scanf("%d", &value.as.int_val) != 1) value.as.int_val = previous.initialized ? previous.as.int_val : 0;
+            break;
+        case TYPE_DECIMAL:
+            if (scanf("%lf", &value.as.decimal_val) != 1) {
+                value.as.decimal_val = previous.initialized ? previous.as.decimal_val : 0.0;
+            }
+            break;
+        case TYPE_TEXTO: {
+            char format[32];
+            snprintf(format, sizeof(format), "%%%ds", g_config.max_string_length - 1);
+            if (scanf(format, ex->read_buffer) == 1) {
+                value.as.text_val = memory_arena_strdup(ex->arena, ex->read_buffer);
+                if (!value.as.text_val) exec_error(ex, "Falha ao alocar texto lido");
+            } else if (!value.as.text_val) {
+                value.as.text_val = "";
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return value;
+}
+
+/* ================================
+   EXECUÇÃO
+   ================================ */
+
+static int lookup_function(const IrExecutor* ex, InternId name_id) {
+    return name_id != INTERN_NONE && name_id <= ex->max_function_id ? ex->function_by_id[name_id] : -1;
+}
+
+/* Entrar no bloco vindo de from: phis avaliados juntos, pelo operando da
+ * aresta, antes de qualquer escrita no quadro */
+static int enter_block(IrExecutor* ex, const IrExecFunction* fn, IrFrame* frame, int block, int from, int* first) {
+    const IrBlock* target = &fn->function->blocks[block];
+    int pred = 0;
+    while (pred < target->pred_count && target->preds[pred] != from) pred++;
+
+    int phi_count = 0;
+    while (phi_count < target->instr_count && fn->function->instrs[target->instrs[phi_count]].op == IR_PHI) {
+        phi_count++;
+    }
+    *first = phi_count;
+    if (phi_count == 0) return 1;
+
+    IrStackMark mark = stack_mark(ex);
+    IrFrame scratch;
+    if (!push_frame(ex, phi_count, &scratch)) return 0;
+    for (int i = 0; i < phi_count; i++) {
+        const IrInstr* phi = &fn->function->instrs[target->instrs[i]];
+        IrValue value = pred < phi->operand_count
+                      ? operand_value(fn, frame, phi->operands[pred]) : undefined_value(phi->type);
+        scratch.words[i] = value.as;
+        scratch.defined[i] = (unsigned char)value.initialized;
+    }
+    for (int i = 0; i < phi_count; i++) {
+        int slot = fn->slots[target->instrs[i]];
+        frame->words[slot] = scratch.words[i];
+        frame->defined[slot] = scratch.defined[i];
+    }
+    stack_release(ex, mark);
+    return 1;
+}
+
+/* Executar a função com argumentos já convertidos; o quadro sai da pilha
+ * no retorno */
+static int run_function(IrExecutor* ex, int index, const IrValue* args, IrValue* result) {
+    IrValue call_args[MAX_FUNCTION_PARAMS];
+    for (int i = 0; i < ex->functions[index].param_count; i++) call_args[i] = args[i];
+    IrStackMark mark = stack_mark(ex);
+
+    for (;;) {
+        const IrExecFunction* fn = &ex->functions[index];
+        const IrFunction* function = fn->function;
+        IrFrame frame;
+        stack_release(ex, mark);
+        if (!push_frame(ex, fn->frame_size, &frame)) return 0;
+
+        int block = 0;
+        int position = 0;
+        int tail = -1;
+        while (tail < 0) {
+            const IrBlock* current = &function->blocks[block];
+            if (position >= current->instr_count) {
+                exec_error(ex, "Bloco da IR sem terminador");
+                return 0;
+            }
+            int id = current->instrs[position++];
+            const IrInstr* instr = &function->instrs[id];
+            IrValue value = undefined_value(instr->type);
+
+            switch (instr->op) {
+                case IR_CONST:
+                case IR_PHI:
+                    continue;
+                case IR_PARAM:
+                    if (instr->constant.param < fn->param_count) value = call_args[instr->constant.param];
+                    break;
+                case IR_UNDEF:
+                    break;
+                case IR_BINARY: {
+                    IrValue left = operand_value(fn, &frame, instr->operands[0]);
+                    IrValue right = operand_value(fn, &frame, instr->operands[1]);
+                    value = binary_value(ex, instr, &left, &right);
+                    break;
+                }
+                case IR_CONVERT:
+                    value = convert_value(operand_value(fn, &frame, instr->operands[0]), instr->type);
+                    break;
+                case IR_CALL: {
+                    int callee = lookup_function(ex, instr->name_id);
+                    if (callee < 0) {
+                        exec_error(ex, "Função não declarada");
+                        break;
+                    }
+                    if (instr->operand_count != ex->functions[callee].param_count) {
+                        exec_error(ex, "Número incorreto de argumentos");
+                        break;
+                    }
+                    IrValue next_args[MAX_FUNCTION_PARAMS];
+                    for (int i = 0; i < instr->operand_count; i++) {
+                        next_args[i] = operand_value(fn, &frame, instr->operands[i]);
+                    }
+
+                    /* Cauda retornada direto: o quadro atual dá lugar ao da chamada */
+                    const IrInstr* next = position < current->instr_count
+                                        ? &function->instrs[current->instrs[position]] : NULL;
+                    if (instr->tail && ex->depth > 0 && next && next->op == IR_RETURN &&
+                        next->operand_count == 1 && next->operands[0] == id) {
+                        for (int i = 0; i < instr->operand_count; i++) call_args[i] = next_args[i];
+                        tail = callee;
+                        continue;
+                    }
+
+                    if (ex->depth >= MAX_CALL_DEPTH) {
+                        exec_error(ex, "Profundidade máxima de chamadas excedida");
+                        break;
+                    }
+                    ex->depth++;
+                    int ok = run_function(ex, callee, next_args, &value);
+                    ex->depth--;
+                    if (!ok) return 0;
+                    value.type = instr->type;
+                    break;
+                }
+                case IR_READ:
+                    value = read_value(ex, instr, operand_value(fn, &frame, instr->operands[0]));
+                    break;
+                case IR_WRITE:
+                    write_values(fn, &frame, instr);
+                    continue;
+                case IR_JUMP:
+                case IR_BRANCH: {
+                    int taken = instr->targets[0];
+                    if (instr->op == IR_BRANCH) {
+                        IrValue condition = operand_value(fn, &frame, instr->operands[0]);
+                        if (!value_truth(&condition)) taken = instr->targets[1];
+                    }
+                    if (!enter_block(ex, fn, &frame, taken, block, &position)) return 0;
+                    block = taken;
+                    continue;
+                }
+                case IR_RETURN:
+                    *result = instr->operand_count > 0
+                            ? operand_value(fn, &frame, instr->operands[0])
+                            : undefined_value(TYPE_VOID);
+                    stack_release(ex, mark);
+                    return 1;
+            }
+
+            if (ex->error) return 0;
+            store_value(fn, &frame, id, &value);
+        }
+        index = tail;
+    }
+}
+
+/* Executar o programa pela IR a partir de principal */
+int ir_execute(const IrModule* module) {
+    if (!module) return 0;
+
+    IrExecutor ex;
+    memset(&ex, 0, sizeof(ex));
+
+    printf("=== INICIANDO EXECUÇÃO ===\n");
+
+    int principal = -1;
+    if (!prepare(&ex, module)) {
+        exec_error(&ex, "Falha ao preparar a execução da IR");
+    } else {
+        principal = lookup_function(&ex, intern_lookup("principal"));
+        if (principal < 0) exec_error(&ex, "Função principal não encontrada");
+    }
+
+    if (!ex.error) {
+        IrValue result;
+        run_function(&ex, principal, NULL, &result);
+    }
+
+    int success = ex.error == NULL;
+    if (success) {
+        printf("=== EXECUÇÃO CONCLUÍDA COM SUCESSO ===\n");
+    } else {
+        printf("ERRO DE EXECUÇÃO: %s\n", ex.error);
+    }
+
+    stack_destroy(&ex);
+    if (ex.arena) memory_arena_destroy(ex.arena);
+    return success;
+}
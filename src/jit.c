@@ -0,0 +1,1018 @@
+#define _DEFAULT_SOURCE  /* mmap com MAP_ANONYMOUS, sysconf */
+#include "../include/compiler.h"
+#include <stddef.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* JIT por modelos para x86-64. Compila funções e laços quentes que só
+ * usam inteiros: cada nó vira uma sequência fixa de instruções, com o
+ * resultado em %eax e o operando esquerdo empilhado, como no gerador de
+ * assembly. Variáveis ficam no quadro nativo; a aritmética é de 32 bits,
+ * como a do interpretador.
+ *
+ * Funções compiladas: int32_t f(JitState*, a0..a4), argumentos em
+ * %esi..%r9d. Laços: int32_t laco(JitState*, int32_t* valores), com as
+ * variáveis externas ao laço copiadas na entrada e devolvidas na saída.
+ * Chamadas entre funções compiladas passam pela tabela de entradas, então
+ * funções mutuamente recursivas são instaladas juntas. Erros (divisão por
+ * zero, profundidade) ficam em JitState e desfazem as chamadas nativas.
+ *
+ * O que o modelo não cobre (decimal, texto, E/S, funções memorizadas,
+ * chamada de cauda a outra função) recusa a unidade inteira, que continua
+ * interpretada. */
+
+#define JIT_MAX_ARGS 5
+
+/* Deslocamentos no quadro nativo */
+#define JIT_STATE_SLOT (-8)
+#define JIT_VALUES_SLOT (-16)
+
+enum { JIT_NOT_TRIED = 0, JIT_COMPILED = 1, JIT_REJECTED = -1 };
+
+typedef int32_t (*JitFunctionCode)(JitState*, int32_t, int32_t, int32_t, int32_t, int32_t);
+typedef int32_t (*JitLoopCode)(JitState*, int32_t*);
+
+/* Laço compilado (entry NULL: recusado) */
+struct JitLoop {
+    const ASTNode* node;
+    void* entry;
+    InternId inputs[JIT_MAX_LOOP_VARS];
+    int input_count;
+};
+
+/* Região de memória executável */
+typedef struct {
+    void* address;
+    size_t size;
+} JitMapping;
+
+struct JitCompiler {
+    ASTNode** functions;
+    int function_count;
+    signed char* state;             /* JIT_NOT_TRIED, JIT_COMPILED ou JIT_REJECTED */
+    void** entries;                 /* Código de cada função, usado nas chamadas */
+    struct JitLoop* loops;
+    int loop_count;
+    int loop_capacity;
+    JitMapping* mappings;
+    int mapping_count;
+    int mapping_capacity;
+    size_t page_size;
+    int functions_compiled;
+    int functions_rejected;
+    int loops_compiled;
+    int loops_rejected;
+    long native_calls;
+    long native_loops;
+    size_t code_bytes;
+};
+
+/* Salto ainda sem destino: posição do rel32 e rótulo */
+typedef struct {
+    size_t position;
+    int label;
+} JitFixup;
+
+typedef struct {
+    InternId name_id;
+    int offset;
+} JitVariable;
+
+/* Unidade em construção: código de uma função ou de um laço */
+typedef struct {
+    JitCompiler* jit;
+    unsigned char* code;
+    size_t size;
+    size_t capacity;
+    size_t* labels;
+    int label_count;
+    int label_capacity;
+    JitFixup* fixups;
+    int fixup_count;
+    int fixup_capacity;
+    JitVariable* variables;
+    int variable_count;
+    int variable_capacity;
+    int frame_size;
+    size_t frame_patch;             /* Posição do tamanho do quadro no prólogo */
+    int function;                   /* Função compilada ou que contém o laço */
+    int is_loop;
+    int body_label;                 /* Corpo da função: destino da cauda a si mesma */
+    int fail_label;
+    int exit_label;
+    int division_label;
+    int depth_label;
+    unsigned char* callees;         /* Funções chamadas pela unidade */
+    int ok;
+} JitUnit;
+
+#define JIT_LABEL_UNBOUND ((size_t)-1)
+
+/* ================================
+   EMISSÃO DE BYTES E RÓTULOS
+   ================================ */
+
+static void put(JitUnit* unit, const unsigned char* bytes, size_t count) {
+    if (!unit->ok) return;
+    if (unit->size + count > unit->capacity) {
+        size_t capacity = unit->capacity ? unit->capacity * 2 : 1024;
+        while (capacity < unit->size + count) capacity *= 2;
+        unsigned char* code = (unsigned char*)MEMORY_REALLOC(g_memory_manager, unit->code, capacity);
+        if (!code) {
+            unit->ok = 0;
+            return;
+        }
+        unit->code = code;
+        unit->capacity = capacity;
+    }
+    memcpy(unit->code + unit->size, bytes, count);
+    unit->size += count;
+}
+
+#define PUT(unit, ...) do { \
+    static const unsigned char bytes_[] = {__VA_ARGS__}; \
+    put((unit), bytes_, sizeof(bytes_)); \
+} while (0)
+
+static void put32(JitUnit* unit, int32_t value) {
+    unsigned char bytes[4];
+    uint32_t bits = (uint32_t)value;
+    for (int i = 0; i < 4; i++) bytes[i] = (unsigned char)(bits >> (8 * i));
+    put(unit, bytes, 4);
+}
+
+static void put64(JitUnit* unit, uint64_t value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (unsigned char)(value >> (8 * i));
+    put(unit, bytes, 8);
+}
+
+static void patch32(JitUnit* unit, size_t position, int32_t value) {
+    uint32_t bits = (uint32_t)value;
+    for (int i = 0; i < 4; i++) unit->code[position + i] = (unsigned char)(bits >> (8 * i));
+}
+
+static int new_label(JitUnit* unit) {
+    if (unit->label_count >= unit->label_capacity) {
+        int capacity = unit->label_capacity ? unit->label_capacity * 2 : 32;
+        size_t* labels = (size_t*)MEMORY_REALLOC(g_memory_manager, unit->labels,
+                                                 (size_t)capacity * sizeof(size_t));
+        if (!labels) {
+            unit->ok = 0;
+            return 0;
+        }
+        unit->labels = labels;
+        unit->label_capacity = capacity;
+    }
+    unit->labels[unit->label_count] = JIT_LABEL_UNBOUND;
+    return unit->label_count++;
+}
+
+static void bind_label(JitUnit* unit, int label) {
+    if (unit->ok) unit->labels[label] = unit->size;
+}
+
+/* Salto para rótulo: opcode já escrito, rel32 resolvido no fim */
+static void put_target(JitUnit* unit, int label) {
+    if (!unit->ok) return;
+    if (unit->fixup_count >= unit->fixup_capacity) {
+        int capacity = unit->fixup_capacity ? unit->fixup_capacity * 2 : 32;
+        JitFixup* fixups = (JitFixup*)MEMORY_REALLOC(g_memory_manager, unit->fixups,
+                                                     (size_t)capacity * sizeof(JitFixup));
+        if (!fixups) {
+            unit->ok = 0;
+            return;
+        }
+        unit->fixups = fixups;
+        unit->fixup_capacity = capacity;
+    }
+    unit->fixups[unit->fixup_count].position = unit->size;
+    unit->fixups[unit->fixup_count].label = label;
+    unit->fixup_count++;
+    put32(unit, 0);
+}
+
+static void jump(JitUnit* unit, int label) { PUT(unit, 0xE9); put_target(unit, label); }
+static void jump_if_zero(JitUnit* unit, int label) { PUT(unit, 0x0F, 0x84); put_target(unit, label); }
+static void jump_if_not_zero(JitUnit* unit, int label) { PUT(unit, 0x0F, 0x85); put_target(unit, label); }
+static void jump_if_greater_equal(JitUnit* unit, int label) { PUT(unit, 0x0F, 0x8D); put_target(unit, label); }
+
+static void resolve_labels(JitUnit* unit) {
+    for (int i = 0; i < unit->fixup_count && unit->ok; i++) {
+        size_t target = unit->labels[unit->fixups[i].label];
+        if (target == JIT_LABEL_UNBOUND) {
+            unit->ok = 0;
+            break;
+        }
+        size_t next = unit->fixups[i].position + 4;
+        patch32(unit, unit->fixups[i].position, (int32_t)((long)target - (long)next));
+    }
+}
+
+/* ================================
+   MODELOS DE INSTRUÇÕES
+   ================================ */
+
+static void load_local(JitUnit* unit, int offset) { PUT(unit, 0x8B, 0x85); put32(unit, offset); }   /* mov eax, [rbp+d] */
+static void store_local(JitUnit* unit, int offset) { PUT(unit, 0x89, 0x85); put32(unit, offset); }  /* mov [rbp+d], eax */
+static void load_state(JitUnit* unit) { PUT(unit, 0x48, 0x8B, 0xBD); put32(unit, JIT_STATE_SLOT); } /* mov rdi, [rbp-8] */
+static void load_values(JitUnit* unit) { PUT(unit, 0x48, 0x8B, 0xB5); put32(unit, JIT_VALUES_SLOT); } /* mov rsi, [rbp-16] */
+static void push_eax(JitUnit* unit) { PUT(unit, 0x50); }
+static void pop_left(JitUnit* unit) { PUT(unit, 0x89, 0xC1, 0x58); }  /* mov ecx, eax; pop rax */
+static void to_truth(JitUnit* unit) { PUT(unit, 0x85, 0xC0, 0x0F, 0x95, 0xC0, 0x0F, 0xB6, 0xC0); }
+static void leave_return(JitUnit* unit) { PUT(unit, 0xC9, 0xC3); }
+
+/* Gravar código de erro em JitState e desfazer a unidade */
+static void set_error(JitUnit* unit, int error) {
+    load_state(unit);
+    PUT(unit, 0xC7, 0x47, (unsigned char)offsetof(JitState, error));   /* mov dword [rdi+e], imm32 */
+    put32(unit, error);
+    jump(unit, unit->fail_label);
+}
+
+static int alloc_slot(JitUnit* unit) {
+    unit->frame_size += 8;
+    return JIT_VALUES_SLOT - unit->frame_size;
+}
+
+static int find_variable(JitUnit* unit, InternId name_id, int* offset) {
+    for (int i = unit->variable_count - 1; i >= 0; i--) {
+        if (unit->variables[i].name_id == name_id) {
+            *offset = unit->variables[i].offset;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void declare_variable(JitUnit* unit, InternId name_id, int offset) {
+    if (unit->variable_count >= unit->variable_capacity) {
+        int capacity = unit->variable_capacity ? unit->variable_capacity * 2 : 32;
+        JitVariable* variables = (JitVariable*)MEMORY_REALLOC(g_memory_manager, unit->variables,
+                                                              (size_t)capacity * sizeof(JitVariable));
+        if (!variables) {
+            unit->ok = 0;
+            return;
+        }
+        unit->variables = variables;
+        unit->variable_capacity = capacity;
+    }
+    unit->variables[unit->variable_count].name_id = name_id;
+    unit->variables[unit->variable_count].offset = offset;
+    unit->variable_count++;
+}
+
+/* ================================
+   FUNÇÕES ACEITAS
+   ================================ */
+
+static int find_function(const JitCompiler* jit, InternId name_id) {
+    for (int i = 0; i < jit->function_count; i++) {
+        if (jit->functions[i]->name_id == name_id) return i;
+    }
+    return -1;
+}
+
+/* Assinatura só de inteiros, cabendo nos registradores */
+static int signature_supported(const JitCompiler* jit, int index) {
+    const ASTNode* function = jit->functions[index];
+    if (function->data.function->body_pending ||
+        function->data.function->param_count > JIT_MAX_ARGS ||
+        function->data.function->return_type != TYPE_INTEIRO ||
+        strcmp(function->data.function->name, "principal") == 0) {
+        return 0;
+    }
+    for (int i = 0; i < function->data.function->param_count; i++) {
+        if (function->data.function->params[i].type != TYPE_INTEIRO) return 0;
+    }
+    return 1;
+}
+
+/* O bloco termina sempre em retorno com valor (senão a função devolveria
+ * um valor não inicializado, que o código nativo não representa) */
+static int always_returns(const ASTNode* block) {
+    if (!block || block->type != AST_BLOCK || block->child_count == 0) return 0;
+    const ASTNode* last = ast_get_child(block, block->child_count - 1);
+    if (last->type == AST_RETURN_STMT) return last->child_count > 0;
+    if (last->type == AST_IF_STMT && last->child_count > 2) {
+        return always_returns(ast_get_child(last, 1)) && always_returns(ast_get_child(last, 2));
+    }
+    if (last->type == AST_BLOCK) return always_returns(last);
+    return 0;
+}
+
+/* ================================
+   EXPRESSÕES E COMANDOS
+   ================================ */
+
+static void compile_expression(JitUnit* unit, ASTNode* node);
+static void compile_statement(JitUnit* unit, ASTNode* node);
+
+static int is_user_call(const ASTNode* node) {
+    return node->type == AST_FUNCTION_CALL && node->token.type == TOKEN_FUNCAO_ID;
+}
+
+/* Chamada a função compilada pela tabela de entradas. Fora da cauda
+ * confere e conta a profundidade como o interpretador; na cauda o quadro
+ * do interpretador seria reaproveitado, então a profundidade não muda */
+static void compile_call(JitUnit* unit, ASTNode* node, int tail) {
+    static const unsigned char pops[JIT_MAX_ARGS][2] = {
+        {0x5E, 0}, {0x5A, 0}, {0x59, 0}, {0x41, 0x58}, {0x41, 0x59}   /* rsi, rdx, rcx, r8, r9 */
+    };
+    int callee = find_function(unit->jit, node->name_id);
+    if (callee < 0 || !signature_supported(unit->jit, callee) ||
+        unit->jit->functions[callee]->data.function->param_count != node->child_count) {
+        unit->ok = 0;
+        return;
+    }
+    unit->callees[callee] = 1;
+
+    if (!tail) {
+        load_state(unit);
+        PUT(unit, 0x81, 0x7F, (unsigned char)offsetof(JitState, depth));   /* cmp dword [rdi+p], imm32 */
+        put32(unit, MAX_CALL_DEPTH);
+        jump_if_greater_equal(unit, unit->depth_label);
+    }
+
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* arg = ast_get_child(node, i);
+        if (arg->data_type != TYPE_INTEIRO) {
+            unit->ok = 0;
+            return;
+        }
+        compile_expression(unit, arg);
+        push_eax(unit);
+    }
+    for (int i = node->child_count - 1; i >= 0; i--) {
+        put(unit, pops[i], pops[i][0] == 0x41 ? 2 : 1);
+    }
+
+    load_state(unit);
+    if (!tail) PUT(unit, 0xFF, 0x47, (unsigned char)offsetof(JitState, depth));   /* inc dword [rdi+p] */
+    PUT(unit, 0x48, 0xB8);                                                        /* mov rax, &entries[callee] */
+    put64(unit, (uint64_t)(uintptr_t)&unit->jit->entries[callee]);
+    PUT(unit, 0xFF, 0x10);                                                        /* call [rax] */
+    load_state(unit);
+    if (!tail) PUT(unit, 0xFF, 0x4F, (unsigned char)offsetof(JitState, depth));   /* dec dword [rdi+p] */
+    PUT(unit, 0x83, 0x7F, (unsigned char)offsetof(JitState, error), 0x00);       /* cmp dword [rdi+e], 0 */
+    jump_if_not_zero(unit, unit->fail_label);
+}
+
+static void compile_binary(JitUnit* unit, ASTNode* node) {
+    TokenType op = node->data.binary_op.operator;
+    ASTNode* left = ast_get_child(node, 0);
+    ASTNode* right = ast_get_child(node, 1);
+    if (left->data_type != TYPE_INTEIRO || right->data_type != TYPE_INTEIRO) {
+        unit->ok = 0;
+        return;
+    }
+
+    int logical = op == TOKEN_E || op == TOKEN_OU;
+    int offset;
+    compile_expression(unit, left);
+    if (logical) to_truth(unit);
+    if (!logical && right->type == AST_LITERAL) {
+        /* Operando direito simples vai direto para %ecx, sem a pilha */
+        PUT(unit, 0xB9);                                            /* mov ecx, imm32 */
+        put32(unit, right->data.literal.int_val);
+    } else if (!logical && right->type == AST_IDENTIFIER && find_variable(unit, right->name_id, &offset)) {
+        PUT(unit, 0x8B, 0x8D);                                      /* mov ecx, [rbp+d] */
+        put32(unit, offset);
+    } else {
+        push_eax(unit);
+        compile_expression(unit, right);
+        if (logical) to_truth(unit);
+        pop_left(unit);
+    }
+
+    switch (op) {
+        case TOKEN_MAIS: PUT(unit, 0x01, 0xC8); break;              /* add eax, ecx */
+        case TOKEN_MENOS: PUT(unit, 0x29, 0xC8); break;             /* sub eax, ecx */
+        case TOKEN_MULT: PUT(unit, 0x0F, 0xAF, 0xC1); break;        /* imul eax, ecx */
+        case TOKEN_DIV:
+            PUT(unit, 0x85, 0xC9);                                  /* test ecx, ecx */
+            jump_if_zero(unit, unit->division_label);
+            PUT(unit, 0x83, 0xF9, 0xFF, 0x75, 0x04);                /* cmp ecx, -1; jne idiv */
+            PUT(unit, 0xF7, 0xD8, 0xEB, 0x03);                      /* neg eax; jmp fim */
+            PUT(unit, 0x99, 0xF7, 0xF9);                            /* idiv: cdq; idiv ecx */
+            break;
+        case TOKEN_E: PUT(unit, 0x21, 0xC8); break;                 /* and eax, ecx */
+        case TOKEN_OU: PUT(unit, 0x09, 0xC8); break;                /* or eax, ecx */
+        case TOKEN_IGUAL: case TOKEN_DIFERENTE: case TOKEN_MENOR:
+        case TOKEN_MENOR_IGUAL: case TOKEN_MAIOR: case TOKEN_MAIOR_IGUAL: {
+            unsigned char condition = 0x94;                         /* sete */
+            switch (op) {
+                case TOKEN_DIFERENTE: condition = 0x95; break;
+                case TOKEN_MENOR: condition = 0x9C; break;
+                case TOKEN_MENOR_IGUAL: condition = 0x9E; break;
+                case TOKEN_MAIOR: condition = 0x9F; break;
+                case TOKEN_MAIOR_IGUAL: condition = 0x9D; break;
+                default: break;
+            }
+            unsigned char compare[] = {0x39, 0xC8, 0x0F, condition, 0xC0, 0x0F, 0xB6, 0xC0};
+            put(unit, compare, sizeof(compare));                    /* cmp eax, ecx; setcc al; movzx */
+            break;
+        }
+        default:
+            /* Potência: o interpretador não a calcula */
+            unit->ok = 0;
+            break;
+    }
+}
+
+static void compile_expression(JitUnit* unit, ASTNode* node) {
+    if (!unit->ok) return;
+    if (node->data_type != TYPE_INTEIRO) {
+        unit->ok = 0;
+        return;
+    }
+
+    int offset;
+    switch (node->type) {
+        case AST_LITERAL:
+            PUT(unit, 0xB8);                                        /* mov eax, imm32 */
+            put32(unit, node->data.literal.int_val);
+            break;
+        case AST_IDENTIFIER:
+            if (find_variable(unit, node->name_id, &offset)) {
+                load_local(unit, offset);
+            } else {
+                unit->ok = 0;
+            }
+            break;
+        case AST_BINARY_OP:
+            compile_binary(unit, node);
+            break;
+        default:
+            if (is_user_call(node)) {
+                compile_call(unit, node, 0);
+            } else {
+                unit->ok = 0;
+            }
+            break;
+    }
+}
+
+static void compile_block(JitUnit* unit, ASTNode* node) {
+    int scope = unit->variable_count;
+    for (int i = 0; i < node->child_count && unit->ok; i++) {
+        compile_statement(unit, ast_get_child(node, i));
+    }
+    unit->variable_count = scope;
+}
+
+static void compile_assignment(JitUnit* unit, ASTNode* node) {
+    int offset;
+    ASTNode* value = ast_get_child(node, 1);
+    if (!find_variable(unit, ast_get_child(node, 0)->name_id, &offset) || value->data_type != TYPE_INTEIRO) {
+        unit->ok = 0;
+        return;
+    }
+    compile_expression(unit, value);
+    store_local(unit, offset);
+}
+
+/* Condição em %eax; salta para o rótulo se falsa */
+static void compile_condition(JitUnit* unit, ASTNode* node, int false_label) {
+    compile_expression(unit, node);
+    PUT(unit, 0x85, 0xC0);                                          /* test eax, eax */
+    jump_if_zero(unit, false_label);
+}
+
+/* Laço a partir da condição; no para, o incremento vem depois do corpo */
+static void compile_loop(JitUnit* unit, ASTNode* condition, ASTNode* body, ASTNode* step, int end_label) {
+    int condition_label = new_label(unit);
+    bind_label(unit, condition_label);
+    compile_condition(unit, condition, end_label);
+    compile_block(unit, body);
+    if (step) compile_assignment(unit, step);
+    jump(unit, condition_label);
+}
+
+static void compile_return(JitUnit* unit, ASTNode* node) {
+    ASTNode* value = node->child_count > 0 ? ast_get_child(node, 0) : NULL;
+    if (!value || value->data_type != TYPE_INTEIRO) {
+        unit->ok = 0;
+        return;
+    }
+
+    int tail = node->data.return_stmt.tail_call && is_user_call(value);
+    if (tail && !unit->is_loop) {
+        /* Cauda a si mesma: argumentos nos parâmetros e salto ao corpo.
+         * Cauda a outra função cresceria a pilha nativa, que o
+         * interpretador não cresce */
+        if (find_function(unit->jit, value->name_id) != unit->function) {
+            unit->ok = 0;
+            return;
+        }
+        const ASTNode* function = unit->jit->functions[unit->function];
+        for (int i = 0; i < value->child_count; i++) {
+            ASTNode* arg = ast_get_child(value, i);
+            if (arg->data_type != TYPE_INTEIRO) {
+                unit->ok = 0;
+                return;
+            }
+            compile_expression(unit, arg);
+            push_eax(unit);
+        }
+        for (int i = value->child_count - 1; i >= 0; i--) {
+            int offset;
+            PUT(unit, 0x58);                                        /* pop rax */
+            if (!find_variable(unit, function->data.function->params[i].name_id, &offset)) {
+                unit->ok = 0;
+                return;
+            }
+            store_local(unit, offset);
+        }
+        jump(unit, unit->body_label);
+        return;
+    }
+
+    if (tail) {
+        compile_call(unit, value, 1);
+    } else {
+        compile_expression(unit, value);
+    }
+
+    if (unit->is_loop) {
+        load_state(unit);
+        PUT(unit, 0xC7, 0x47, (unsigned char)offsetof(JitState, returned));   /* mov dword [rdi+r], 1 */
+        put32(unit, 1);
+        jump(unit, unit->exit_label);
+    } else {
+        leave_return(unit);
+    }
+}
+
+static void compile_statement(JitUnit* unit, ASTNode* node) {
+    if (!unit->ok) return;
+
+    switch (node->type) {
+        case AST_VAR_DECL: {
+            ASTNode* init = node->child_count > 0 ? ast_get_child(node, 0) : NULL;
+            if (node->data.var_decl.var_type != TYPE_INTEIRO || !init) {
+                unit->ok = 0;
+                return;
+            }
+            compile_expression(unit, init);
+            int offset = alloc_slot(unit);
+            store_local(unit, offset);
+            declare_variable(unit, node->name_id, offset);
+            break;
+        }
+
+        case AST_ASSIGNMENT:
+            compile_assignment(unit, node);
+            break;
+
+        case AST_FUNCTION_CALL:
+            if (is_user_call(node)) {
+                compile_call(unit, node, 0);
+            } else {
+                unit->ok = 0;
+            }
+            break;
+
+        case AST_IF_STMT: {
+            int else_label = new_label(unit);
+            int end_label = new_label(unit);
+            compile_condition(unit, ast_get_child(node, 0), else_label);
+            compile_block(unit, ast_get_child(node, 1));
+            jump(unit, end_label);
+            bind_label(unit, else_label);
+            if (node->child_count > 2) compile_block(unit, ast_get_child(node, 2));
+            bind_label(unit, end_label);
+            break;
+        }
+
+        case AST_FOR_STMT: {
+            int end_label = new_label(unit);
+            compile_assignment(unit, ast_get_child(node, 0));
+            compile_loop(unit, ast_get_child(node, 1), ast_get_child(node, 3), ast_get_child(node, 2), end_label);
+            bind_label(unit, end_label);
+            break;
+        }
+
+        case AST_WHILE_STMT: {
+            int end_label = new_label(unit);
+            compile_loop(unit, ast_get_child(node, 0), ast_get_child(node, 1), NULL, end_label);
+            bind_label(unit, end_label);
+            break;
+        }
+
+        case AST_RETURN_STMT:
+            compile_return(unit, node);
+            break;
+
+        case AST_BLOCK:
+            compile_block(unit, node);
+            break;
+
+        default:
+            unit->ok = 0;
+            break;
+    }
+}
+
+/* ================================
+   UNIDADES
+   ================================ */
+
+static int unit_init(JitUnit* unit, JitCompiler* jit, int function, int is_loop) {
+    memset(unit, 0, sizeof(JitUnit));
+    unit->jit = jit;
+    unit->function = function;
+    unit->is_loop = is_loop;
+    unit->ok = 1;
+    unit->callees = (unsigned char*)MEMORY_ALLOC(g_memory_manager, (size_t)jit->function_count + 1);
+    if (!unit->callees) return 0;
+    memset(unit->callees, 0, (size_t)jit->function_count + 1);
+
+    unit->fail_label = new_label(unit);
+    unit->exit_label = new_label(unit);
+    unit->division_label = new_label(unit);
+    unit->depth_label = new_label(unit);
+    unit->body_label = new_label(unit);
+
+    /* push rbp; mov rbp, rsp; sub rsp, quadro; mov [rbp-8], rdi */
+    PUT(unit, 0x55, 0x48, 0x89, 0xE5, 0x48, 0x81, 0xEC);
+    unit->frame_patch = unit->size;
+    put32(unit, 0);
+    PUT(unit, 0x48, 0x89, 0xBD);
+    put32(unit, JIT_STATE_SLOT);
+    return unit->ok;
+}
+
+static void unit_free(JitUnit* unit) {
+    if (unit->code) memory_free(g_memory_manager, unit->code);
+    if (unit->labels) memory_free(g_memory_manager, unit->labels);
+    if (unit->fixups) memory_free(g_memory_manager, unit->fixups);
+    if (unit->variables) memory_free(g_memory_manager, unit->variables);
+    if (unit->callees) memory_free(g_memory_manager, unit->callees);
+    memset(unit, 0, sizeof(JitUnit));
+}
+
+/* Saídas de erro, tamanho do quadro e saltos */
+static int unit_finish(JitUnit* unit) {
+    bind_label(unit, unit->division_label);
+    set_error(unit, JIT_ERROR_DIVISION);
+    bind_label(unit, unit->depth_label);
+    set_error(unit, JIT_ERROR_DEPTH);
+    bind_label(unit, unit->fail_label);
+    if (unit->is_loop) {
+        jump(unit, unit->exit_label);
+    } else {
+        bind_label(unit, unit->exit_label);
+        leave_return(unit);
+    }
+
+    if (unit->ok) {
+        patch32(unit, unit->frame_patch, (-JIT_VALUES_SLOT + unit->frame_size + 15) & ~15);
+    }
+    resolve_labels(unit);
+    return unit->ok;
+}
+
+static int build_function(JitUnit* unit, JitCompiler* jit, int index) {
+    static const unsigned char stores[JIT_MAX_ARGS][3] = {
+        {0x89, 0xB5, 0}, {0x89, 0x95, 0}, {0x89, 0x8D, 0}, {0x44, 0x89, 0x85}, {0x44, 0x89, 0x8D}
+    };
+    ASTNode* function = jit->functions[index];
+    memset(unit, 0, sizeof(JitUnit));
+    if (!signature_supported(jit, index) || function->child_count == 0 ||
+        !always_returns(ast_get_child(function, 0))) {
+        return 0;
+    }
+    if (!unit_init(unit, jit, index, 0)) return 0;
+
+    /* Parâmetros dos registradores para o quadro: mov [rbp+d], esi..r9d */
+    for (int i = 0; i < function->data.function->param_count; i++) {
+        int offset = alloc_slot(unit);
+        put(unit, stores[i], stores[i][0] == 0x44 ? 3 : 2);
+        put32(unit, offset);
+        declare_variable(unit, function->data.function->params[i].name_id, offset);
+    }
+
+    bind_label(unit, unit->body_label);
+    compile_statement(unit, ast_get_child(function, 0));
+    return unit_finish(unit);
+}
+
+/* Variáveis lidas ou escritas no laço e declaradas fora dele */
+static void collect_inputs(struct JitLoop* loop, ASTNode* node, InternId* declared, int* declared_count, int* ok) {
+    if (!*ok) return;
+
+    if (node->type == AST_IDENTIFIER) {
+        for (int i = *declared_count - 1; i >= 0; i--) {
+            if (declared[i] == node->name_id) return;
+        }
+        for (int i = 0; i < loop->input_count; i++) {
+            if (loop->inputs[i] == node->name_id) return;
+        }
+        if (loop->input_count >= JIT_MAX_LOOP_VARS) {
+            *ok = 0;
+            return;
+        }
+        loop->inputs[loop->input_count++] = node->name_id;
+        return;
+    }
+
+    int scope = *declared_count;
+    for (int i = 0; i < node->child_count; i++) {
+        collect_inputs(loop, ast_get_child(node, i), declared, declared_count, ok);
+    }
+    if (node->type == AST_BLOCK) *declared_count = scope;
+    if (node->type == AST_VAR_DECL) {
+        if (*declared_count >= JIT_MAX_LOOP_VARS) {
+            *ok = 0;
+            return;
+        }
+        declared[(*declared_count)++] = node->name_id;
+    }
+}
+
+static int build_loop(JitUnit* unit, JitCompiler* jit, int function, struct JitLoop* loop) {
+    ASTNode* node = (ASTNode*)loop->node;
+    InternId declared[JIT_MAX_LOOP_VARS];
+    int declared_count = 0;
+    int ok = 1;
+
+    memset(unit, 0, sizeof(JitUnit));
+
+    for (int i = node->type == AST_FOR_STMT ? 1 : 0; i < node->child_count; i++) {
+        collect_inputs(loop, ast_get_child(node, i), declared, &declared_count, &ok);
+    }
+    if (!ok || !unit_init(unit, jit, function, 1)) return 0;
+
+    /* mov [rbp-16], rsi; variáveis externas para o quadro */
+    PUT(unit, 0x48, 0x89, 0xB5);
+    put32(unit, JIT_VALUES_SLOT);
+    int offsets[JIT_MAX_LOOP_VARS];
+    for (int i = 0; i < loop->input_count; i++) {
+        offsets[i] = alloc_slot(unit);
+        PUT(unit, 0x8B, 0x86);                                      /* mov eax, [rsi+4i] */
+        put32(unit, 4 * i);
+        store_local(unit, offsets[i]);
+        declare_variable(unit, loop->inputs[i], offsets[i]);
+    }
+
+    if (node->type == AST_FOR_STMT) {
+        compile_loop(unit, ast_get_child(node, 1), ast_get_child(node, 3), ast_get_child(node, 2), unit->exit_label);
+    } else {
+        compile_loop(unit, ast_get_child(node, 0), ast_get_child(node, 1), NULL, unit->exit_label);
+    }
+
+    /* Saída: variáveis externas de volta (o resultado de retorno fica em eax) */
+    bind_label(unit, unit->exit_label);
+    load_values(unit);
+    for (int i = 0; i < loop->input_count; i++) {
+        PUT(unit, 0x8B, 0x8D);                                      /* mov ecx, [rbp+d] */
+        put32(unit, offsets[i]);
+        PUT(unit, 0x89, 0x8E);                                      /* mov [rsi+4i], ecx */
+        put32(unit, 4 * i);
+    }
+    leave_return(unit);
+    return unit_finish(unit);
+}
+
+/* ================================
+   INSTALAÇÃO
+   ================================ */
+
+/* Copiar as unidades para uma região nova, que deixa de ser gravável
+ * antes de executar; devolve o endereço de cada unidade em entries */
+static int install_units(JitCompiler* jit, JitUnit* units, int count, void** entries) {
+    size_t total = 0;
+    for (int i = 0; i < count; i++) total += (units[i].size + 15) & ~(size_t)15;
+    size_t size = (total + jit->page_size - 1) & ~(jit->page_size - 1);
+
+    if (jit->mapping_count >= jit->mapping_capacity) {
+        int capacity = jit->mapping_capacity ? jit->mapping_capacity * 2 : 8;
+        JitMapping* mappings = (JitMapping*)MEMORY_REALLOC(g_memory_manager, jit->mappings,
+                                                           (size_t)capacity * sizeof(JitMapping));
+        if (!mappings) return 0;
+        jit->mappings = mappings;
+        jit->mapping_capacity = capacity;
+    }
+
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return 0;
+
+    size_t offset = 0;
+    for (int i = 0; i < count; i++) {
+        memcpy((unsigned char*)memory + offset, units[i].code, units[i].size);
+        entries[i] = (unsigned char*)memory + offset;
+        offset += (units[i].size + 15) & ~(size_t)15;
+    }
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        return 0;
+    }
+
+    jit->mappings[jit->mapping_count].address = memory;
+    jit->mappings[jit->mapping_count].size = size;
+    jit->mapping_count++;
+    jit->code_bytes += total;
+    return 1;
+}
+
+/* Compilar as funções chamadas ainda não compiladas (e as que elas
+ * chamam) e instalar tudo junto com a unidade inicial, se houver.
+ * Qualquer recusa descarta o lote: nenhuma entrada fica apontando para
+ * função ausente */
+static int compile_batch(JitCompiler* jit, JitUnit* first, void** first_entry) {
+    int capacity = jit->function_count + 1;
+    JitUnit* units = (JitUnit*)MEMORY_ALLOC(g_memory_manager, (size_t)capacity * sizeof(JitUnit));
+    int* indices = (int*)MEMORY_ALLOC(g_memory_manager, (size_t)capacity * sizeof(int));
+    void** entries = (void**)MEMORY_ALLOC(g_memory_manager, (size_t)capacity * sizeof(void*));
+    unsigned char* queued = (unsigned char*)MEMORY_ALLOC(g_memory_manager, (size_t)capacity);
+    int ok = units && indices && entries && queued;
+    int count = 0;
+
+    if (ok) {
+        memset(queued, 0, (size_t)capacity);
+        units[count] = *first;
+        indices[count++] = first->is_loop ? -1 : first->function;
+        if (!first->is_loop) queued[first->function] = 1;
+    }
+
+    /* Fecho das chamadas, em largura */
+    for (int next = 0; ok && next < count; next++) {
+        for (int callee = 0; callee < jit->function_count && ok; callee++) {
+            if (!units[next].callees[callee] || queued[callee]) continue;
+            queued[callee] = 1;
+            if (jit->state[callee] == JIT_COMPILED) continue;
+            if (jit->state[callee] == JIT_REJECTED ||
+                !build_function(&units[count], jit, callee)) {
+                if (units[count].callees) unit_free(&units[count]);
+                jit->state[callee] = JIT_REJECTED;
+                jit->functions_rejected++;
+                ok = 0;
+                break;
+            }
+            indices[count++] = callee;
+        }
+    }
+
+    if (ok) ok = install_units(jit, units, count, entries);
+    if (ok) {
+        *first_entry = entries[0];
+        for (int i = 0; i < count; i++) {
+            if (indices[i] < 0) continue;
+            jit->entries[indices[i]] = entries[i];
+            jit->state[indices[i]] = JIT_COMPILED;
+            jit->functions_compiled++;
+        }
+    }
+
+    /* A unidade inicial é liberada por quem chamou */
+    for (int i = 1; i < count; i++) unit_free(&units[i]);
+    if (units) memory_free(g_memory_manager, units);
+    if (indices) memory_free(g_memory_manager, indices);
+    if (entries) memory_free(g_memory_manager, entries);
+    if (queued) memory_free(g_memory_manager, queued);
+    return ok;
+}
+
+/* ================================
+   INTERFACE
+   ================================ */
+
+/* JIT para as funções do programa. NULL se a plataforma não é x86-64 */
+JitCompiler* jit_create(ASTNode** functions, int count) {
+#if defined(__x86_64__)
+    JitCompiler* jit = (JitCompiler*)MEMORY_ALLOC(g_memory_manager, sizeof(JitCompiler));
+    if (!jit) return NULL;
+    memset(jit, 0, sizeof(JitCompiler));
+
+    jit->functions = functions;
+    jit->function_count = count;
+    long page = sysconf(_SC_PAGESIZE);
+    jit->page_size = page > 0 ? (size_t)page : 4096;
+    jit->state = (signed char*)MEMORY_ALLOC(g_memory_manager, (size_t)count + 1);
+    jit->entries = (void**)MEMORY_ALLOC(g_memory_manager, ((size_t)count + 1) * sizeof(void*));
+    if (!jit->state || !jit->entries) {
+        jit_destroy(jit);
+        return NULL;
+    }
+    memset(jit->state, JIT_NOT_TRIED, (size_t)count + 1);
+    memset(jit->entries, 0, ((size_t)count + 1) * sizeof(void*));
+    return jit;
+#else
+    (void)functions;
+    (void)count;
+    return NULL;
+#endif
+}
+
+void jit_destroy(JitCompiler* jit) {
+    if (!jit) return;
+    for (int i = 0; i < jit->mapping_count; i++) {
+        munmap(jit->mappings[i].address, jit->mappings[i].size);
+    }
+    if (jit->mappings) memory_free(g_memory_manager, jit->mappings);
+    if (jit->loops) memory_free(g_memory_manager, jit->loops);
+    if (jit->state) memory_free(g_memory_manager, jit->state);
+    if (jit->entries) memory_free(g_memory_manager, jit->entries);
+    memory_free(g_memory_manager, jit);
+}
+
+int jit_function_ready(const JitCompiler* jit, int index) {
+    return jit && jit->state[index] == JIT_COMPILED;
+}
+
+/* Compilar a função e as que ela chama; tentada uma vez só */
+int jit_compile_function(JitCompiler* jit, int index) {
+    if (!jit || index < 0 || index >= jit->function_count) return 0;
+    if (jit->state[index] != JIT_NOT_TRIED) return jit->state[index] == JIT_COMPILED;
+
+    JitUnit unit;
+    void* entry = NULL;
+    int ok = build_function(&unit, jit, index) && compile_batch(jit, &unit, &entry);
+    if (unit.callees) unit_free(&unit);
+    if (!ok && jit->state[index] == JIT_NOT_TRIED) {
+        jit->state[index] = JIT_REJECTED;
+        jit->functions_rejected++;
+    }
+    return ok;
+}
+
+/* Executar função compilada; 0 se terminou em erro (código em state) */
+int jit_call(JitCompiler* jit, int index, const int32_t* args, JitState* state, int32_t* result) {
+    int32_t values[JIT_MAX_ARGS] = {0};
+    int count = jit->functions[index]->data.function->param_count;
+    for (int i = 0; i < count; i++) values[i] = args[i];
+
+    JitFunctionCode code;
+    memcpy(&code, &jit->entries[index], sizeof(code));
+    jit->native_calls++;
+    *result = code(state, values[0], values[1], values[2], values[3], values[4]);
+    return state->error == JIT_ERROR_NONE;
+}
+
+/* Laço compilado para o nó, compilando na primeira vez; NULL se recusado */
+const JitLoop* jit_compile_loop(JitCompiler* jit, int function, ASTNode* node) {
+    if (!jit) return NULL;
+    for (int i = 0; i < jit->loop_count; i++) {
+        if (jit->loops[i].node == node) return jit->loops[i].entry ? &jit->loops[i] : NULL;
+    }
+
+    if (jit->loop_count >= jit->loop_capacity) {
+        int capacity = jit->loop_capacity ? jit->loop_capacity * 2 : 8;
+        struct JitLoop* loops = (struct JitLoop*)MEMORY_REALLOC(g_memory_manager, jit->loops,
+                                                                (size_t)capacity * sizeof(struct JitLoop));
+        if (!loops) return NULL;
+        jit->loops = loops;
+        jit->loop_capacity = capacity;
+    }
+
+    struct JitLoop* loop = &jit->loops[jit->loop_count++];
+    memset(loop, 0, sizeof(struct JitLoop));
+    loop->node = node;
+
+    JitUnit unit;
+    int ok = build_loop(&unit, jit, function, loop) && compile_batch(jit, &unit, &loop->entry);
+    if (unit.callees) unit_free(&unit);
+    if (!ok) {
+        loop->entry = NULL;
+        jit->loops_rejected++;
+        return NULL;
+    }
+    jit->loops_compiled++;
+    return loop;
+}
+
+/* Variáveis externas que o laço lê e escreve, na ordem do vetor de valores */
+int jit_loop_inputs(const JitLoop* loop, const InternId** ids) {
+    *ids = loop->inputs;
+    return loop->input_count;
+}
+
+/* Continuar o laço no código nativo a partir da condição; values entra
+ * com as variáveis externas e sai com os valores finais */
+int jit_run_loop(JitCompiler* jit, const JitLoop* loop, int32_t* values, JitState* state, int32_t* result) {
+    JitLoopCode code;
+    memcpy(&code, &loop->entry, sizeof(code));
+    jit->native_loops++;
+    *result = code(state, values);
+    return state->error == JIT_ERROR_NONE;
+}
+
+const char* jit_error_message(int error) {
+    return error == JIT_ERROR_DEPTH ? "Profundidade máxima de chamadas excedida" : "Divisão por zero";
+}
+
+/* Estatísticas do JIT, se algo foi compilado ou recusado */
+void jit_report(const JitCompiler* jit) {
+    if (!jit || jit->functions_compiled + jit->functions_rejected +
+                jit->loops_compiled + jit->loops_rejected == 0) {
+        return;
+    }
+
+    printf("=== JIT ===\n");
+    printf("Funções compiladas: %d (recusadas: %d)\n", jit->functions_compiled, jit->functions_rejected);
+    printf("Laços compilados: %d (recusados: %d)\n", jit->loops_compiled, jit->loops_rejected);
+    printf("Entradas no código nativo: %ld chamadas, %ld laços\n", jit->native_calls, jit->native_loops);
+    printf("Código gerado: %zu bytes\n", jit->code_bytes);
+    printf("===========\n");
+}
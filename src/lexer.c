@@ -20,30 +20,72 @@ static const struct {
     {NULL, TOKEN_EOF}
 };
 
-/* Criar lexer */
-Lexer* lexer_create(const char* source) {
-    if (!source) return NULL;
+/* Criar lexer sobre os primeiros length bytes do fonte */
+static Lexer* lexer_create_n(const char* source, size_t length) {
+    /* Arena da fase léxica: lexer e cópia do fonte em um único bloco */
+    MemoryArena* arena = memory_arena_create(g_memory_manager, "lexer",
+                                             sizeof(Lexer) + length + 64);
+    if (!arena) {
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar lexer");
+        return NULL;
+    }
     
-    Lexer* lexer = (Lexer*)memory_alloc(g_memory_manager, sizeof(Lexer));
+    Lexer* lexer = (Lexer*)memory_arena_alloc(arena, sizeof(Lexer));
     if (!lexer) {
+        memory_arena_destroy(arena);
         error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar lexer");
         return NULL;
     }
     
-    lexer->source = string_duplicate(source);
+    lexer->arena = arena;
+    lexer->source = (char*)memory_arena_alloc(arena, length + 1);
     if (!lexer->source) {
-        memory_free(g_memory_manager, lexer);
+        memory_arena_destroy(arena);
         error_report(ERROR_MEMORY, 0, 0, "Falha ao duplicar código fonte");
         return NULL;
     }
     
+    memcpy(lexer->source, source, length);
+    lexer->source[length] = '\0';
     lexer->pos = 0;
     lexer->line = 1;
     lexer->column = 1;
-    lexer->length = strlen(source);
+    lexer->length = (int)length;
+    lexer->offset = 0;
     lexer->error_count = 0;
     lexer->input = NULL;
     
+    /* Limites configuráveis, contidos pela capacidade de Token.value: um
+     * literal cabe num token, mesmo que --max-string permita strings maiores
+     * em execução. Tokens mais longos viram erro léxico */
+    lexer->max_token_length = g_config.max_token_length;
+    if (lexer->max_token_length < 2 || lexer->max_token_length > MAX_TOKEN_LENGTH) {
+        lexer->max_token_length = MAX_TOKEN_LENGTH;
+    }
+    lexer->max_string_length = g_config.max_string_length;
+    if (lexer->max_string_length < 2 || lexer->max_string_length > lexer->max_token_length) {
+        lexer->max_string_length = lexer->max_token_length;
+    }
+    
+    return lexer;
+}
+
+/* Criar lexer */
+Lexer* lexer_create(const char* source) {
+    if (!source) return NULL;
+    return lexer_create_n(source, strlen(source));
+}
+
+/* Criar lexer para um trecho do fonte, com a posição de origem do trecho */
+Lexer* lexer_create_range(const char* source, const SourceRange* range) {
+    if (!source || !range || range->end < range->start) return NULL;
+    
+    Lexer* lexer = lexer_create_n(source + range->start, (size_t)(range->end - range->start));
+    if (!lexer) return NULL;
+    
+    lexer->offset = range->start;
+    lexer->line = range->line;
+    lexer->column = range->column;
     return lexer;
 }
 
@@ -51,15 +93,12 @@ Lexer* lexer_create(const char* source) {
 void lexer_destroy(Lexer* lexer) {
     if (!lexer) return;
     
-    if (lexer->source) {
-        memory_free(g_memory_manager, lexer->source);
-    }
-    
     if (lexer->input) {
         fclose(lexer->input);
     }
     
-    memory_free(g_memory_manager, lexer);
+    /* Lexer e fonte vivem na arena da fase */
+    memory_arena_destroy(lexer->arena);
 }
 
 /* Caractere atual */
@@ -120,6 +159,128 @@ void lexer_skip_comment(Lexer* lexer) {
     }
 }
 
+/* Pular espaços e comentários */
+static void skip_blank(Lexer* lexer) {
+    while (lexer->pos < lexer->length) {
+        lexer_skip_whitespace(lexer);
+        if (current_char(lexer) == '/' && peek_char(lexer, 1) == '/') {
+            lexer_skip_comment(lexer);
+        } else {
+            break;
+        }
+    }
+}
+
+/* Avançar um caractere do fonte, saltando comentários e strings inteiros.
+ * Retorna o caractere consumido ou 0 se foi um comentário ou string. */
+static char advance_structural(Lexer* lexer) {
+    char c = current_char(lexer);
+    if (c == '/' && peek_char(lexer, 1) == '/') {
+        lexer_skip_comment(lexer);
+        return 0;
+    }
+    
+    advance(lexer);
+    if (c != '"') return c;
+    
+    while (lexer->pos < lexer->length && current_char(lexer) != '"' &&
+           current_char(lexer) != '\n') {
+        advance(lexer);
+    }
+    if (current_char(lexer) == '"') advance(lexer);
+    return 0;
+}
+
+/* Consumir até depois da chave que fecha um bloco já aberto */
+static int skip_to_closing_brace(Lexer* lexer) {
+    int depth = 1;
+    while (lexer->pos < lexer->length) {
+        char c = advance_structural(lexer);
+        if (c == '{') {
+            depth++;
+        } else if (c == '}' && --depth == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Pular o bloco cujo '{' é o token atual sem gerar tokens. A faixa do bloco,
+ * com as chaves, vai para *range (posições no fonte original) e o token
+ * atual passa a ser o seguinte ao '}'. Retorna 0 se a chave não fecha. */
+int lexer_skip_block(Lexer* lexer, SourceRange* range) {
+    if (!lexer || !range || lexer->current_token.type != TOKEN_ABRE_CHAVE) return 0;
+    
+    /* O token atual acabou de ser lido: o cursor está logo após o '{' */
+    range->start = lexer->offset + lexer->pos - 1;
+    range->line = lexer->current_token.line;
+    range->column = lexer->current_token.column;
+    
+    if (!skip_to_closing_brace(lexer)) return 0;
+    
+    range->end = lexer->offset + lexer->pos;
+    lexer->current_token = lexer_next_token(lexer);
+    return 1;
+}
+
+/* Pré-varredura: delimitar definições de nível superior pelo casamento de
+ * chaves, ignorando chaves em strings e comentários. Cada faixa vai do
+ * primeiro caractere da definição até a chave que a fecha. Retorna a
+ * quantidade de faixas (em *ranges, liberar com memory_free) ou -1 se as
+ * chaves não fecham; o estado do lexer não é alterado. */
+int lexer_scan_top_level(Lexer* lexer, SourceRange** ranges) {
+    if (!lexer || !ranges) return -1;
+    *ranges = NULL;
+    
+    Lexer cursor = *lexer;
+    SourceRange* items = NULL;
+    int count = 0;
+    int capacity = 0;
+    
+    for (;;) {
+        skip_blank(&cursor);
+        if (cursor.pos >= cursor.length) break;
+        
+        SourceRange range;
+        range.start = cursor.pos;
+        range.line = cursor.line;
+        range.column = cursor.column;
+        
+        /* Consumir até fechar a primeira chave aberta */
+        int closed = 0;
+        while (cursor.pos < cursor.length) {
+            char c = advance_structural(&cursor);
+            if (c == '}') break;
+            if (c == '{') {
+                closed = skip_to_closing_brace(&cursor);
+                break;
+            }
+        }
+        
+        if (!closed) {
+            if (items) memory_free(g_memory_manager, items);
+            return -1;
+        }
+        range.end = cursor.pos;
+        
+        if (count >= capacity) {
+            int new_capacity = capacity == 0 ? 16 : capacity * 2;
+            SourceRange* grown = (SourceRange*)MEMORY_REALLOC(g_memory_manager, items,
+                                                              (size_t)new_capacity * sizeof(SourceRange));
+            if (!grown) {
+                if (items) memory_free(g_memory_manager, items);
+                return -1;
+            }
+            items = grown;
+            capacity = new_capacity;
+        }
+        items[count++] = range;
+    }
+    
+    *ranges = items;
+    return count;
+}
+
 /* Verificar se string é palavra-chave */
 int lexer_is_keyword(const char* str) {
     for (int i = 0; keywords[i].word != NULL; i++) {
@@ -140,6 +301,14 @@ TokenType lexer_get_keyword_type(const char* str) {
     return TOKEN_UNKNOWN;
 }
 
+/* Token mais longo que o limite: erro, em vez de cortá-lo em silêncio */
+static Token length_error(Lexer* lexer, Token token, const char* what, int limit, const char* option) {
+    token.type = TOKEN_ERROR;
+    snprintf(token.value, MAX_TOKEN_LENGTH, "%s excede %d caracteres (limite de %s)", what, limit, option);
+    lexer->error_count++;
+    return token;
+}
+
 /* Ler identificador (variável ou função) */
 static Token read_identifier(Lexer* lexer) {
     Token token;
@@ -187,19 +356,19 @@ static Token read_identifier(Lexer* lexer) {
     int i = 0;
     
     /* Copiar prefixo */
-    for (int j = start_pos; j < lexer->pos && i < MAX_TOKEN_LENGTH - 1; j++) {
+    for (int j = start_pos; j < lexer->pos && i < lexer->max_token_length - 1; j++) {
         buffer[i++] = lexer->source[j];
     }
     
     /* Ler caracteres alfanuméricos */
-    while (lexer->pos < lexer->length && i < MAX_TOKEN_LENGTH - 1) {
+    while (lexer->pos < lexer->length) {
         c = current_char(lexer);
-        if (isalnum(c)) {
-            buffer[i++] = c;
-            advance(lexer);
-        } else {
-            break;
+        if (!isalnum(c)) break;
+        if (i >= lexer->max_token_length - 1) {
+            return length_error(lexer, token, "Identificador", lexer->max_token_length - 1, "--max-token");
         }
+        buffer[i++] = c;
+        advance(lexer);
     }
     
     buffer[i] = '\0';
@@ -233,9 +402,12 @@ static Token read_number(Lexer* lexer) {
     int has_dot = 0;
     
     /* Ler dígitos e ponto decimal */
-    while (lexer->pos < lexer->length && i < MAX_TOKEN_LENGTH - 1) {
+    while (lexer->pos < lexer->length) {
         char c = current_char(lexer);
         
+        if ((isdigit(c) || c == '.') && i >= lexer->max_token_length - 1) {
+            return length_error(lexer, token, "Número", lexer->max_token_length - 1, "--max-token");
+        }
         if (isdigit(c)) {
             buffer[i++] = c;
             advance(lexer);
@@ -271,14 +443,14 @@ static Token read_string(Lexer* lexer) {
     token.line = lexer->line;
     token.column = lexer->column;
     
-    char buffer[MAX_STRING_LENGTH];
+    char buffer[MAX_TOKEN_LENGTH];
     int i = 0;
     
     /* Pular aspas inicial */
     advance(lexer);
     
     /* Ler até aspas final */
-    while (lexer->pos < lexer->length && i < MAX_STRING_LENGTH - 1) {
+    while (lexer->pos < lexer->length) {
         char c = current_char(lexer);
         
         if (c == '"') {
@@ -294,6 +466,9 @@ static Token read_string(Lexer* lexer) {
             snprintf(token.value, MAX_TOKEN_LENGTH, "String não fechada - quebra de linha encontrada");
             lexer->error_count++;
             return token;
+        } else if (i >= lexer->max_string_length - 1) {
+            return length_error(lexer, token, "String", lexer->max_string_length - 1,
+                                lexer->max_string_length < lexer->max_token_length ? "--max-string" : "--max-token");
         } else {
             buffer[i++] = c;
             advance(lexer);
@@ -307,19 +482,12 @@ static Token read_string(Lexer* lexer) {
     return token;
 }
 
-/* Próximo token */
-Token lexer_next_token(Lexer* lexer) {
+/* Reconhecer próximo token */
+static Token scan_token(Lexer* lexer) {
     Token token;
     
     /* Pular espaços e comentários */
-    while (lexer->pos < lexer->length) {
-        lexer_skip_whitespace(lexer);
-        if (current_char(lexer) == '/' && peek_char(lexer, 1) == '/') {
-            lexer_skip_comment(lexer);
-        } else {
-            break;
-        }
-    }
+    skip_blank(lexer);
     
     /* Verificar fim de arquivo */
     if (lexer->pos >= lexer->length) {
@@ -435,6 +603,19 @@ Token lexer_next_token(Lexer* lexer) {
     return token;
 }
 
+/* Próximo token; identificadores saem já internados */
+Token lexer_next_token(Lexer* lexer) {
+    Token token = scan_token(lexer);
+    
+    if (token.type == TOKEN_VARIAVEL || token.type == TOKEN_FUNCAO_ID) {
+        token.id = intern_string(token.value);
+    } else {
+        token.id = INTERN_NONE;
+    }
+    
+    return token;
+}
+
 /* Espiar próximo token sem consumir */
 Token lexer_peek_token(Lexer* lexer) {
     /* Salvar estado atual */
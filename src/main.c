@@ -8,6 +8,7 @@ void test_lexer(const char* source_code) {
     printf("=== TOKENS GERADOS ===\n");
     
     /* Criar lexer */
+    memory_set_phase(g_memory_manager, "teste_lexico");
     Lexer* lexer = lexer_create(source_code);
     if (!lexer) {
         fprintf(stderr, "Erro ao criar lexer\n");
@@ -44,6 +45,7 @@ void test_lexer(const char* source_code) {
 void test_parser(const char* source_code) {
     printf("=== TESTANDO ANALISADOR SINTÁTICO ===\n");
     printf("Código fonte:\n%s\n", source_code);
+    memory_set_phase(g_memory_manager, "teste_sintatico");
     
     /* Criar lexer */
     Lexer* lexer = lexer_create(source_code);
@@ -61,7 +63,8 @@ void test_parser(const char* source_code) {
     }
     
     /* Analisar código */
-    ASTNode* ast = parser_parse(parser);
+    FlatAST* program = parser_parse(parser);
+    ASTNode* ast = flat_ast_root(program);
     
     /* Imprimir resultados da análise sintática */
     printf("=== ESTATÍSTICAS SINTÁTICAS ===\n");
@@ -83,9 +86,8 @@ void test_parser(const char* source_code) {
         } else {
             printf("Erros semânticos encontrados.\n");
         }
-
-        ast_destroy(ast);
     }
+    flat_ast_destroy(program);
     
     /* Limpar */
     parser_destroy(parser);
@@ -97,6 +99,7 @@ void test_parser(const char* source_code) {
 void test_interpreter(const char* source_code) {
     printf("=== TESTANDO INTERPRETADOR ===\n");
     printf("Código fonte:\n%s\n", source_code);
+    memory_set_phase(g_memory_manager, "teste_interpretador");
     
     /* Criar lexer */
     Lexer* lexer = lexer_create(source_code);
@@ -113,23 +116,25 @@ void test_interpreter(const char* source_code) {
         return;
     }
     
-    /* Analisar código */
-    ASTNode* ast = parser_parse(parser);
+    /* Analisar código (já na AST plana) */
+    FlatAST* program = parser_parse(parser);
+    parser_release_tree(parser);
 
-    if (lexer->error_count > 0 || parser->error_count > 0 || !ast) {
+    if (lexer->error_count > 0 || parser->error_count > 0 || !program) {
         printf("Erro na análise sintática - não é possível executar\n");
+        flat_ast_destroy(program);
         parser_destroy(parser);
         lexer_destroy(lexer);
-        if (ast) ast_destroy(ast);
         return;
     }
+    ASTNode* ast = flat_ast_root(program);
 
     /* Análise semântica */
     int semantic_ok = semantic_analyze(ast, parser->symbol_table);
 
     if (!semantic_ok) {
         printf("Erro na análise semântica - não é possível executar\n");
-        ast_destroy(ast);
+        flat_ast_destroy(program);
         parser_destroy(parser);
         lexer_destroy(lexer);
         return;
@@ -139,7 +144,7 @@ void test_interpreter(const char* source_code) {
     Interpreter* interpreter = interpreter_create(ast, parser->symbol_table);
     if (!interpreter) {
         printf("Erro ao criar interpretador\n");
-        ast_destroy(ast);
+        flat_ast_destroy(program);
         parser_destroy(parser);
         lexer_destroy(lexer);
         return;
@@ -156,7 +161,7 @@ void test_interpreter(const char* source_code) {
     
     /* Limpar */
     interpreter_destroy(interpreter);
-    ast_destroy(ast);
+    flat_ast_destroy(program);
     parser_destroy(parser);
     lexer_destroy(lexer);
     
@@ -191,7 +196,7 @@ char* read_file(const char* filename) {
     }
     
     /* Alocar buffer usando gerenciador de memória */
-    char* content = (char*)memory_alloc(g_memory_manager, size + 1);
+    char* content = (char*)MEMORY_ALLOC(g_memory_manager, size + 1);
     if (!content) {
         fprintf(stderr, "Erro: Falha ao alocar memória para arquivo\n");
         fclose(file);
@@ -223,20 +228,96 @@ int main(int argc, char* argv[]) {
     printf("Versão: 1.0.0\n");
     printf("Desenvolvido seguindo especificações ISO/IEC 9899-1990\n\n");
     
+    /* Processar opções antes de qualquer alocação */
+    const char* source_path = NULL;
+    config_init_defaults(&g_config);
+    if (!config_load_env(&g_config)) {
+        return 1;
+    }
+    const char* profile_path = getenv(MEMORY_PROFILE_ENV);
+    const char* timeline_path = getenv(MEMORY_TIMELINE_ENV);
+    const char* native_dir = getenv(NATIVE_CACHE_ENV);
+    const char* native_backend = getenv(NATIVE_BACKEND_ENV);
+    int run_benchmark = 0;
+    int print_call_graph = 0;
+    int print_ir = 0;
+    int run_ir = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        int consumed = config_parse_option(&g_config, argv[i]);
+        if (consumed < 0) {
+            return 1;
+        } else if (consumed > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--perfil-heap") == 0) {
+            profile_path = MEMORY_PROFILE_DEFAULT_PATH;
+        } else if (strncmp(argv[i], "--perfil-heap=", 14) == 0) {
+            profile_path = argv[i] + 14;
+        } else if (strcmp(argv[i], "--linha-tempo") == 0) {
+            timeline_path = MEMORY_TIMELINE_DEFAULT_PATH;
+        } else if (strncmp(argv[i], "--linha-tempo=", 14) == 0) {
+            timeline_path = argv[i] + 14;
+        } else if (strcmp(argv[i], "--nativo") == 0) {
+            native_dir = NATIVE_CACHE_DEFAULT_DIR;
+        } else if (strncmp(argv[i], "--nativo=", 9) == 0) {
+            native_dir = argv[i] + 9;
+        } else if (strncmp(argv[i], "--gerador=", 10) == 0) {
+            native_backend = argv[i] + 10;
+        } else if (strcmp(argv[i], "--bench-memoria") == 0) {
+            run_benchmark = 1;
+        } else if (strcmp(argv[i], "--grafo-chamadas") == 0) {
+            print_call_graph = 1;
+        } else if (strcmp(argv[i], "--ir") == 0) {
+            print_ir = 1;
+        } else if (strcmp(argv[i], "--executar-ir") == 0) {
+            run_ir = 1;
+        } else if (!source_path) {
+            source_path = argv[i];
+        }
+    }
+    
+    /* Escolher o gerador nativo já implica compilação nativa */
+    if (native_backend && *native_backend) {
+        if (!native_backend_valid(native_backend)) {
+            fprintf(stderr, "Erro: Gerador nativo inválido '%s' (use c ou asm)\n", native_backend);
+            return 1;
+        }
+        if (!native_dir) native_dir = NATIVE_CACHE_DEFAULT_DIR;
+    } else {
+        native_backend = NATIVE_DEFAULT_BACKEND;
+    }
+    
+    if (run_benchmark) {
+        memory_benchmark(source_path ? atoi(source_path) : 0);
+        return 0;
+    }
+    
     /* Inicializar gerenciador de memória global */
-    g_memory_manager = memory_manager_create();
+    g_memory_manager = memory_manager_create_with_config(&g_config);
     if (!g_memory_manager) {
         fprintf(stderr, "ERRO CRÍTICO: Falha ao inicializar gerenciador de memória\n");
         return 1;
     }
     
+    /* Perfil de heap: tabela e pilhas dobradas no relatório final */
+    if (profile_path) {
+        memory_profile_enable(g_memory_manager, *profile_path ? profile_path : MEMORY_PROFILE_DEFAULT_PATH);
+    }
+    
+    /* Linha do tempo: uso de memória por fase, exportado na saída */
+    if (timeline_path) {
+        memory_timeline_enable(g_memory_manager, *timeline_path ? timeline_path : MEMORY_TIMELINE_DEFAULT_PATH);
+        memory_set_phase(g_memory_manager, "inicio");
+    }
+    
     /* Validar integridade da memória */
     memory_validate_integrity(g_memory_manager);
     
     /* Verificar argumentos */
-    if (argc < 2) {
-        printf("Uso: %s <arquivo_fonte>\n", argv[0]);
+    if (!source_path) {
+        printf("Uso: %s [--modo-memoria=off|stats|debug] [--perfil-heap[=arquivo]] [--linha-tempo[=arquivo]] [--grafo-chamadas] [--ir] [--nativo[=diretorio]] [--gerador=c|asm] <arquivo_fonte>\n", argv[0]);
         printf("Exemplo: %s examples/hello_world.txt\n", argv[0]);
+        config_print_usage();
         
         /* Executar teste básico */
         printf("\n=== EXECUTANDO TESTE BÁSICO ===\n");
@@ -256,26 +337,54 @@ int main(int argc, char* argv[]) {
         test_parser(test_code);
         test_interpreter(test_code);
         
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 0;
     }
     
     /* Ler arquivo fonte */
-    char* source_code = read_file(argv[1]);
+    char* source_code = read_file(source_path);
     if (!source_code) {
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 1;
     }
     
-    printf("Arquivo: %s\n", argv[1]);
+    printf("Arquivo: %s\n", source_path);
     printf("Tamanho: %zu bytes\n\n", strlen(source_code));
     
+    /* Backend nativo: fonte já compilado roda direto do cache, sem passar
+     * pelas fases de compilação */
+    NativeBuild native;
+    if (native_dir) {
+        if (!native_build_init(&native, *native_dir ? native_dir : NATIVE_CACHE_DEFAULT_DIR, native_backend, source_code)) {
+            memory_free(g_memory_manager, source_code);
+            intern_table_destroy();
+            memory_manager_destroy(g_memory_manager);
+            return 1;
+        }
+        if (native_build_cached(&native)) {
+            printf("Executável em cache: %s\n", native.executable);
+            if (native_execute(&native)) {
+                printf("COMPILAÇÃO E EXECUÇÃO CONCLUÍDAS COM SUCESSO!\n");
+            } else {
+                printf("Erro durante a execução.\n");
+            }
+            memory_free(g_memory_manager, source_code);
+            intern_table_destroy();
+            memory_manager_destroy(g_memory_manager);
+            return 0;
+        }
+    }
+    
     /* === Pipeline de compilação === */
 
     /* 1. Análise léxica */
+    memory_set_phase(g_memory_manager, "lexico");
     Lexer* lex = lexer_create(source_code);
     if (!lex) {
         memory_free(g_memory_manager, source_code);
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 1;
     }
@@ -285,10 +394,14 @@ int main(int argc, char* argv[]) {
         t = lexer_next_token(lex);
     } while (t.type != TOKEN_EOF && t.type != TOKEN_ERROR);
 
+    if (t.type == TOKEN_ERROR && lex->error_count > 0) {
+        error_report(ERROR_LEXICAL, t.line, t.column, t.value);
+    }
     if (lex->error_count > 0) {
         printf("Erro léxico encontrado. Abortando.\n");
         lexer_destroy(lex);
         memory_free(g_memory_manager, source_code);
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 1;
     }
@@ -296,9 +409,11 @@ int main(int argc, char* argv[]) {
     lexer_destroy(lex);
 
     /* 2. Análise sintática */
+    memory_set_phase(g_memory_manager, "sintatico");
     Lexer* lexer2 = lexer_create(source_code);
     if (!lexer2) {
         memory_free(g_memory_manager, source_code);
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 1;
     }
@@ -307,59 +422,137 @@ int main(int argc, char* argv[]) {
     if (!parser) {
         lexer_destroy(lexer2);
         memory_free(g_memory_manager, source_code);
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 1;
     }
 
-    ASTNode* ast = parser_parse(parser);
+    /* O parser monta direto a AST plana, em memória contígua */
+    FlatAST* program = parser_parse(parser);
+    parser_release_tree(parser);
 
-    if (lexer2->error_count > 0 || parser->error_count > 0 || !ast) {
+    if (lexer2->error_count > 0 || parser->error_count > 0 || !program) {
         printf("Erro sintático encontrado. Abortando.\n");
-        if (ast) ast_destroy(ast);
+        flat_ast_destroy(program);
         parser_destroy(parser);
         lexer_destroy(lexer2);
         memory_free(g_memory_manager, source_code);
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 1;
     }
+    ASTNode* ast = flat_ast_root(program);
 
     /* 3. Análise semântica */
+    memory_set_phase(g_memory_manager, "semantico");
     int semantic_ok = semantic_analyze(ast, parser->symbol_table);
     if (!semantic_ok) {
         printf("Erro semântico encontrado. Abortando.\n");
-        ast_destroy(ast);
+        flat_ast_destroy(program);
         parser_destroy(parser);
         lexer_destroy(lexer2);
         memory_free(g_memory_manager, source_code);
+        intern_table_destroy();
         memory_manager_destroy(g_memory_manager);
         return 1;
     }
 
-    /* 4. Execução */
-    Interpreter* interpreter = interpreter_create(ast, parser->symbol_table);
-    if (!interpreter) {
-        ast_destroy(ast);
-        parser_destroy(parser);
-        lexer_destroy(lexer2);
-        memory_free(g_memory_manager, source_code);
-        memory_manager_destroy(g_memory_manager);
-        return 1;
+    /* Grafo de chamadas: funções pequenas são expandidas nas chamadas e as
+     * que principal não alcança (inclusive por isso) são descartadas.
+     * Etapas opcionais: sem memória para reconstruir a AST, o programa
+     * segue com a última AST completa */
+    int out_of_memory = 0;
+    CallGraph* graph = call_graph_build(ast, &out_of_memory);
+    if (graph) {
+        if (print_call_graph) call_graph_print(graph);
+        
+        int expanded = 0;
+        FlatAST* inlined = inline_functions(graph, ast, &expanded, &out_of_memory);
+        if (inlined) {
+            flat_ast_destroy(program);
+            program = inlined;
+            ast = flat_ast_root(program);
+            call_graph_destroy(graph);
+            graph = call_graph_build(ast, &out_of_memory);
+            if (print_call_graph) printf("Chamadas expandidas: %d\n", expanded);
+        }
+    }
+    if (graph && !out_of_memory) {
+        FlatAST* pruned = call_graph_prune(graph, ast, &out_of_memory);
+        if (pruned) {
+            flat_ast_destroy(program);
+            program = pruned;
+            ast = flat_ast_root(program);
+        }
+    }
+    call_graph_destroy(graph);
+    if (out_of_memory) {
+        printf("AVISO: Memória insuficiente para otimizar as chamadas; executando o programa sem essas otimizações\n");
+    }
+
+    /* Representação intermediária: construída, otimizada e conferida para
+     * impressão (--ir) e para a execução pela IR (--executar-ir) */
+    IrModule* ir = NULL;
+    if (print_ir || run_ir) {
+        memory_set_phase(g_memory_manager, "ir");
+        ir = ir_build(ast);
+        IrPassManager* passes = ir ? ir_pass_manager_create() : NULL;
+        int ir_ok = passes && ir_pass_manager_add_defaults(passes);
+        if (ir_ok) {
+            ir_pass_manager_run(passes, ir);
+            ir_ok = ir_verify(ir);
+            if (ir_ok && print_ir) ir_print(ir, stdout);
+            if (print_ir) ir_pass_manager_report(passes, stdout);
+        }
+        ir_pass_manager_destroy(passes);
+        if (!ir_ok) {
+            ir_destroy(ir);
+            ir = NULL;
+        }
+    }
+
+    /* 4. Execução: interpretada, pela IR ou pelo executável nativo */
+    Interpreter* interpreter = NULL;
+    int exec_ok;
+    if (native_dir) {
+        memory_set_phase(g_memory_manager, "nativo");
+        exec_ok = native_build(&native, ast) && native_execute(&native);
+    } else if (run_ir) {
+        memory_set_phase(g_memory_manager, "execucao");
+        exec_ok = ir != NULL && ir_execute(ir);
+        if (!ir) printf("ERRO: Representação intermediária indisponível para execução\n");
+    } else {
+        memory_set_phase(g_memory_manager, "execucao");
+        interpreter = interpreter_create(ast, parser->symbol_table);
+        if (!interpreter) {
+            flat_ast_destroy(program);
+            parser_destroy(parser);
+            lexer_destroy(lexer2);
+            memory_free(g_memory_manager, source_code);
+            intern_table_destroy();
+            memory_manager_destroy(g_memory_manager);
+            return 1;
+        }
+        exec_ok = interpreter_execute(interpreter);
     }
 
-    int exec_ok = interpreter_execute(interpreter);
     if (!exec_ok) {
         printf("Erro durante a execução.\n");
     } else {
         printf("COMPILAÇÃO E EXECUÇÃO CONCLUÍDAS COM SUCESSO!\n");
     }
 
+    memory_set_phase(g_memory_manager, "finalizacao");
+
     interpreter_destroy(interpreter);
-    ast_destroy(ast);
+    ir_destroy(ir);
+    flat_ast_destroy(program);
     parser_destroy(parser);
     lexer_destroy(lexer2);
     
     /* Limpar e finalizar */
     memory_free(g_memory_manager, source_code);
+    intern_table_destroy();
     memory_manager_destroy(g_memory_manager);
     
     return 0;
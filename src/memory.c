@@ -1,41 +1,241 @@
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime */
 #include "../include/compiler.h"
 #include <sys/resource.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
 
-/* Estrutura para rastrear alocações */
+/* Cabeçalho de rastreamento gravado imediatamente antes do ponteiro do
+ * usuário. Layout do bloco: [MemoryBlock][guarda][dados][guarda] */
 typedef struct MemoryBlock {
-    void* ptr;
+    uint32_t magic;
     size_t size;
     int line_allocated;
     const char* file_allocated;
     const char* function_allocated;
     time_t time_allocated;
+    int size_class;             /* Classe do slab de origem (-1 = malloc direto) */
+    int profile_site;           /* Local de alocação no perfil de heap (-1 = nenhum) */
+    struct MemoryBlock* prev;   /* Lista intrusiva, usada só para relatórios */
     struct MemoryBlock* next;
 } MemoryBlock;
 
+#define MEMORY_BLOCK_MAGIC 0x4D454D42u  /* "MEMB" */
+#define MEMORY_BLOCK_FREED 0x46524545u  /* "FREE" */
+#define BLOCK_HEADER_SIZE (((sizeof(MemoryBlock)) + 15) & ~(size_t)15)
+#define BLOCK_OVERHEAD (BLOCK_HEADER_SIZE + (2 * MEMORY_GUARD_SIZE))
+
+/* Conversões entre cabeçalho, início das guardas e ponteiro do usuário */
+#define BLOCK_GUARDS(block) ((void*)((char*)(block) + BLOCK_HEADER_SIZE))
+#define BLOCK_USER_PTR(block) ((void*)((char*)(block) + BLOCK_HEADER_SIZE + MEMORY_GUARD_SIZE))
+#define BLOCK_FROM_USER(ptr) ((MemoryBlock*)((char*)(ptr) - MEMORY_GUARD_SIZE - BLOCK_HEADER_SIZE))
+
+/* Classes de tamanho do slab (tamanho total do bloco, com cabeçalho e guardas) */
+#define SLAB_CLASS_COUNT 7
+#define SLAB_CHUNK_SIZE 16384
+#define SLAB_MIN_SLOTS 4
+static const size_t slab_class_sizes[SLAB_CLASS_COUNT] = {
+    64, 128, 256, 512, 1024, 2048, 4096
+};
+
+/* Bloco grande de onde os slots de uma classe são recortados */
+typedef struct SlabChunk {
+    struct SlabChunk* next;
+    size_t size;
+} SlabChunk;
+
+/* Slot livre (reusa o espaço do próprio slot) */
+typedef struct SlabFreeSlot {
+    struct SlabFreeSlot* next;
+} SlabFreeSlot;
+
+/* Estado de uma classe de tamanho */
+typedef struct {
+    size_t slot_size;
+    SlabFreeSlot* free_list;
+    SlabChunk* chunks;
+    int chunk_count;
+    int slots_total;
+    int slots_in_use;
+} SlabClass;
+
+#define SLAB_CHUNK_HEADER (((sizeof(SlabChunk)) + 15) & ~(size_t)15)
+
+/* Cache de slots por thread: lotes movidos de/para a classe sob o lock */
+#define SLAB_CACHE_BATCH 16
+#define SLAB_CACHE_MAX (2 * SLAB_CACHE_BATCH)
+
+/* Estatísticas e cache de slots de uma thread. Só a thread dona escreve;
+ * os relatórios somam todos os fragmentos do gerenciador */
+typedef struct MemoryShard {
+    struct MemoryShard* next;
+    int allocation_count;
+    int deallocation_count;
+    int active_blocks;
+    size_t total_allocated;
+    size_t total_freed;
+    SlabFreeSlot* cache[SLAB_CLASS_COUNT];
+    int cache_count[SLAB_CLASS_COUNT];
+} MemoryShard;
+
+/* Referência da thread ao seu fragmento em um gerenciador */
+#define SHARD_TLS_SLOTS 4
+typedef struct {
+    unsigned long manager_id;   /* 0 = livre; ids nunca se repetem */
+    MemoryShard* shard;
+} ShardRef;
+
+static __thread ShardRef tls_shards[SHARD_TLS_SLOTS];
+static __thread int tls_next_slot;
+static unsigned long g_next_manager_id = 0;
+
+/* Operações atômicas sobre contadores compartilhados */
+#define ATOMIC_ADD(ptr, value) __atomic_add_fetch((ptr), (value), __ATOMIC_RELAXED)
+#define ATOMIC_SUB(ptr, value) __atomic_sub_fetch((ptr), (value), __ATOMIC_RELAXED)
+#define ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+
+/* Local de alocação agregado pelo perfil de heap */
+typedef struct {
+    const char* file;           /* NULL = entrada livre na tabela */
+    const char* function;
+    int line;
+    int live_count;
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    int total_count;
+    size_t total_bytes;
+} ProfileSite;
+
+#define PROFILE_MIN_SITES 64
+#define PROFILE_ARENA_FILE "arena"
+
+/* Amostra da linha do tempo de memória */
+typedef struct {
+    uint64_t time_ns;           /* Desde a ativação da linha do tempo */
+    size_t allocated;
+    const char* phase;
+} TimelineSample;
+
+/* Resumo de uma fase da compilação */
+typedef struct {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    size_t start_bytes;
+    size_t peak_bytes;
+    size_t end_bytes;
+} PhaseStat;
+
+#define TIMELINE_MAX_SAMPLES 100000
+#define TIMELINE_MAX_PHASES 32
+#define TIMELINE_MIN_INTERVAL_NS 1000000ull  /* Amostrar no máximo a cada 1 ms... */
+#define TIMELINE_MIN_DELTA 4096              /* ...a menos que o uso mude 4 KB */
+
 /* Estrutura interna do gerenciador */
 typedef struct {
     MemoryManager base;
+    unsigned long id;
+    pthread_mutex_t lock;       /* Protege lista de blocos, slabs e fragmentos */
+    MemoryShard* shards;
     MemoryBlock* blocks;
     int active_blocks;
     size_t total_allocated;
     size_t total_freed;
     int fragmentation_level;
     int last_warning_percent;
+    int arena_count;
+    size_t arena_reserved;
+    SlabClass slabs[SLAB_CLASS_COUNT];
+    size_t slab_reserved;       /* Bytes obtidos do sistema para os slabs */
+    int profiling;              /* Perfil de heap ativo */
+    char* profile_path;         /* Arquivo de pilhas dobradas gravado na saída */
+    ProfileSite* sites;         /* Tabela hash (endereçamento aberto) */
+    int site_capacity;
+    int site_count;
+    int timeline;               /* Linha do tempo ativa */
+    char* timeline_path;        /* Exportada na saída (.json ou CSV) */
+    uint64_t timeline_origin_ns;
+    uint64_t last_sample_ns;
+    size_t last_sample_bytes;
+    TimelineSample* samples;
+    int sample_count;
+    int sample_capacity;
+    int samples_dropped;
+    PhaseStat phases[TIMELINE_MAX_PHASES];
+    int phase_count;            /* Fase atual = phases[phase_count - 1] */
 } InternalMemoryManager;
 
+/* O que cada modo rastreia */
+#define TRACKS_STATS(mm) ((mm)->mode != MEMORY_MODE_OFF)
+#define TRACKS_BLOCKS(mm) ((mm)->mode == MEMORY_MODE_DEBUG)
+
+/* Alinhamento das alocações em arena */
+#define ARENA_ALIGNMENT 16
+#define ARENA_ALIGN(size) (((size) + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1))
+#define ARENA_CHUNK_HEADER ARENA_ALIGN(sizeof(MemoryArenaChunk))
+
 /* Funções auxiliares */
-static void poison_memory(void* ptr, size_t size);
+static void poison_memory(const MemoryManager* mm, void* ptr, size_t size);
 static int check_memory_corruption(void* ptr, size_t size);
-static void add_memory_guards(void* ptr, size_t size);
-static int verify_memory_guards(void* ptr, size_t size);
+static void add_memory_guards(const MemoryManager* mm, void* ptr, size_t size);
+static int verify_memory_guards(const MemoryManager* mm, void* ptr, size_t size);
 static void log_memory_operation(const char* operation, void* ptr, size_t size, const char* file, int line);
 static void calculate_fragmentation(InternalMemoryManager* imm);
 static size_t get_current_process_memory(void);
 static void update_process_peak_usage(MemoryManager* mm);
+static void sync_shard_stats(InternalMemoryManager* imm);
+static int profile_record(InternalMemoryManager* imm, const char* file, int line, const char* function, size_t bytes);
+static void profile_release(InternalMemoryManager* imm, int site, size_t bytes);
+static int profile_site_of(InternalMemoryManager* imm, const char* file, int line, const char* function);
+static void timeline_note(InternalMemoryManager* imm, size_t allocated);
+static uint64_t timeline_now_ns(void);
 
-/* Criar gerenciador de memória com inicialização completa */
+/* Registrar uso na linha do tempo apenas quando ativa */
+#define TIMELINE_NOTE(imm, allocated) \
+    do { if ((imm)->timeline) timeline_note((imm), (allocated)); } while (0)
+
+/* Nomes aceitos na linha de comando e no ambiente */
+static const char* memory_mode_names[] = {"off", "stats", "debug"};
+
+/* Nome de um modo */
+const char* memory_mode_name(MemoryMode mode) {
+    if (mode < MEMORY_MODE_OFF || mode > MEMORY_MODE_DEBUG) return "?";
+    return memory_mode_names[mode];
+}
+
+/* Converter nome em modo; retorna 0 se desconhecido */
+int memory_mode_parse(const char* name, MemoryMode* mode) {
+    if (!name || !mode) return 0;
+    
+    for (int i = MEMORY_MODE_OFF; i <= MEMORY_MODE_DEBUG; i++) {
+        if (strcmp(name, memory_mode_names[i]) == 0) {
+            *mode = (MemoryMode)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Modo escolhido pelo ambiente (padrão: stats) */
+MemoryMode memory_mode_from_env(void) {
+    MemoryMode mode = MEMORY_MODE_STATS;
+    const char* value = getenv(MEMORY_MODE_ENV);
+    
+    if (value && *value && !memory_mode_parse(value, &mode)) {
+        fprintf(stderr, "AVISO: Modo de memória desconhecido '%s' em %s, usando '%s'\n",
+                value, MEMORY_MODE_ENV, memory_mode_name(mode));
+    }
+    return mode;
+}
+
+/* Criar gerenciador de memória com a configuração global */
 MemoryManager* memory_manager_create(void) {
+    return memory_manager_create_with_config(&g_config);
+}
+
+/* Criar gerenciador de memória com inicialização completa */
+MemoryManager* memory_manager_create_with_config(const CompilerConfig* config) {
+    MemoryMode mode = config ? config->memory_mode : MEMORY_MODE_STATS;
     InternalMemoryManager* mm = (InternalMemoryManager*)malloc(sizeof(InternalMemoryManager));
     if (!mm) {
         fprintf(stderr, "ERRO CRÍTICO: Falha ao criar gerenciador de memória\n");
@@ -43,23 +243,55 @@ MemoryManager* memory_manager_create(void) {
     }
     
     /* Inicializar estrutura base */
+    mm->base.mode = mode;
     mm->base.allocated = 0;
     mm->base.peak_usage = 0;
-    mm->base.limit = MAX_MEMORY_BYTES;
+    mm->base.limit = config ? config->memory_limit : MAX_MEMORY_BYTES;
     mm->base.allocation_count = 0;
     mm->base.deallocation_count = 0;
-    mm->base.process_peak_usage = get_current_process_memory();
+    mm->base.process_peak_usage = 0;
     
     /* Inicializar estrutura interna */
+    mm->id = ATOMIC_ADD(&g_next_manager_id, 1);
+    pthread_mutex_init(&mm->lock, NULL);
+    mm->shards = NULL;
     mm->blocks = NULL;
     mm->active_blocks = 0;
     mm->total_allocated = 0;
     mm->total_freed = 0;
     mm->fragmentation_level = 0;
     mm->last_warning_percent = 0;
+    mm->arena_count = 0;
+    mm->arena_reserved = 0;
+    mm->slab_reserved = 0;
+    mm->profiling = 0;
+    mm->profile_path = NULL;
+    mm->sites = NULL;
+    mm->site_capacity = 0;
+    mm->site_count = 0;
+    mm->timeline = 0;
+    mm->timeline_path = NULL;
+    mm->timeline_origin_ns = 0;
+    mm->last_sample_ns = 0;
+    mm->last_sample_bytes = 0;
+    mm->samples = NULL;
+    mm->sample_count = 0;
+    mm->sample_capacity = 0;
+    mm->samples_dropped = 0;
+    mm->phase_count = 0;
+    
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        mm->slabs[i].slot_size = slab_class_sizes[i];
+        mm->slabs[i].free_list = NULL;
+        mm->slabs[i].chunks = NULL;
+        mm->slabs[i].chunk_count = 0;
+        mm->slabs[i].slots_total = 0;
+        mm->slabs[i].slots_in_use = 0;
+    }
     
     if (DEBUG_MEMORY) {
-        printf("DEBUG: Gerenciador de memória criado com limite de %zu bytes\n", mm->base.limit);
+        printf("DEBUG: Gerenciador de memória criado com limite de %zu bytes (modo %s)\n",
+               mm->base.limit, memory_mode_name(mode));
     }
     
     return (MemoryManager*)mm;
@@ -69,13 +301,34 @@ MemoryManager* memory_manager_create(void) {
 void memory_manager_destroy(MemoryManager* mm) {
     if (!mm) return;
     
+    /* Imprimir relatório final detalhado */
+    update_process_peak_usage(mm);
+    memory_report_detailed(mm);
+    
+    /* Perfil de heap acumulado durante toda a execução */
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    if (imm->profiling) {
+        memory_profile_dump(mm, stdout, imm->profile_path);
+    }
+    
+    if (imm->timeline && imm->timeline_path) {
+        memory_timeline_export(mm, imm->timeline_path);
+    }
+    
+    memory_manager_discard(mm);
+}
+
+/* Destruir gerenciador sem relatório (apenas avisos de vazamento) */
+void memory_manager_discard(MemoryManager* mm) {
+    if (!mm) return;
+    
     InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    sync_shard_stats(imm);
     
     /* Verificar vazamentos */
     int leak_count = 0;
     size_t leaked_bytes = 0;
     MemoryBlock* block = imm->blocks;
-    update_process_peak_usage(mm);
     
     while (block) {
         MemoryBlock* next = block->next;
@@ -87,40 +340,349 @@ void memory_manager_destroy(MemoryManager* mm) {
         }
         
         /* Verificar corrupção de memória */
-        if (check_memory_corruption(block->ptr, block->size)) {
-            fprintf(stderr, "ERRO: Corrupção de memória detectada no bloco %p\n", block->ptr);
+        if (check_memory_corruption(BLOCK_USER_PTR(block), block->size)) {
+            fprintf(stderr, "ERRO: Corrupção de memória detectada no bloco %p\n", BLOCK_USER_PTR(block));
         }
         
         leak_count++;
-        leaked_bytes += block->size;
+        leaked_bytes += block->size + BLOCK_OVERHEAD;
         
-        free(block->ptr);
-        free(block);
+        /* Slots dos slabs voltam junto com seus blocos grandes */
+        if (block->size_class < 0) {
+            free(block);
+        }
         block = next;
     }
+    imm->blocks = NULL;
     
-    /* Imprimir relatório final detalhado */
-    memory_report_detailed(mm);
+    /* Sem lista de blocos, estimar vazamentos pelos contadores */
+    if (!TRACKS_BLOCKS(mm)) {
+        leaked_bytes = mm->allocated - imm->arena_reserved;
+        leak_count = TRACKS_STATS(mm) ? imm->active_blocks : (leaked_bytes > 0);
+    }
     
     if (leak_count > 0) {
         fprintf(stderr, "ERRO: %d vazamentos de memória detectados (%zu bytes)\n", leak_count, leaked_bytes);
     }
     
+    if (imm->arena_count > 0) {
+        fprintf(stderr, "ERRO: %d arenas não destruídas (%zu bytes)\n", imm->arena_count, imm->arena_reserved);
+    }
+    
+    /* Devolver blocos dos slabs ao sistema */
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        SlabChunk* chunk = imm->slabs[i].chunks;
+        while (chunk) {
+            SlabChunk* next_chunk = chunk->next;
+            free(chunk);
+            chunk = next_chunk;
+        }
+    }
+    
+    /* Liberar fragmentos; referências de outras threads ficam com id morto */
+    MemoryShard* shard = imm->shards;
+    while (shard) {
+        MemoryShard* next_shard = shard->next;
+        free(shard);
+        shard = next_shard;
+    }
+    for (int i = 0; i < SHARD_TLS_SLOTS; i++) {
+        if (tls_shards[i].manager_id == imm->id) {
+            tls_shards[i].manager_id = 0;
+            tls_shards[i].shard = NULL;
+        }
+    }
+    
+    free(imm->sites);
+    free(imm->profile_path);
+    free(imm->samples);
+    free(imm->timeline_path);
+    pthread_mutex_destroy(&imm->lock);
     free(mm);
 }
 
+/* Escolher classe do slab para um bloco (-1 se grande demais) */
+static int slab_class_for(size_t total_size) {
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        if (total_size <= slab_class_sizes[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Recortar novo bloco grande em slots livres da classe */
+static int slab_refill(InternalMemoryManager* imm, SlabClass* cls) {
+    size_t slots = SLAB_CHUNK_SIZE / cls->slot_size;
+    if (slots < SLAB_MIN_SLOTS) slots = SLAB_MIN_SLOTS;
+    
+    size_t chunk_size = SLAB_CHUNK_HEADER + slots * cls->slot_size;
+    SlabChunk* chunk = (SlabChunk*)malloc(chunk_size);
+    if (!chunk) return 0;
+    
+    chunk->size = chunk_size;
+    chunk->next = cls->chunks;
+    cls->chunks = chunk;
+    cls->chunk_count++;
+    cls->slots_total += (int)slots;
+    imm->slab_reserved += chunk_size;
+    
+    /* Encadear slots em ordem de endereço */
+    char* base = (char*)chunk + SLAB_CHUNK_HEADER;
+    for (size_t i = slots; i > 0; i--) {
+        SlabFreeSlot* slot = (SlabFreeSlot*)(base + (i - 1) * cls->slot_size);
+        slot->next = cls->free_list;
+        cls->free_list = slot;
+    }
+    
+    return 1;
+}
+
+/* Fragmento da thread atual para o gerenciador (criado no primeiro uso) */
+static MemoryShard* shard_for_thread(InternalMemoryManager* imm) {
+    for (int i = 0; i < SHARD_TLS_SLOTS; i++) {
+        if (tls_shards[i].manager_id == imm->id) {
+            return tls_shards[i].shard;
+        }
+    }
+    
+    MemoryShard* shard = (MemoryShard*)calloc(1, sizeof(MemoryShard));
+    if (!shard) return NULL;
+    
+    pthread_mutex_lock(&imm->lock);
+    shard->next = imm->shards;
+    imm->shards = shard;
+    pthread_mutex_unlock(&imm->lock);
+    
+    /* Referência substituída continua registrada no seu gerenciador */
+    ShardRef* ref = &tls_shards[tls_next_slot];
+    tls_next_slot = (tls_next_slot + 1) % SHARD_TLS_SLOTS;
+    ref->manager_id = imm->id;
+    ref->shard = shard;
+    
+    return shard;
+}
+
+/* Mover até SLAB_CACHE_BATCH slots da classe para o cache (lock obtido) */
+static void slab_fill_cache(InternalMemoryManager* imm, MemoryShard* shard, int size_class) {
+    SlabClass* cls = &imm->slabs[size_class];
+    
+    for (int n = 0; n < SLAB_CACHE_BATCH; n++) {
+        if (!cls->free_list && !slab_refill(imm, cls)) break;
+        
+        SlabFreeSlot* slot = cls->free_list;
+        cls->free_list = slot->next;
+        cls->slots_in_use++;
+        
+        slot->next = shard->cache[size_class];
+        shard->cache[size_class] = slot;
+        shard->cache_count[size_class]++;
+    }
+}
+
+/* Devolver slots do cache à classe, mantendo `keep` (lock obtido) */
+static void slab_drain_cache(InternalMemoryManager* imm, MemoryShard* shard, int size_class, int keep) {
+    SlabClass* cls = &imm->slabs[size_class];
+    
+    while (shard->cache_count[size_class] > keep) {
+        SlabFreeSlot* slot = shard->cache[size_class];
+        shard->cache[size_class] = slot->next;
+        shard->cache_count[size_class]--;
+        
+        slot->next = cls->free_list;
+        cls->free_list = slot;
+        cls->slots_in_use--;
+    }
+}
+
+/* Obter memória bruta para um bloco: slot do cache da thread ou malloc */
+static MemoryBlock* raw_block_alloc(InternalMemoryManager* imm, MemoryShard* shard, size_t total_size) {
+    int size_class = slab_class_for(total_size);
+    
+    if (size_class < 0) {
+        MemoryBlock* block = (MemoryBlock*)malloc(total_size);
+        if (block) block->size_class = -1;
+        return block;
+    }
+    
+    if (shard->cache_count[size_class] == 0) {
+        pthread_mutex_lock(&imm->lock);
+        slab_fill_cache(imm, shard, size_class);
+        pthread_mutex_unlock(&imm->lock);
+        
+        if (shard->cache_count[size_class] == 0) {
+            return NULL;
+        }
+    }
+    
+    SlabFreeSlot* slot = shard->cache[size_class];
+    shard->cache[size_class] = slot->next;
+    shard->cache_count[size_class]--;
+    
+    MemoryBlock* block = (MemoryBlock*)slot;
+    block->size_class = size_class;
+    return block;
+}
+
+/* Devolver memória bruta de um bloco ao cache da thread que libera */
+static void raw_block_release(InternalMemoryManager* imm, MemoryShard* shard, MemoryBlock* block) {
+    int size_class = block->size_class;
+    
+    if (size_class < 0) {
+        free(block);
+        return;
+    }
+    
+    SlabFreeSlot* slot = (SlabFreeSlot*)block;
+    slot->next = shard->cache[size_class];
+    shard->cache[size_class] = slot;
+    shard->cache_count[size_class]++;
+    
+    if (shard->cache_count[size_class] > SLAB_CACHE_MAX) {
+        pthread_mutex_lock(&imm->lock);
+        slab_drain_cache(imm, shard, size_class, SLAB_CACHE_BATCH);
+        pthread_mutex_unlock(&imm->lock);
+    }
+}
+
+/* Reservar bytes no limite global; falha sem alterar o contador */
+static int reserve_limit(MemoryManager* mm, size_t bytes, size_t* total) {
+    size_t allocated = ATOMIC_ADD(&mm->allocated, bytes);
+    if (allocated > mm->limit) {
+        ATOMIC_SUB(&mm->allocated, bytes);
+        return 0;
+    }
+    if (total) *total = allocated;
+    return 1;
+}
+
+/* Modo off: prefixo mínimo antes do ponteiro, só com o tamanho pedido,
+ * para devolver ao limite o que foi reservado. Mantém o alinhamento do
+ * malloc (16 bytes em x86-64) */
+#define OFF_PREFIX 16
+#define OFF_SIZE(base) (*(size_t*)(base))
+
+/* Registrar novo pico de uso */
+static void record_peak_usage(MemoryManager* mm, size_t allocated) {
+    size_t peak = ATOMIC_LOAD(&mm->peak_usage);
+    while (allocated > peak &&
+           !__atomic_compare_exchange_n(&mm->peak_usage, &peak, allocated, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/* Somar fragmentos das threads nos contadores do gerenciador */
+static void sync_shard_stats(InternalMemoryManager* imm) {
+    int allocation_count = 0;
+    int deallocation_count = 0;
+    int active_blocks = 0;
+    size_t total_allocated = 0;
+    size_t total_freed = 0;
+    
+    pthread_mutex_lock(&imm->lock);
+    for (MemoryShard* shard = imm->shards; shard; shard = shard->next) {
+        allocation_count += ATOMIC_LOAD(&shard->allocation_count);
+        deallocation_count += ATOMIC_LOAD(&shard->deallocation_count);
+        active_blocks += ATOMIC_LOAD(&shard->active_blocks);
+        total_allocated += ATOMIC_LOAD(&shard->total_allocated);
+        total_freed += ATOMIC_LOAD(&shard->total_freed);
+    }
+    
+    imm->base.allocation_count = allocation_count;
+    imm->base.deallocation_count = deallocation_count;
+    imm->active_blocks = active_blocks;
+    imm->total_allocated = total_allocated;
+    imm->total_freed = total_freed;
+    calculate_fragmentation(imm);
+    pthread_mutex_unlock(&imm->lock);
+}
+
+/* Devolver o cache da thread atual antes de ela terminar */
+void memory_thread_release(MemoryManager* mm) {
+    if (!mm) return;
+    
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    
+    for (int i = 0; i < SHARD_TLS_SLOTS; i++) {
+        if (tls_shards[i].manager_id != imm->id) continue;
+        
+        /* Contadores permanecem no fragmento registrado */
+        pthread_mutex_lock(&imm->lock);
+        for (int c = 0; c < SLAB_CLASS_COUNT; c++) {
+            slab_drain_cache(imm, tls_shards[i].shard, c, 0);
+        }
+        pthread_mutex_unlock(&imm->lock);
+        
+        tls_shards[i].manager_id = 0;
+        tls_shards[i].shard = NULL;
+    }
+}
+
+/* Inserir bloco no início da lista de blocos ativos */
+static void block_list_push(InternalMemoryManager* imm, MemoryBlock* block) {
+    pthread_mutex_lock(&imm->lock);
+    block->prev = NULL;
+    block->next = imm->blocks;
+    if (imm->blocks) {
+        imm->blocks->prev = block;
+    }
+    imm->blocks = block;
+    pthread_mutex_unlock(&imm->lock);
+}
+
+/* Remover bloco da lista de blocos ativos - O(1) */
+static void block_list_unlink(InternalMemoryManager* imm, MemoryBlock* block) {
+    pthread_mutex_lock(&imm->lock);
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        imm->blocks = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    }
+    pthread_mutex_unlock(&imm->lock);
+}
+
+/* Obter cabeçalho a partir do ponteiro do usuário, validando a assinatura */
+static MemoryBlock* block_from_user(void* ptr) {
+    MemoryBlock* block = BLOCK_FROM_USER(ptr);
+    if (block->magic != MEMORY_BLOCK_MAGIC) {
+        return NULL;
+    }
+    return block;
+}
+
 /* Alocar memória com rastreamento avançado */
-void* memory_alloc_debug(MemoryManager* mm, size_t size, const char* file, int line, const char* function __attribute__((unused))) {
+void* memory_alloc_debug(MemoryManager* mm, size_t size, const char* file, int line, const char* function) {
     if (!mm || size == 0) return NULL;
     
+    /* Modo off: repasse ao malloc com prefixo de tamanho, sem fragmento,
+     * slab nem estatísticas; só o contador do limite */
+    if (mm->mode == MEMORY_MODE_OFF) {
+        if (size > SIZE_MAX - OFF_PREFIX || !reserve_limit(mm, size + OFF_PREFIX, NULL)) {
+            error_report(ERROR_MEMORY, line, 0, "Memória Insuficiente");
+            return NULL;
+        }
+        unsigned char* base = (unsigned char*)malloc(size + OFF_PREFIX);
+        if (!base) {
+            ATOMIC_SUB(&mm->allocated, size + OFF_PREFIX);
+            error_report(ERROR_MEMORY, line, 0, "Falha na alocação de memória do sistema");
+            return NULL;
+        }
+        OFF_SIZE(base) = size;
+        return base + OFF_PREFIX;
+    }
+    
     InternalMemoryManager* imm = (InternalMemoryManager*)mm;
     
-    /* Calcular tamanho total necessário incluindo overhead */
-    size_t total_overhead = MEMORY_BLOCK_OVERHEAD + (2 * MEMORY_GUARD_SIZE);
+    /* Calcular tamanho total necessário incluindo cabeçalho e guardas */
+    size_t total_overhead = BLOCK_OVERHEAD;
     size_t total_size = size + total_overhead;
     
-    /* Verificar limite de memória */
-    if (mm->allocated + total_size > mm->limit) {
+    /* Reservar no limite de memória */
+    size_t allocated;
+    if (!reserve_limit(mm, total_size, &allocated)) {
         if (DEBUG_MEMORY) {
             fprintf(stderr, "DEBUG: Falha na alocação - Tentando alocar %zu bytes (+ %zu overhead)\n", 
                     size, total_overhead);
@@ -131,56 +693,47 @@ void* memory_alloc_debug(MemoryManager* mm, size_t size, const char* file, int l
         return NULL;
     }
     
-    /* Alocar memória com guardas */
-    void* raw_ptr = malloc(total_size);
-    if (!raw_ptr) {
-        error_report(ERROR_MEMORY, line, 0, "Falha na alocação de memória do sistema");
-        return NULL;
-    }
-    
-    /* Configurar guardas de memória */
-    add_memory_guards(raw_ptr, size);
-    void* user_ptr = (char*)raw_ptr + MEMORY_GUARD_SIZE;
-    
-    /* Inicializar memória com padrão */
-    poison_memory(user_ptr, size);
-    
-    /* Criar bloco de rastreamento */
-    MemoryBlock* block = (MemoryBlock*)malloc(sizeof(MemoryBlock));
+    /* Alocar cabeçalho, guardas e dados em um único bloco */
+    MemoryShard* shard = shard_for_thread(imm);
+    MemoryBlock* block = shard ? raw_block_alloc(imm, shard, total_size) : NULL;
     if (!block) {
-        free(raw_ptr);
-        error_report(ERROR_MEMORY, line, 0, "Falha ao criar bloco de rastreamento");
+        ATOMIC_SUB(&mm->allocated, total_size);
+        error_report(ERROR_MEMORY, line, 0, "Falha na alocação de memória do sistema");
         return NULL;
     }
     
-    block->ptr = raw_ptr;
+    block->magic = MEMORY_BLOCK_MAGIC;
     block->size = size;
-    block->line_allocated = line;
-    block->file_allocated = file;
-    block->function_allocated = function;
-    block->time_allocated = time(NULL);
-    block->next = imm->blocks;
-    imm->blocks = block;
-    
-    /* Atualizar estatísticas */
-    mm->allocated += total_size;
-    mm->allocation_count++;
-    imm->active_blocks++;
-    imm->total_allocated += total_size;
-    
-    if (mm->allocated > mm->peak_usage) {
-        mm->peak_usage = mm->allocated;
+    block->profile_site = imm->profiling ? profile_record(imm, file, line, function, size) : -1;
+    void* user_ptr = BLOCK_USER_PTR(block);
+    
+    if (TRACKS_STATS(mm)) {
+        ATOMIC_ADD(&shard->allocation_count, 1);
+        ATOMIC_ADD(&shard->active_blocks, 1);
+        ATOMIC_ADD(&shard->total_allocated, total_size);
+        record_peak_usage(mm, allocated);
     }
+    TIMELINE_NOTE(imm, allocated);
     
-    /* Calcular fragmentação */
-    calculate_fragmentation(imm);
+    if (TRACKS_BLOCKS(mm)) {
+        /* Configurar guardas e inicializar memória com padrão */
+        add_memory_guards(mm, BLOCK_GUARDS(block), size);
+        poison_memory(mm, user_ptr, size);
+        
+        /* Preencher cabeçalho de rastreamento */
+        block->line_allocated = line;
+        block->file_allocated = file;
+        block->function_allocated = function;
+        block->time_allocated = time(NULL);
+        block_list_push(imm, block);
+    }
     
     /* Log da operação */
     if (DEBUG_MEMORY) {
         printf("DEBUG: Alocação bem sucedida - %zu bytes (+ %zu overhead) em %s:%d\n", 
                size, total_overhead, file, line);
         printf("       Memória atual: %zu bytes (%.1f%% do limite)\n", 
-               mm->allocated, ((double)mm->allocated / mm->limit) * 100.0);
+               allocated, ((double)allocated / mm->limit) * 100.0);
     }
     
     return user_ptr;
@@ -196,39 +749,46 @@ void memory_free_debug(MemoryManager* mm, void* ptr, const char* file, int line,
     /* function é mantido para consistência com a interface de debug, mesmo que não usado */
     if (!mm || !ptr) return;
     
-    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
-    void* raw_ptr = (char*)ptr - MEMORY_GUARD_SIZE;
-    
-    /* Encontrar bloco */
-    MemoryBlock** curr = &imm->blocks;
-    MemoryBlock* block = NULL;
-    
-    while (*curr) {
-        if ((*curr)->ptr == raw_ptr) {
-            block = *curr;
-            *curr = block->next;
-            break;
-        }
-        curr = &(*curr)->next;
+    if (mm->mode == MEMORY_MODE_OFF) {
+        unsigned char* base = (unsigned char*)ptr - OFF_PREFIX;
+        ATOMIC_SUB(&mm->allocated, OFF_SIZE(base) + OFF_PREFIX);
+        free(base);
+        return;
     }
     
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    
+    /* Cabeçalho fica logo antes do ponteiro - sem busca na lista */
+    MemoryBlock* block = block_from_user(ptr);
     if (!block) {
         error_report(ERROR_MEMORY, line, 0, "Tentativa de liberar ponteiro não rastreado");
         return;
     }
     
-    /* Verificar corrupção */
-    if (!verify_memory_guards(block->ptr, block->size)) {
-        fprintf(stderr, "ERRO: Corrupção de memória detectada ao liberar %p\n", ptr);
+    size_t total_overhead = BLOCK_OVERHEAD;
+    size_t total_size = block->size + total_overhead;
+    MemoryShard* shard = shard_for_thread(imm);
+    if (!shard) {
+        error_report(ERROR_MEMORY, line, 0, "Falha ao registrar thread no gerenciador de memória");
+        return;
+    }
+    size_t allocated = ATOMIC_SUB(&mm->allocated, total_size);
+    TIMELINE_NOTE(imm, allocated);
+    
+    if (TRACKS_BLOCKS(mm)) {
+        /* Verificar corrupção */
+        if (!verify_memory_guards(mm, BLOCK_GUARDS(block), block->size)) {
+            fprintf(stderr, "ERRO: Corrupção de memória detectada ao liberar %p\n", ptr);
+        }
+        block_list_unlink(imm, block);
     }
     
     /* Atualizar estatísticas */
-    size_t total_overhead = MEMORY_BLOCK_OVERHEAD + (2 * MEMORY_GUARD_SIZE);
-    size_t total_size = block->size + total_overhead;
-    mm->allocated -= total_size;
-    mm->deallocation_count++;
-    imm->active_blocks--;
-    imm->total_freed += total_size;
+    if (TRACKS_STATS(mm)) {
+        ATOMIC_ADD(&shard->deallocation_count, 1);
+        ATOMIC_SUB(&shard->active_blocks, 1);
+        ATOMIC_ADD(&shard->total_freed, total_size);
+    }
     
     /* Log da operação */
     if (DEBUG_MEMORY) {
@@ -236,9 +796,13 @@ void memory_free_debug(MemoryManager* mm, void* ptr, const char* file, int line,
                ptr, block->size, total_overhead, file, line);
     }
     
-    /* Limpar e liberar */
-    free(block->ptr);
-    free(block);
+    if (block->profile_site >= 0) {
+        profile_release(imm, block->profile_site, block->size);
+    }
+    
+    /* Invalidar assinatura para detectar liberação dupla */
+    block->magic = MEMORY_BLOCK_FREED;
+    raw_block_release(imm, shard, block);
 }
 
 /* Wrapper para liberação normal */
@@ -259,18 +823,29 @@ void* memory_realloc_debug(MemoryManager* mm, void* ptr, size_t new_size, const
         return NULL;
     }
     
-    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
-    
-    /* Encontrar bloco atual */
-    MemoryBlock* block = imm->blocks;
-    while (block) {
-        void* user_ptr = (char*)block->ptr + MEMORY_GUARD_SIZE;
-        if (user_ptr == ptr) {
-            break;
+    if (mm->mode == MEMORY_MODE_OFF) {
+        unsigned char* base = (unsigned char*)ptr - OFF_PREFIX;
+        size_t old_size = OFF_SIZE(base);
+        if (new_size > SIZE_MAX - OFF_PREFIX ||
+            (new_size > old_size && !reserve_limit(mm, new_size - old_size, NULL))) {
+            error_report(ERROR_MEMORY, line, 0, "Memória Insuficiente para realocação");
+            return NULL;
         }
-        block = block->next;
+        unsigned char* moved = (unsigned char*)realloc(base, new_size + OFF_PREFIX);
+        if (!moved) {
+            if (new_size > old_size) ATOMIC_SUB(&mm->allocated, new_size - old_size);
+            error_report(ERROR_MEMORY, line, 0, "Falha na realocação de memória do sistema");
+            return NULL;
+        }
+        if (new_size < old_size) ATOMIC_SUB(&mm->allocated, old_size - new_size);
+        OFF_SIZE(moved) = new_size;
+        return moved + OFF_PREFIX;
     }
     
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    
+    /* Encontrar bloco atual pelo cabeçalho */
+    MemoryBlock* block = block_from_user(ptr);
     if (!block) {
         error_report(ERROR_MEMORY, line, 0, "Tentativa de realocar ponteiro não rastreado");
         return NULL;
@@ -279,62 +854,103 @@ void* memory_realloc_debug(MemoryManager* mm, void* ptr, size_t new_size, const
     size_t old_size = block->size;
     
     /* Verificar guardas antes de realocar */
-    if (!verify_memory_guards(block->ptr, old_size)) {
+    if (!verify_memory_guards(mm, BLOCK_GUARDS(block), old_size)) {
         fprintf(stderr, "ERRO: Corrupção de memória detectada ao realocar %p\n", ptr);
     }
     
-    /* Verificar limite para novo tamanho */
-    if (new_size > old_size) {
-        size_t additional = new_size - old_size;
-        if (mm->allocated + additional > mm->limit) {
-            error_report(ERROR_MEMORY, line, 0, "Memória Insuficiente para realocação");
-            return NULL;
-        }
+    /* Reservar no limite a diferença de tamanho */
+    size_t allocated = ATOMIC_LOAD(&mm->allocated);
+    if (new_size > old_size && !reserve_limit(mm, new_size - old_size, &allocated)) {
+        error_report(ERROR_MEMORY, line, 0, "Memória Insuficiente para realocação");
+        return NULL;
     }
     
-    /* Alocar novo bloco com guardas */
-    size_t total_size = new_size + (2 * MEMORY_GUARD_SIZE);
-    void* new_raw_ptr = realloc(block->ptr, total_size);
-    if (!new_raw_ptr) {
-        error_report(ERROR_MEMORY, line, 0, "Falha na realocação de memória");
+    MemoryShard* shard = shard_for_thread(imm);
+    if (!shard) {
+        if (new_size > old_size) ATOMIC_SUB(&mm->allocated, new_size - old_size);
+        error_report(ERROR_MEMORY, line, 0, "Falha ao registrar thread no gerenciador de memória");
         return NULL;
     }
     
-    /* Configurar novas guardas */
-    add_memory_guards(new_raw_ptr, new_size);
-    void* new_user_ptr = (char*)new_raw_ptr + MEMORY_GUARD_SIZE;
+    /* Bloco sai da lista enquanto é movido; volta no início depois */
+    if (TRACKS_BLOCKS(mm)) {
+        block_list_unlink(imm, block);
+    }
     
-    /* Se aumentou o tamanho, inicializar nova área */
-    if (new_size > old_size) {
-        poison_memory((char*)new_user_ptr + old_size, new_size - old_size);
+    /* Realocar bloco inteiro */
+    size_t total_size = new_size + BLOCK_OVERHEAD;
+    int old_class = block->size_class;
+    int new_class = slab_class_for(total_size);
+    MemoryBlock* new_block;
+    
+    if (old_class >= 0 && old_class == new_class) {
+        /* Cabe no mesmo slot */
+        new_block = block;
+    } else if (old_class < 0 && new_class < 0) {
+        new_block = (MemoryBlock*)realloc(block, total_size);
+    } else {
+        /* Mudança de classe: copiar cabeçalho, guarda e dados */
+        new_block = raw_block_alloc(imm, shard, total_size);
+        if (new_block) {
+            size_t keep = BLOCK_HEADER_SIZE + MEMORY_GUARD_SIZE + (old_size < new_size ? old_size : new_size);
+            int size_class = new_block->size_class;
+            memcpy(new_block, block, keep);
+            new_block->size_class = size_class;
+            raw_block_release(imm, shard, block);
+        }
     }
     
-    /* Atualizar bloco */
-    block->ptr = new_raw_ptr;
-    block->size = new_size;
-    block->line_allocated = line;
-    block->file_allocated = file;
-    block->function_allocated = function;
-    block->time_allocated = time(NULL);
+    if (!new_block) {
+        if (new_size > old_size) ATOMIC_SUB(&mm->allocated, new_size - old_size);
+        if (TRACKS_BLOCKS(mm)) block_list_push(imm, block);
+        error_report(ERROR_MEMORY, line, 0, "Falha na realocação de memória");
+        return NULL;
+    }
     
-    /* Atualizar estatísticas */
-    mm->allocated = mm->allocated - old_size + new_size;
+    /* Perfil: bloco passa a pertencer ao local da realocação */
+    if (new_block->profile_site >= 0) {
+        profile_release(imm, new_block->profile_site, old_size);
+    }
+    new_block->profile_site = imm->profiling ? profile_record(imm, file, line, function, new_size) : -1;
     
-    if (new_size > old_size) {
-        imm->total_allocated += (new_size - old_size);
-    } else {
-        imm->total_freed += (old_size - new_size);
+    void* new_user_ptr = BLOCK_USER_PTR(new_block);
+    new_block->size = new_size;
+    if (new_size < old_size) {
+        allocated = ATOMIC_SUB(&mm->allocated, old_size - new_size);
     }
     
-    if (mm->allocated > mm->peak_usage) {
-        mm->peak_usage = mm->allocated;
+    /* Atualizar estatísticas */
+    if (TRACKS_STATS(mm)) {
+        if (new_size > old_size) {
+            ATOMIC_ADD(&shard->total_allocated, new_size - old_size);
+        } else {
+            ATOMIC_ADD(&shard->total_freed, old_size - new_size);
+        }
+        record_peak_usage(mm, allocated);
     }
+    TIMELINE_NOTE(imm, allocated);
     
-    /* Calcular fragmentação */
-    calculate_fragmentation(imm);
+    if (TRACKS_BLOCKS(mm)) {
+        /* Configurar novas guardas */
+        add_memory_guards(mm, BLOCK_GUARDS(new_block), new_size);
+        
+        /* Se aumentou o tamanho, inicializar nova área */
+        if (new_size > old_size) {
+            poison_memory(mm, (char*)new_user_ptr + old_size, new_size - old_size);
+        }
+        
+        /* Atualizar origem do bloco */
+        new_block->line_allocated = line;
+        new_block->file_allocated = file;
+        new_block->function_allocated = function;
+        new_block->time_allocated = time(NULL);
+        block_list_push(imm, new_block);
+    }
     
     /* Verificar avisos */
-    memory_check_limit(mm);
+    if (TRACKS_STATS(mm)) {
+        memory_check_limit(mm);
+    }
     
     /* Log da operação */
     log_memory_operation("REALLOC", new_user_ptr, new_size, file, line);
@@ -351,23 +967,24 @@ void* memory_realloc(MemoryManager* mm, void* ptr, size_t new_size) {
 int memory_check_limit(MemoryManager* mm) {
     if (!mm) return 0;
     
-    double usage_percent = ((double)mm->allocated / (double)mm->limit) * 100.0;
+    size_t allocated = ATOMIC_LOAD(&mm->allocated);
+    double usage_percent = ((double)allocated / (double)mm->limit) * 100.0;
     
     if (DEBUG_MEMORY) {
         printf("DEBUG: Verificando limite de memória - Uso: %.2f%% (%zu/%zu bytes)\n",
-               usage_percent, mm->allocated, mm->limit);
+               usage_percent, allocated, mm->limit);
     }
     
-    if (mm->allocated >= mm->limit) {
+    if (allocated >= mm->limit) {
         error_report(ERROR_MEMORY, 0, 0, "Limite de memória excedido");
         return 3; /* Erro crítico */
     } else if (usage_percent >= 95.0) {
         fprintf(stderr, "AVISO CRÍTICO: Uso de memória muito alto: %.1f%% (%zu/%zu bytes)\n",
-                usage_percent, mm->allocated, mm->limit);
+                usage_percent, allocated, mm->limit);
         return 2; /* Aviso crítico */
     } else if (usage_percent >= 90.0) {
         fprintf(stderr, "AVISO: Uso de memória alto: %.1f%% (%zu/%zu bytes)\n",
-                usage_percent, mm->allocated, mm->limit);
+                usage_percent, allocated, mm->limit);
         return 1; /* Aviso normal */
     }
     
@@ -378,10 +995,13 @@ int memory_check_limit(MemoryManager* mm) {
 void memory_report(MemoryManager* mm) {
     if (!mm) return;
 
+    sync_shard_stats((InternalMemoryManager*)mm);
+
     size_t current = get_current_process_memory();
     update_process_peak_usage(mm);
 
     printf("\n=== RELATÓRIO DE MEMÓRIA ===\n");
+    printf("Modo do gerenciador: %s\n", memory_mode_name(mm->mode));
     printf("Memória alocada atualmente: %zu bytes (%.2f KB)\n",
            mm->allocated, (double)mm->allocated / 1024.0);
     printf("Pico de uso de memória: %zu bytes (%.2f KB)\n",
@@ -404,11 +1024,13 @@ void memory_report_detailed(MemoryManager* mm) {
     if (!mm) return;
 
     InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    sync_shard_stats(imm);
 
     size_t current = get_current_process_memory();
     update_process_peak_usage(mm);
     
     printf("\n=== RELATÓRIO DETALHADO DE MEMÓRIA ===\n");
+    printf("Modo do gerenciador: %s\n", memory_mode_name(mm->mode));
     printf("Memória alocada atualmente: %zu bytes (%.2f KB)\n", 
            mm->allocated, (double)mm->allocated / 1024.0);
     printf("Pico de uso de memória: %zu bytes (%.2f KB)\n",
@@ -445,8 +1067,15 @@ void memory_report_detailed(MemoryManager* mm) {
     printf("\n--- BLOCOS ATIVOS ---\n");
     int leak_count = 0;
     size_t leaked_bytes = 0;
-    MemoryBlock* block = imm->blocks;
     
+    /* Sem lista de blocos, usar os contadores */
+    if (!TRACKS_BLOCKS(mm)) {
+        leak_count = imm->active_blocks;
+        leaked_bytes = mm->allocated - imm->arena_reserved;
+    }
+    
+    pthread_mutex_lock(&imm->lock);
+    MemoryBlock* block = imm->blocks;
     while (block) {
         leak_count++;
         leaked_bytes += block->size;
@@ -459,6 +1088,7 @@ void memory_report_detailed(MemoryManager* mm) {
         
         block = block->next;
     }
+    pthread_mutex_unlock(&imm->lock);
     
     if (leak_count > 0) {
         printf("Total de blocos ativos: %d (%zu bytes)\n", leak_count, leaked_bytes);
@@ -466,6 +1096,58 @@ void memory_report_detailed(MemoryManager* mm) {
         printf("Nenhum bloco ativo - memória totalmente liberada!\n");
     }
     
+    /* Slots parados nos caches das threads não contam como ocupados */
+    printf("\n--- SLABS POR CLASSE ---\n");
+    pthread_mutex_lock(&imm->lock);
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        SlabClass* cls = &imm->slabs[i];
+        if (cls->chunk_count == 0) continue;
+        
+        int cached = 0;
+        for (MemoryShard* shard = imm->shards; shard; shard = shard->next) {
+            cached += ATOMIC_LOAD(&shard->cache_count[i]);
+        }
+        int in_use = cls->slots_in_use - cached;
+        
+        printf("Classe %4zu bytes: %d/%d slots em uso, %d em cache (%d blocos, %.1f%% de ocupação)\n",
+               cls->slot_size, in_use, cls->slots_total, cached, cls->chunk_count,
+               (double)in_use / cls->slots_total * 100.0);
+    }
+    printf("Memória reservada em slabs: %zu bytes (%.2f KB)\n",
+           imm->slab_reserved, (double)imm->slab_reserved / 1024.0);
+    pthread_mutex_unlock(&imm->lock);
+    
+    /* Fase dona do pico marcada com '<' */
+    if (imm->timeline && imm->phase_count > 0) {
+        uint64_t now = timeline_now_ns();
+        pthread_mutex_lock(&imm->lock);
+        int peak_phase = 0;
+        for (int i = 1; i < imm->phase_count; i++) {
+            if (imm->phases[i].peak_bytes > imm->phases[peak_phase].peak_bytes) peak_phase = i;
+        }
+        
+        printf("\n--- FASES ---\n");
+        printf("%-14s %10s %10s %12s %12s\n", "fase", "início ms", "duração ms", "pico", "no fim");
+        for (int i = 0; i < imm->phase_count; i++) {
+            PhaseStat* phase = &imm->phases[i];
+            int open = phase->end_ns == 0;
+            uint64_t end_ns = open ? now - imm->timeline_origin_ns : phase->end_ns;
+            printf("%-14s %10.3f %10.3f %12zu %12zu%s\n", phase->name,
+                   phase->start_ns / 1e6, (end_ns - phase->start_ns) / 1e6,
+                   phase->peak_bytes, open ? mm->allocated : phase->end_bytes,
+                   i == peak_phase ? " <" : "");
+        }
+        printf("Amostras na linha do tempo: %d", imm->sample_count);
+        if (imm->samples_dropped > 0) printf(" (%d descartadas)", imm->samples_dropped);
+        printf("\n");
+        pthread_mutex_unlock(&imm->lock);
+    }
+    
+    printf("\n--- ARENAS ---\n");
+    printf("Arenas ativas: %d\n", imm->arena_count);
+    printf("Memória reservada em arenas: %zu bytes (%.2f KB)\n",
+           imm->arena_reserved, (double)imm->arena_reserved / 1024.0);
+    
     printf("\n--- EFICIÊNCIA ---\n");
     if (mm->allocation_count > 0) {
         printf("Taxa de liberação: %.1f%% (%d/%d)\n", 
@@ -479,6 +1161,45 @@ void memory_report_detailed(MemoryManager* mm) {
     printf("=====================================\n\n");
 }
 
+/* Conferir listas livres dos slabs: cada slot livre dentro de um bloco
+ * da sua classe e livres + em uso = total recortado */
+static int validate_slabs(InternalMemoryManager* imm) {
+    int errors = 0;
+    
+    pthread_mutex_lock(&imm->lock);
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        SlabClass* cls = &imm->slabs[i];
+        int free_slots = 0;
+        
+        for (SlabFreeSlot* slot = cls->free_list; slot && free_slots <= cls->slots_total;
+             slot = slot->next) {
+            int inside = 0;
+            for (SlabChunk* chunk = cls->chunks; chunk && !inside; chunk = chunk->next) {
+                char* base = (char*)chunk + SLAB_CHUNK_HEADER;
+                char* end = (char*)chunk + chunk->size;
+                inside = (char*)slot >= base && (char*)slot < end &&
+                         (size_t)((char*)slot - base) % cls->slot_size == 0;
+            }
+            if (!inside) {
+                printf("ERRO: Slot livre %p fora dos blocos da classe de %zu bytes\n",
+                       (void*)slot, cls->slot_size);
+                errors++;
+                break;
+            }
+            free_slots++;
+        }
+        
+        if (free_slots + cls->slots_in_use != cls->slots_total) {
+            printf("ERRO: Classe de %zu bytes com %d livres + %d em uso de %d slots\n",
+                   cls->slot_size, free_slots, cls->slots_in_use, cls->slots_total);
+            errors++;
+        }
+    }
+    pthread_mutex_unlock(&imm->lock);
+    
+    return errors;
+}
+
 /* Validar integridade da memória */
 int memory_validate_integrity(MemoryManager* mm) {
     if (!mm) return 0;
@@ -488,7 +1209,42 @@ int memory_validate_integrity(MemoryManager* mm) {
     
     printf("=== VALIDAÇÃO DE INTEGRIDADE ===\n");
     
+    /* Modo off não guarda nada além das arenas */
+    if (!TRACKS_STATS(mm)) {
+        printf("Validação indisponível no modo '%s'\n", memory_mode_name(mm->mode));
+        printf("================================\n\n");
+        return 1;
+    }
+    
+    sync_shard_stats(imm);
+    errors += validate_slabs(imm);
+    
+    /* Bytes em uso devem fechar com o que os fragmentos somaram */
+    size_t allocated = ATOMIC_LOAD(&mm->allocated);
+    if (imm->total_allocated - imm->total_freed != allocated) {
+        printf("ERRO: Contadores divergem do uso atual (%zu - %zu vs %zu bytes)\n",
+               imm->total_allocated, imm->total_freed, allocated);
+        errors++;
+    }
+    if (imm->active_blocks < 0) {
+        printf("ERRO: Contagem de blocos ativos negativa (%d)\n", imm->active_blocks);
+        errors++;
+    }
+    
+    /* Stats não tem lista de blocos: contadores e slabs bastam */
+    if (!TRACKS_BLOCKS(mm)) {
+        if (errors == 0) {
+            printf("Contadores e slabs VALIDADOS (sem verificação por bloco no modo '%s')\n",
+                   memory_mode_name(mm->mode));
+        } else {
+            printf("Validação FALHOU - %d erros encontrados\n", errors);
+        }
+        printf("================================\n\n");
+        return errors == 0;
+    }
+    
     /* Verificar todos os blocos */
+    pthread_mutex_lock(&imm->lock);
     MemoryBlock* block = imm->blocks;
     int block_count = 0;
     
@@ -496,14 +1252,14 @@ int memory_validate_integrity(MemoryManager* mm) {
         block_count++;
         
         /* Verificar guardas de memória */
-        if (!verify_memory_guards(block->ptr, block->size)) {
-            printf("ERRO: Corrupção detectada no bloco %d (%p)\n", block_count, block->ptr);
+        if (!verify_memory_guards(mm, BLOCK_GUARDS(block), block->size)) {
+            printf("ERRO: Corrupção detectada no bloco %d (%p)\n", block_count, BLOCK_USER_PTR(block));
             errors++;
         }
         
-        /* Verificar ponteiro válido */
-        if (!block->ptr) {
-            printf("ERRO: Ponteiro nulo no bloco %d\n", block_count);
+        /* Verificar assinatura do cabeçalho */
+        if (block->magic != MEMORY_BLOCK_MAGIC) {
+            printf("ERRO: Cabeçalho inválido no bloco %d\n", block_count);
             errors++;
         }
         
@@ -515,6 +1271,7 @@ int memory_validate_integrity(MemoryManager* mm) {
         
         block = block->next;
     }
+    pthread_mutex_unlock(&imm->lock);
     
     /* Verificar consistência das estatísticas */
     if (block_count != imm->active_blocks) {
@@ -533,19 +1290,566 @@ int memory_validate_integrity(MemoryManager* mm) {
     return errors == 0;
 }
 
+/* Hash do local de alocação (ponteiros de __FILE__/__func__ são estáveis) */
+static unsigned int profile_hash(const char* file, int line, const char* function) {
+    uintptr_t key = (uintptr_t)file ^ ((uintptr_t)function << 7) ^ (uintptr_t)line * 2654435761u;
+    key ^= key >> 15;
+    return (unsigned int)key;
+}
+
+/* Encontrar ou inserir local na tabela (lock obtido) */
+static int profile_find_locked(InternalMemoryManager* imm, const char* file, int line, const char* function) {
+    if (!file) file = "?";
+    if (!function) function = "?";
+    
+    /* Manter ocupação abaixo de 70% */
+    if ((imm->site_count + 1) * 10 > imm->site_capacity * 7) {
+        int new_capacity = imm->site_capacity ? imm->site_capacity * 2 : PROFILE_MIN_SITES;
+        ProfileSite* new_sites = (ProfileSite*)calloc((size_t)new_capacity, sizeof(ProfileSite));
+        if (!new_sites) return -1;
+        
+        for (int i = 0; i < imm->site_capacity; i++) {
+            ProfileSite* old = &imm->sites[i];
+            if (!old->file) continue;
+            
+            unsigned int slot = profile_hash(old->file, old->line, old->function) & (unsigned int)(new_capacity - 1);
+            while (new_sites[slot].file) {
+                slot = (slot + 1) & (unsigned int)(new_capacity - 1);
+            }
+            new_sites[slot] = *old;
+        }
+        
+        free(imm->sites);
+        imm->sites = new_sites;
+        imm->site_capacity = new_capacity;
+    }
+    
+    unsigned int mask = (unsigned int)(imm->site_capacity - 1);
+    unsigned int slot = profile_hash(file, line, function) & mask;
+    
+    while (imm->sites[slot].file) {
+        ProfileSite* site = &imm->sites[slot];
+        if (site->line == line && site->file == file && site->function == function) {
+            return (int)slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    
+    ProfileSite* site = &imm->sites[slot];
+    memset(site, 0, sizeof(ProfileSite));
+    site->file = file;
+    site->line = line;
+    site->function = function;
+    imm->site_count++;
+    
+    return (int)slot;
+}
+
+/* Índice de um local já conhecido (ou recém-criado) */
+static int profile_site_of(InternalMemoryManager* imm, const char* file, int line, const char* function) {
+    pthread_mutex_lock(&imm->lock);
+    int site = profile_find_locked(imm, file, line, function);
+    pthread_mutex_unlock(&imm->lock);
+    return site;
+}
+
+/* Contabilizar alocação no seu local; retorna o índice do local */
+static int profile_record(InternalMemoryManager* imm, const char* file, int line, const char* function, size_t bytes) {
+    pthread_mutex_lock(&imm->lock);
+    
+    int index = profile_find_locked(imm, file, line, function);
+    if (index >= 0) {
+        ProfileSite* site = &imm->sites[index];
+        site->live_count++;
+        site->live_bytes += bytes;
+        site->total_count++;
+        site->total_bytes += bytes;
+        if (site->live_bytes > site->peak_live_bytes) {
+            site->peak_live_bytes = site->live_bytes;
+        }
+    }
+    
+    pthread_mutex_unlock(&imm->lock);
+    return index;
+}
+
+/* Descontar liberação do local de origem */
+static void profile_release(InternalMemoryManager* imm, int index, size_t bytes) {
+    if (index < 0) return;
+    
+    pthread_mutex_lock(&imm->lock);
+    
+    /* A tabela só cresce por rehash: revalidar índice antigo */
+    if (index < imm->site_capacity && imm->sites[index].file) {
+        ProfileSite* site = &imm->sites[index];
+        if (site->live_count > 0) site->live_count--;
+        site->live_bytes = site->live_bytes >= bytes ? site->live_bytes - bytes : 0;
+    }
+    
+    pthread_mutex_unlock(&imm->lock);
+}
+
+/* Ativar perfil de heap; pilhas dobradas vão para folded_path na saída */
+int memory_profile_enable(MemoryManager* mm, const char* folded_path) {
+    if (!mm) return 0;
+    
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    
+    if (mm->mode == MEMORY_MODE_OFF) {
+        fprintf(stderr, "AVISO: No modo 'off' o perfil de heap registra apenas arenas\n");
+    }
+    
+    pthread_mutex_lock(&imm->lock);
+    free(imm->profile_path);
+    imm->profile_path = NULL;
+    if (folded_path && *folded_path) {
+        size_t len = strlen(folded_path) + 1;
+        imm->profile_path = (char*)malloc(len);
+        if (imm->profile_path) memcpy(imm->profile_path, folded_path, len);
+    }
+    imm->profiling = 1;
+    pthread_mutex_unlock(&imm->lock);
+    
+    return 1;
+}
+
+/* Ordenar locais pelo total acumulado (maior primeiro) */
+static int profile_compare(const void* a, const void* b) {
+    const ProfileSite* sa = (const ProfileSite*)a;
+    const ProfileSite* sb = (const ProfileSite*)b;
+    
+    if (sa->total_bytes != sb->total_bytes) {
+        return sa->total_bytes < sb->total_bytes ? 1 : -1;
+    }
+    return sb->total_count - sa->total_count;
+}
+
+/* Imprimir tabela do perfil e gravar pilhas dobradas (formato flamegraph) */
+int memory_profile_dump(MemoryManager* mm, FILE* table, const char* folded_path) {
+    if (!mm) return 0;
+    
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    
+    /* Copiar locais para ordenar fora da tabela hash */
+    pthread_mutex_lock(&imm->lock);
+    int count = 0;
+    ProfileSite* sites = NULL;
+    if (imm->site_count > 0) {
+        sites = (ProfileSite*)malloc((size_t)imm->site_count * sizeof(ProfileSite));
+        for (int i = 0; sites && i < imm->site_capacity; i++) {
+            if (imm->sites[i].file) sites[count++] = imm->sites[i];
+        }
+    }
+    pthread_mutex_unlock(&imm->lock);
+    
+    if (imm->site_count > 0 && !sites) {
+        fprintf(stderr, "ERRO: Falha ao alocar memória para o perfil de heap\n");
+        return 0;
+    }
+    
+    qsort(sites, (size_t)count, sizeof(ProfileSite), profile_compare);
+    
+    if (table) {
+        fprintf(table, "\n=== PERFIL DE HEAP POR LOCAL DE ALOCAÇÃO ===\n");
+        fprintf(table, "%12s %8s %12s %12s %8s  %s\n",
+                "acumulado", "allocs", "pico vivo", "vivo", "blocos", "local");
+        for (int i = 0; i < count; i++) {
+            ProfileSite* site = &sites[i];
+            if (strcmp(site->file, PROFILE_ARENA_FILE) == 0) {
+                fprintf(table, "%12zu %8d %12zu %12zu %8d  arena '%s'\n",
+                        site->total_bytes, site->total_count, site->peak_live_bytes,
+                        site->live_bytes, site->live_count, site->function);
+            } else {
+                fprintf(table, "%12zu %8d %12zu %12zu %8d  %s (%s:%d)\n",
+                        site->total_bytes, site->total_count, site->peak_live_bytes,
+                        site->live_bytes, site->live_count, site->function,
+                        site->file, site->line);
+            }
+        }
+        fprintf(table, "Locais distintos: %d\n", count);
+        fprintf(table, "============================================\n\n");
+    }
+    
+    int ok = 1;
+    if (folded_path) {
+        FILE* folded = fopen(folded_path, "w");
+        if (!folded) {
+            fprintf(stderr, "ERRO: Não foi possível gravar o perfil de heap em '%s'\n", folded_path);
+            ok = 0;
+        } else {
+            /* Uma linha por local: quadros separados por ';' e peso em bytes */
+            for (int i = 0; i < count; i++) {
+                ProfileSite* site = &sites[i];
+                if (strcmp(site->file, PROFILE_ARENA_FILE) == 0) {
+                    fprintf(folded, "heap;arena;%s %zu\n", site->function, site->total_bytes);
+                } else {
+                    fprintf(folded, "heap;%s;%s:%d %zu\n", site->function, site->file,
+                            site->line, site->total_bytes);
+                }
+            }
+            fclose(folded);
+        }
+    }
+    
+    free(sites);
+    return ok;
+}
+
+/* Relógio monotônico em nanossegundos */
+static uint64_t timeline_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Acrescentar amostra (lock obtido) */
+static void timeline_append_locked(InternalMemoryManager* imm, uint64_t now, size_t allocated) {
+    if (imm->sample_count >= imm->sample_capacity) {
+        if (imm->sample_capacity >= TIMELINE_MAX_SAMPLES) {
+            imm->samples_dropped++;
+            return;
+        }
+        
+        int new_capacity = imm->sample_capacity ? imm->sample_capacity * 2 : 256;
+        if (new_capacity > TIMELINE_MAX_SAMPLES) new_capacity = TIMELINE_MAX_SAMPLES;
+        
+        TimelineSample* samples = (TimelineSample*)realloc(imm->samples, (size_t)new_capacity * sizeof(TimelineSample));
+        if (!samples) {
+            imm->samples_dropped++;
+            return;
+        }
+        imm->samples = samples;
+        imm->sample_capacity = new_capacity;
+    }
+    
+    TimelineSample* sample = &imm->samples[imm->sample_count++];
+    sample->time_ns = now;
+    sample->allocated = allocated;
+    sample->phase = imm->phase_count > 0 ? imm->phases[imm->phase_count - 1].name : "";
+    
+    imm->last_sample_ns = now;
+    imm->last_sample_bytes = allocated;
+}
+
+/* Atualizar pico da fase e amostrar se passou tempo ou o uso mudou bastante */
+static void timeline_note(InternalMemoryManager* imm, size_t allocated) {
+    uint64_t now = timeline_now_ns();
+    
+    pthread_mutex_lock(&imm->lock);
+    
+    now -= imm->timeline_origin_ns;
+    if (imm->phase_count > 0) {
+        PhaseStat* phase = &imm->phases[imm->phase_count - 1];
+        if (allocated > phase->peak_bytes) phase->peak_bytes = allocated;
+    }
+    
+    size_t delta = allocated > imm->last_sample_bytes ? allocated - imm->last_sample_bytes
+                                                      : imm->last_sample_bytes - allocated;
+    if (now - imm->last_sample_ns >= TIMELINE_MIN_INTERVAL_NS || delta >= TIMELINE_MIN_DELTA) {
+        timeline_append_locked(imm, now, allocated);
+    }
+    
+    pthread_mutex_unlock(&imm->lock);
+}
+
+/* Ativar linha do tempo; exportada em path na saída (NULL = só relatório) */
+int memory_timeline_enable(MemoryManager* mm, const char* path) {
+    if (!mm) return 0;
+    
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    
+    pthread_mutex_lock(&imm->lock);
+    free(imm->timeline_path);
+    imm->timeline_path = NULL;
+    if (path && *path) {
+        size_t len = strlen(path) + 1;
+        imm->timeline_path = (char*)malloc(len);
+        if (imm->timeline_path) memcpy(imm->timeline_path, path, len);
+    }
+    
+    if (!imm->timeline) {
+        imm->timeline = 1;
+        imm->timeline_origin_ns = timeline_now_ns();
+        timeline_append_locked(imm, 0, ATOMIC_LOAD(&mm->allocated));
+    }
+    pthread_mutex_unlock(&imm->lock);
+    
+    return 1;
+}
+
+/* Marcar início de uma fase (nome deve ser um literal ou viver até o fim) */
+void memory_set_phase(MemoryManager* mm, const char* phase) {
+    if (!mm || !phase) return;
+    
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    if (!imm->timeline) return;
+    
+    size_t allocated = ATOMIC_LOAD(&mm->allocated);
+    uint64_t now = timeline_now_ns();
+    
+    pthread_mutex_lock(&imm->lock);
+    now -= imm->timeline_origin_ns;
+    if (now == 0) now = 1;
+    
+    if (imm->phase_count > 0) {
+        PhaseStat* current = &imm->phases[imm->phase_count - 1];
+        current->end_ns = now;
+        current->end_bytes = allocated;
+    }
+    
+    /* Tabela cheia: a última fase absorve as seguintes */
+    if (imm->phase_count < TIMELINE_MAX_PHASES) {
+        PhaseStat* next = &imm->phases[imm->phase_count++];
+        next->name = phase;
+        next->start_ns = now;
+        next->end_ns = 0;
+        next->start_bytes = allocated;
+        next->peak_bytes = allocated;
+        next->end_bytes = 0;
+    } else {
+        imm->phases[imm->phase_count - 1].end_ns = 0;
+    }
+    
+    timeline_append_locked(imm, now, allocated);
+    pthread_mutex_unlock(&imm->lock);
+}
+
+/* Exportar linha do tempo: JSON se o arquivo terminar em .json, senão CSV */
+int memory_timeline_export(MemoryManager* mm, const char* path) {
+    if (!mm || !path) return 0;
+    
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "ERRO: Não foi possível gravar a linha do tempo em '%s'\n", path);
+        return 0;
+    }
+    
+    size_t len = strlen(path);
+    int json = len >= 5 && strcmp(path + len - 5, ".json") == 0;
+    
+    pthread_mutex_lock(&imm->lock);
+    if (json) {
+        fprintf(out, "{\n  \"limite\": %zu,\n  \"amostras\": [\n", mm->limit);
+        for (int i = 0; i < imm->sample_count; i++) {
+            TimelineSample* sample = &imm->samples[i];
+            fprintf(out, "    {\"tempo_ms\": %.3f, \"fase\": \"%s\", \"bytes\": %zu}%s\n",
+                    sample->time_ns / 1e6, sample->phase, sample->allocated,
+                    i + 1 < imm->sample_count ? "," : "");
+        }
+        fprintf(out, "  ],\n  \"fases\": [\n");
+        for (int i = 0; i < imm->phase_count; i++) {
+            PhaseStat* phase = &imm->phases[i];
+            fprintf(out, "    {\"nome\": \"%s\", \"inicio_ms\": %.3f, \"fim_ms\": %.3f, "
+                         "\"bytes_inicio\": %zu, \"pico\": %zu, \"bytes_fim\": %zu}%s\n",
+                    phase->name, phase->start_ns / 1e6, phase->end_ns / 1e6,
+                    phase->start_bytes, phase->peak_bytes, phase->end_bytes,
+                    i + 1 < imm->phase_count ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    } else {
+        fprintf(out, "tempo_ms,fase,bytes\n");
+        for (int i = 0; i < imm->sample_count; i++) {
+            TimelineSample* sample = &imm->samples[i];
+            fprintf(out, "%.3f,%s,%zu\n", sample->time_ns / 1e6, sample->phase, sample->allocated);
+        }
+    }
+    pthread_mutex_unlock(&imm->lock);
+    
+    fclose(out);
+    return 1;
+}
+
+/* Criar bloco novo para a arena, contabilizado no limite */
+static MemoryArenaChunk* arena_new_chunk(MemoryArena* arena, size_t size) {
+    MemoryManager* mm = arena->mm;
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    size_t total_size = ARENA_CHUNK_HEADER + size;
+    
+    size_t allocated;
+    if (!reserve_limit(mm, total_size, &allocated)) {
+        error_report(ERROR_MEMORY, 0, 0, "Memória Insuficiente");
+        return NULL;
+    }
+    
+    MemoryArenaChunk* chunk = (MemoryArenaChunk*)malloc(total_size);
+    if (!chunk) {
+        ATOMIC_SUB(&mm->allocated, total_size);
+        error_report(ERROR_MEMORY, 0, 0, "Falha na alocação de memória do sistema");
+        return NULL;
+    }
+    
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    
+    /* Atualizar estatísticas */
+    ATOMIC_ADD(&imm->arena_reserved, total_size);
+    arena->reserved += total_size;
+    
+    /* Blocos de arena aparecem no perfil pelo nome da arena */
+    if (imm->profiling) {
+        profile_record(imm, PROFILE_ARENA_FILE, 0, arena->name, total_size);
+    }
+    
+    if (TRACKS_STATS(mm)) {
+        MemoryShard* shard = shard_for_thread(imm);
+        if (shard) {
+            ATOMIC_ADD(&shard->allocation_count, 1);
+            ATOMIC_ADD(&shard->total_allocated, total_size);
+        }
+        record_peak_usage(mm, allocated);
+    }
+    TIMELINE_NOTE(imm, allocated);
+    
+    return chunk;
+}
+
+/* Criar arena associada ao gerenciador */
+MemoryArena* memory_arena_create(MemoryManager* mm, const char* name, size_t chunk_size) {
+    if (!mm) return NULL;
+    
+    MemoryArena* arena = (MemoryArena*)MEMORY_ALLOC(mm, sizeof(MemoryArena));
+    if (!arena) return NULL;
+    
+    arena->mm = mm;
+    arena->name = name;
+    arena->chunks = NULL;
+    arena->current = NULL;
+    arena->chunk_size = chunk_size > 0 ? ARENA_ALIGN(chunk_size) : MEMORY_ARENA_CHUNK_SIZE;
+    arena->reserved = 0;
+    arena->used = 0;
+    
+    ATOMIC_ADD(&((InternalMemoryManager*)mm)->arena_count, 1);
+    
+    if (DEBUG_MEMORY) {
+        printf("DEBUG: Arena '%s' criada (blocos de %zu bytes)\n", name, arena->chunk_size);
+    }
+    
+    return arena;
+}
+
+/* Alocar da arena (sem liberação individual) */
+void* memory_arena_alloc(MemoryArena* arena, size_t size) {
+    if (!arena || size == 0) return NULL;
+    
+    size = ARENA_ALIGN(size);
+    
+    /* Procurar bloco com espaço a partir do atual (blocos reaproveitados após reset) */
+    MemoryArenaChunk* chunk = arena->current;
+    MemoryArenaChunk* last = chunk;
+    while (chunk && chunk->used + size > chunk->size) {
+        last = chunk;
+        chunk = chunk->next;
+        if (chunk) chunk->used = 0;
+    }
+    
+    if (!chunk) {
+        chunk = arena_new_chunk(arena, size > arena->chunk_size ? size : arena->chunk_size);
+        if (!chunk) return NULL;
+        
+        if (last) {
+            last->next = chunk;
+        } else {
+            arena->chunks = chunk;
+        }
+    }
+    
+    arena->current = chunk;
+    void* ptr = (char*)chunk + ARENA_CHUNK_HEADER + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    
+    return ptr;
+}
+
+/* Duplicar string dentro da arena */
+char* memory_arena_strdup(MemoryArena* arena, const char* str) {
+    if (!str) return NULL;
+    
+    size_t len = strlen(str) + 1;
+    char* copy = (char*)memory_arena_alloc(arena, len);
+    if (copy) {
+        memcpy(copy, str, len);
+    }
+    
+    return copy;
+}
+
+/* Liberar lista de blocos devolvendo a contabilização */
+static void arena_free_chunks(MemoryArena* arena, MemoryArenaChunk* chunk) {
+    MemoryManager* mm = arena->mm;
+    InternalMemoryManager* imm = (InternalMemoryManager*)mm;
+    MemoryShard* shard = TRACKS_STATS(mm) && chunk ? shard_for_thread(imm) : NULL;
+    
+    while (chunk) {
+        MemoryArenaChunk* next = chunk->next;
+        size_t total_size = ARENA_CHUNK_HEADER + chunk->size;
+        
+        size_t allocated = ATOMIC_SUB(&mm->allocated, total_size);
+        ATOMIC_SUB(&imm->arena_reserved, total_size);
+        TIMELINE_NOTE(imm, allocated);
+        if (shard) {
+            ATOMIC_ADD(&shard->deallocation_count, 1);
+            ATOMIC_ADD(&shard->total_freed, total_size);
+        }
+        arena->reserved -= total_size;
+        
+        if (imm->profiling) {
+            profile_release(imm, profile_site_of(imm, PROFILE_ARENA_FILE, 0, arena->name), total_size);
+        }
+        
+        free(chunk);
+        chunk = next;
+    }
+}
+
+/* Descartar todas as alocações de uma vez. Apenas o primeiro bloco é
+ * mantido para reuso, para não segurar memória do limite entre fases */
+void memory_arena_reset(MemoryArena* arena) {
+    if (!arena) return;
+    
+    if (arena->chunks) {
+        arena_free_chunks(arena, arena->chunks->next);
+        arena->chunks->next = NULL;
+        arena->chunks->used = 0;
+    }
+    
+    arena->current = arena->chunks;
+    arena->used = 0;
+}
+
+/* Destruir arena e devolver seus blocos */
+void memory_arena_destroy(MemoryArena* arena) {
+    if (!arena) return;
+    
+    MemoryManager* mm = arena->mm;
+    size_t reserved = arena->reserved;
+    
+    arena_free_chunks(arena, arena->chunks);
+    ATOMIC_SUB(&((InternalMemoryManager*)mm)->arena_count, 1);
+    
+    if (DEBUG_MEMORY) {
+        printf("DEBUG: Arena '%s' destruída (%zu bytes devolvidos)\n", arena->name, reserved);
+    }
+    
+    memory_free(mm, arena);
+}
+
 /* Expor uso atual de memória do processo */
 size_t memory_get_process_usage(void) {
     return get_current_process_memory();
 }
 
 /* Funções auxiliares */
-static void poison_memory(void* ptr, size_t size) {
-    if (DEBUG_MEMORY) {
-        uint32_t* int_ptr = (uint32_t*)ptr;
-        size_t int_count = size / sizeof(uint32_t);
-        for (size_t i = 0; i < int_count; i++) {
-            int_ptr[i] = MEMORY_POISON_VALUE;
-        }
+static void poison_memory(const MemoryManager* mm, void* ptr, size_t size) {
+    if (!TRACKS_BLOCKS(mm)) return;
+    
+    uint32_t pattern = MEMORY_POISON_VALUE;
+    size_t int_count = size / sizeof(uint32_t);
+    for (size_t i = 0; i < int_count; i++) {
+        memcpy((char*)ptr + i * sizeof(uint32_t), &pattern, sizeof(uint32_t));
     }
 }
 
@@ -564,43 +1868,30 @@ static int check_memory_corruption(void* ptr, size_t size) {
     return 0; /* Nenhuma corrupção detectada */
 }
 
-static void add_memory_guards(void* ptr, size_t size) {
-    if (!DEBUG_MEMORY) return;
-    
-    uint32_t guard_pattern = 0xDEADC0DE;
-    size_t guard_ints = MEMORY_GUARD_SIZE / sizeof(uint32_t);
+/* Guardas podem ficar desalinhadas no final do bloco: copiar byte a byte */
+static const unsigned char guard_pattern[4] = {0xDE, 0xC0, 0xAD, 0xDE};
+
+static void add_memory_guards(const MemoryManager* mm, void* ptr, size_t size) {
+    if (!TRACKS_BLOCKS(mm)) return;
     
-    /* Guarda no início */
-    uint32_t* start_guard = (uint32_t*)ptr;
-    for (size_t i = 0; i < guard_ints; i++) {
-        start_guard[i] = guard_pattern;
-    }
+    char* start_guard = (char*)ptr;
+    char* end_guard = (char*)ptr + MEMORY_GUARD_SIZE + size;
     
-    /* Guarda no final */
-    uint32_t* end_guard = (uint32_t*)((char*)ptr + MEMORY_GUARD_SIZE + size);
-    for (size_t i = 0; i < guard_ints; i++) {
-        end_guard[i] = guard_pattern;
+    for (size_t i = 0; i < MEMORY_GUARD_SIZE; i += sizeof(guard_pattern)) {
+        memcpy(start_guard + i, guard_pattern, sizeof(guard_pattern));
+        memcpy(end_guard + i, guard_pattern, sizeof(guard_pattern));
     }
 }
 
-static int verify_memory_guards(void* ptr, size_t size) {
-    if (!DEBUG_MEMORY) return 1;
+static int verify_memory_guards(const MemoryManager* mm, void* ptr, size_t size) {
+    if (!TRACKS_BLOCKS(mm)) return 1;
     
-    uint32_t guard_pattern = 0xDEADC0DE;
-    size_t guard_ints = MEMORY_GUARD_SIZE / sizeof(uint32_t);
+    const char* start_guard = (const char*)ptr;
+    const char* end_guard = (const char*)ptr + MEMORY_GUARD_SIZE + size;
     
-    /* Verificar guarda no início */
-    uint32_t* start_guard = (uint32_t*)ptr;
-    for (size_t i = 0; i < guard_ints; i++) {
-        if (start_guard[i] != guard_pattern) {
-            return 0;
-        }
-    }
-    
-    /* Verificar guarda no final */
-    uint32_t* end_guard = (uint32_t*)((char*)ptr + MEMORY_GUARD_SIZE + size);
-    for (size_t i = 0; i < guard_ints; i++) {
-        if (end_guard[i] != guard_pattern) {
+    for (size_t i = 0; i < MEMORY_GUARD_SIZE; i += sizeof(guard_pattern)) {
+        if (memcmp(start_guard + i, guard_pattern, sizeof(guard_pattern)) != 0 ||
+            memcmp(end_guard + i, guard_pattern, sizeof(guard_pattern)) != 0) {
             return 0;
         }
     }
@@ -632,24 +1923,47 @@ static void calculate_fragmentation(InternalMemoryManager* imm) {
     }
 }
 
-/* Obter uso atual de memória do processo */
+/* Descritor de /proc/self/statm aberto uma única vez e lido com pread */
+static int g_statm_fd = -1;
+static long g_page_size = 0;
+static pthread_once_t g_statm_once = PTHREAD_ONCE_INIT;
+
+static void open_statm(void) {
+    g_statm_fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    g_page_size = sysconf(_SC_PAGESIZE);
+}
+
+/* Obter uso atual de memória do processo (RSS) */
 static size_t get_current_process_memory(void) {
-    FILE* f = fopen("/proc/self/statm", "r");
-    if (!f) return 0;
-    long rss = 0;
-    if (fscanf(f, "%*s %ld", &rss) != 1) {
-        fclose(f);
-        return 0;
-    }
-    fclose(f);
-    long page_size = sysconf(_SC_PAGESIZE);
-    return (size_t)rss * (size_t)page_size;
+    pthread_once(&g_statm_once, open_statm);
+    if (g_statm_fd < 0) return 0;
+    
+    /* Formato: tamanho residente compartilhado ... (em páginas) */
+    char buffer[128];
+    ssize_t length = pread(g_statm_fd, buffer, sizeof(buffer) - 1, 0);
+    if (length <= 0) return 0;
+    buffer[length] = '\0';
+    
+    char* cursor = strchr(buffer, ' ');
+    if (!cursor) return 0;
+    
+    unsigned long rss = strtoul(cursor + 1, NULL, 10);
+    return (size_t)rss * (size_t)g_page_size;
 }
 
-/* Atualizar pico de memória do processo */
+/* Atualizar pico de memória do processo: o kernel já mantém o máximo */
 static void update_process_peak_usage(MemoryManager* mm) {
+    size_t peak = 0;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        peak = (size_t)usage.ru_maxrss * 1024; /* ru_maxrss vem em KB no Linux */
+    }
+    
+    /* Contadores do kernel são sincronizados com atraso: não ficar abaixo do atual */
     size_t current = get_current_process_memory();
-    if (current > mm->process_peak_usage) {
-        mm->process_peak_usage = current;
+    if (current > peak) peak = current;
+    
+    if (peak > mm->process_peak_usage) {
+        mm->process_peak_usage = peak;
     }
 }
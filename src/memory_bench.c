@@ -0,0 +1,126 @@
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime */
+#include "../include/compiler.h"
+#include <pthread.h>
+
+/* Quantidade de ponteiros vivos mantidos pela carga de trabalho */
+#define BENCH_LIVE_SLOTS 128
+
+/* Tamanhos representativos das alocações do compilador */
+static const size_t bench_sizes[] = {16, 24, 48, 64, 96, 200, 300, 512, 1000};
+#define BENCH_SIZE_COUNT (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+
+/* Tempo de parede em segundos: clock() somaria a CPU de todas as threads */
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Executar carga mista de alloc/realloc/free; retorna segundos decorridos */
+static double bench_run(MemoryManager* mm, int iterations) {
+    void* live[BENCH_LIVE_SLOTS] = {0};
+    unsigned int seed = 12345u;
+
+    double start = bench_now();
+
+    for (int i = 0; i < iterations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int slot = (int)((seed >> 8) % BENCH_LIVE_SLOTS);
+        size_t size = bench_sizes[(seed >> 16) % BENCH_SIZE_COUNT];
+
+        if (!live[slot]) {
+            live[slot] = mm ? memory_alloc(mm, size) : malloc(size);
+        } else if ((seed >> 24) % 4 == 0) {
+            void* grown = mm ? memory_realloc(mm, live[slot], size * 2)
+                             : realloc(live[slot], size * 2);
+            if (grown) live[slot] = grown;
+        } else {
+            if (mm) memory_free(mm, live[slot]); else free(live[slot]);
+            live[slot] = NULL;
+        }
+    }
+
+    for (int i = 0; i < BENCH_LIVE_SLOTS; i++) {
+        if (!live[i]) continue;
+        if (mm) memory_free(mm, live[i]); else free(live[i]);
+    }
+
+    return bench_now() - start;
+}
+
+/* Threads concorrentes no teste compartilhado */
+#define BENCH_THREADS 4
+
+typedef struct {
+    MemoryManager* mm;
+    int iterations;
+} BenchThread;
+
+static void* bench_thread_main(void* arg) {
+    BenchThread* job = (BenchThread*)arg;
+    bench_run(job->mm, job->iterations);
+    memory_thread_release(job->mm);
+    return NULL;
+}
+
+/* Mesma carga dividida entre threads sobre um único gerenciador */
+static double bench_run_threads(MemoryManager* mm, int iterations) {
+    pthread_t threads[BENCH_THREADS];
+    BenchThread jobs[BENCH_THREADS];
+    int started = 0;
+
+    double start = bench_now();
+
+    for (int i = 0; i < BENCH_THREADS; i++) {
+        jobs[i].mm = mm;
+        jobs[i].iterations = iterations / BENCH_THREADS;
+        if (pthread_create(&threads[i], NULL, bench_thread_main, &jobs[i]) == 0) {
+            started++;
+        }
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    return bench_now() - start;
+}
+
+/* Medir custo de cada modo do gerenciador contra malloc puro */
+void memory_benchmark(int iterations) {
+    if (iterations <= 0) iterations = 1000000;
+
+    printf("=== BENCHMARK DO GERENCIADOR DE MEMÓRIA ===\n");
+    printf("Operações por modo: %d (%d ponteiros vivos)\n\n", iterations, BENCH_LIVE_SLOTS);
+
+    double baseline = bench_run(NULL, iterations);
+    printf("%-8s %10.3f s %8.1f ns/op\n", "malloc", baseline,
+           baseline * 1e9 / iterations);
+
+    for (int mode = MEMORY_MODE_OFF; mode <= MEMORY_MODE_DEBUG; mode++) {
+        CompilerConfig config = g_config;
+        config.memory_mode = (MemoryMode)mode;
+        MemoryManager* mm = memory_manager_create_with_config(&config);
+        if (!mm) continue;
+
+        double elapsed = bench_run(mm, iterations);
+        memory_manager_discard(mm);
+
+        printf("%-8s %10.3f s %8.1f ns/op (%.2fx malloc)\n",
+               memory_mode_name((MemoryMode)mode), elapsed,
+               elapsed * 1e9 / iterations,
+               baseline > 0.0 ? elapsed / baseline : 0.0);
+    }
+
+    /* Contadores fragmentados precisam fechar após uso concorrente */
+    CompilerConfig shared_config = g_config;
+    shared_config.memory_mode = MEMORY_MODE_STATS;
+    MemoryManager* shared = memory_manager_create_with_config(&shared_config);
+    if (shared) {
+        double elapsed = bench_run_threads(shared, iterations);
+        printf("%-8s %10.3f s %8.1f ns/op (%d threads, modo stats)\n", "threads", elapsed,
+               elapsed * 1e9 / iterations, BENCH_THREADS);
+        memory_manager_discard(shared);
+    }
+
+    printf("===========================================\n");
+}
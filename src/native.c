@@ -0,0 +1,268 @@
+#define _POSIX_C_SOURCE 200809L  /* fork, execvp, waitpid, mkdir */
+#include "../include/compiler.h"
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* Runtime ligado aos executáveis nativos: entrada e saída com o mesmo
+ * formato do interpretador e as operações de texto usadas pelo assembly.
+ * Compilado uma vez por diretório de cache */
+static const char native_runtime_source[] =
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <stdint.h>\n"
+    "#include <inttypes.h>\n"
+    "\n"
+    "void rt_escreva_inteiro(int64_t valor) { printf(\"%\" PRId64, valor); }\n"
+    "void rt_escreva_decimal(double valor) { printf(\"%.2f\", valor); }\n"
+    "void rt_escreva_texto(const char* valor) { fputs(valor, stdout); }\n"
+    "void rt_escreva_fim(void) { putchar('\\n'); }\n"
+    "\n"
+    "static void rt_pedir_valor(void) {\n"
+    "    printf(\"Digite um valor: \");\n"
+    "    fflush(stdout);\n"
+    "}\n"
+    "\n"
+    "void rt_leia_inteiro(int64_t* destino) {\n"
+    "    rt_pedir_valor();\n"
+    "    if (scanf(\"%\" SCNd64, destino) != 1) return;\n"
+    "}\n"
+    "\n"
+    "void rt_leia_decimal(double* destino) {\n"
+    "    rt_pedir_valor();\n"
+    "    if (scanf(\"%lf\", destino) != 1) return;\n"
+    "}\n"
+    "\n"
+    "void rt_leia_texto(char* destino, int tamanho) {\n"
+    "    char formato[32];\n"
+    "    rt_pedir_valor();\n"
+    "    snprintf(formato, sizeof(formato), \"%%%ds\", tamanho - 1);\n"
+    "    if (scanf(formato, destino) != 1) return;\n"
+    "}\n"
+    "\n"
+    "void rt_texto_copia(char* destino, const char* origem, int tamanho) {\n"
+    "    int i = 0;\n"
+    "    if (destino == origem) return;\n"
+    "    for (; origem[i] && i < tamanho - 1; i++) destino[i] = origem[i];\n"
+    "    destino[i] = '\\0';\n"
+    "}\n"
+    "\n"
+    "int rt_texto_compara(const char* a, const char* b) {\n"
+    "    while (*a && *a == *b) { a++; b++; }\n"
+    "    return (unsigned char)*a - (unsigned char)*b;\n"
+    "}\n"
+    "\n"
+    "void rt_erro(const char* mensagem) {\n"
+    "    printf(\"ERRO DE EXECUÇÃO: %s\\n\", mensagem);\n"
+    "    exit(1);\n"
+    "}\n";
+
+/* FNV-1a de 64 bits, continuando a partir de um hash anterior */
+static uint64_t native_hash(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Montar caminho no diretório do cache; 0 se não couber */
+static int native_path(char* out, const char* dir, const char* name, const char* suffix) {
+    int written = snprintf(out, NATIVE_PATH_LENGTH, "%s/%s%s", dir, name, suffix);
+    return written > 0 && written < NATIVE_PATH_LENGTH;
+}
+
+/* Caminho de arquivo intermediário, exclusivo deste processo: dois
+ * processos compilando no mesmo cache não escrevem no mesmo arquivo */
+static int native_temp_path(char* out, const char* dir, const char* name, const char* suffix) {
+    int written = snprintf(out, NATIVE_PATH_LENGTH, "%s/%s.%ld%s", dir, name, (long)getpid(), suffix);
+    return written > 0 && written < NATIVE_PATH_LENGTH;
+}
+
+/* Calcular a chave do fonte e os caminhos do executável no cache.
+ * A chave cobre a versão dos geradores e do compilador que os construiu,
+ * o backend, o tamanho dos textos e o próprio runtime; assim um
+ * executável gerado por uma versão anterior nunca é reaproveitado */
+int native_build_init(NativeBuild* build, const char* dir, const char* backend, const char* source) {
+    if (!build || !dir || !backend || !source) return 0;
+
+    memset(build, 0, sizeof(NativeBuild));
+    static const char version[] = NATIVE_CODEGEN_VERSION " " __VERSION__;
+    uint64_t hash = 14695981039346656037ULL;
+    hash = native_hash(hash, version, sizeof(version));
+    hash = native_hash(hash, backend, strlen(backend) + 1);
+    hash = native_hash(hash, &g_config.max_string_length, sizeof(g_config.max_string_length));
+    hash = native_hash(hash, native_runtime_source, sizeof(native_runtime_source));
+    hash = native_hash(hash, source, strlen(source));
+    snprintf(build->key, sizeof(build->key), "%016llx", (unsigned long long)hash);
+
+    uint64_t runtime_hash = native_hash(14695981039346656037ULL, native_runtime_source,
+                                        sizeof(native_runtime_source));
+    char runtime_name[32];
+    snprintf(runtime_name, sizeof(runtime_name), "runtime-%016llx", (unsigned long long)runtime_hash);
+
+    if (strlen(dir) >= NATIVE_PATH_LENGTH ||
+        !native_path(build->executable, dir, build->key, "") ||
+        !native_path(build->runtime, dir, runtime_name, ".o")) {
+        error_report(ERROR_RUNTIME, 0, 0, "Caminho do cache nativo muito longo");
+        return 0;
+    }
+    strcpy(build->dir, dir);
+    build->backend = backend;
+    return 1;
+}
+
+/* Executável já compilado para este fonte */
+int native_build_cached(const NativeBuild* build) {
+    return build && build->executable[0] && access(build->executable, X_OK) == 0;
+}
+
+/* Executar processo e aguardar; retorna o código de saída ou -1 */
+int native_run_process(char* const argv[]) {
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* Criar o diretório do cache (um nível) */
+static int native_ensure_dir(const char* dir) {
+    if (mkdir(dir, 0755) == 0 || errno == EEXIST) return 1;
+    error_report(ERROR_RUNTIME, 0, 0, "Falha ao criar diretório do cache nativo");
+    return 0;
+}
+
+/* Compilar o runtime para um objeto no cache, se ainda não existir.
+ * Fonte e objeto são do processo; o objeto é renomeado só no fim, para
+ * que um processo interrompido não deixe objeto incompleto no cache */
+static int native_ensure_runtime(const NativeBuild* build) {
+    if (access(build->runtime, R_OK) == 0) return 1;
+
+    char source_path[NATIVE_PATH_LENGTH];
+    char temp_path[NATIVE_PATH_LENGTH];
+    if (!native_temp_path(source_path, build->dir, "runtime", ".c") ||
+        !native_temp_path(temp_path, build->dir, "runtime", ".o.tmp")) {
+        return 0;
+    }
+
+    FILE* file = fopen(source_path, "w");
+    if (!file) {
+        error_report(ERROR_RUNTIME, 0, 0, "Falha ao gravar runtime nativo");
+        return 0;
+    }
+    fputs(native_runtime_source, file);
+    fclose(file);
+
+    char* argv[] = {NATIVE_CC, "-std=c99", "-O2", "-c", source_path, "-o", temp_path, NULL};
+    int ok = native_run_process(argv) == 0 && rename(temp_path, build->runtime) == 0;
+    remove(source_path);
+    if (!ok) {
+        remove(temp_path);
+        error_report(ERROR_RUNTIME, 0, 0, "Falha ao compilar runtime nativo");
+        return 0;
+    }
+    return 1;
+}
+
+/* Gerador de código de cada backend e extensão do arquivo gerado */
+typedef struct {
+    const char* name;
+    const char* suffix;
+    int (*emit)(ASTNode* program, FILE* out);
+} NativeBackend;
+
+static const NativeBackend native_backends[] = {
+    {"c", ".c", codegen_c_emit},
+    {"asm", ".s", codegen_asm_emit}
+};
+
+/* Backend pelo nome (c ou asm), NULL se desconhecido */
+static const NativeBackend* native_find_backend(const char* name) {
+    for (size_t i = 0; i < sizeof(native_backends) / sizeof(native_backends[0]); i++) {
+        if (strcmp(native_backends[i].name, name) == 0) return &native_backends[i];
+    }
+    return NULL;
+}
+
+int native_backend_valid(const char* name) {
+    return name && native_find_backend(name) != NULL;
+}
+
+/* Gerar o código do programa (C ou assembly x86-64), compilar ou montar
+ * com o gcc do sistema e ligar ao runtime. O executável só entra no
+ * cache depois de ligado por completo; o código gerado fica ao lado dele,
+ * com o nome da chave, para inspeção */
+int native_build(NativeBuild* build, ASTNode* program) {
+    const NativeBackend* backend = build ? native_find_backend(build->backend) : NULL;
+    if (!backend || !program || !native_ensure_dir(build->dir)) return 0;
+
+    char source_path[NATIVE_PATH_LENGTH];
+    char temp_path[NATIVE_PATH_LENGTH];
+    char kept_path[NATIVE_PATH_LENGTH];
+    if (!native_temp_path(source_path, build->dir, build->key, backend->suffix) ||
+        !native_temp_path(temp_path, build->dir, build->key, ".tmp") ||
+        !native_path(kept_path, build->dir, build->key, backend->suffix)) {
+        return 0;
+    }
+
+    FILE* file = fopen(source_path, "w");
+    if (!file) {
+        error_report(ERROR_RUNTIME, 0, 0, "Falha ao gravar código gerado");
+        return 0;
+    }
+    int emitted = backend->emit(program, file);
+    if (fclose(file) != 0) emitted = 0;
+    if (!emitted) {
+        remove(source_path);
+        error_report(ERROR_RUNTIME, 0, 0, "Falha ao gerar código nativo");
+        return 0;
+    }
+
+    if (!native_ensure_runtime(build)) {
+        remove(source_path);
+        return 0;
+    }
+
+    char* argv[] = {NATIVE_CC, "-std=c99", "-O2", "-o", temp_path, source_path, build->runtime, "-lm", NULL};
+    int ok = native_run_process(argv) == 0 && rename(temp_path, build->executable) == 0;
+    if (rename(source_path, kept_path) != 0) remove(source_path);
+    if (!ok) {
+        remove(temp_path);
+        error_report(ERROR_RUNTIME, 0, 0, "Falha ao compilar código gerado");
+        return 0;
+    }
+
+    printf("Executável gerado: %s\n", build->executable);
+    return 1;
+}
+
+/* Executar o programa nativo com os mesmos avisos do interpretador; o
+ * próprio executável imprime a mensagem de erro de execução */
+int native_execute(const NativeBuild* build) {
+    if (!build) return 0;
+
+    printf("=== INICIANDO EXECUÇÃO ===\n");
+    char* argv[] = {(char*)build->executable, NULL};
+    int status = native_run_process(argv);
+    if (status != 0) {
+        if (status < 0) printf("ERRO DE EXECUÇÃO: Falha ao executar %s\n", build->executable);
+        return 0;
+    }
+
+    printf("=== EXECUÇÃO CONCLUÍDA COM SUCESSO ===\n");
+    return 1;
+}
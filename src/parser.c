@@ -1,13 +1,58 @@
 #include "../include/compiler.h"
+#include <pthread.h>
+
+/* Erro sintático guardado para impressão em ordem */
+typedef struct {
+    int line;
+    int column;
+    char message[MAX_ERROR_MESSAGE_LENGTH];
+} ParseDiagnostic;
+
+/* Definição de nível superior analisada por um trabalhador */
+typedef struct ParseJob {
+    SourceRange range;
+    ASTNode* function;          /* NULL se a análise falhou (ou não foi feita) */
+    ParseDiagnostic* errors;
+    int error_count;
+    int error_capacity;
+} ParseJob;
+
+/* Definições contíguas analisadas por um trabalhador na mesma arena */
+typedef struct {
+    int first_job;
+    int job_count;
+    MemoryArena* arena;         /* Nós das definições do trecho */
+} ParseSpan;
+
+/* Fila compartilhada da análise paralela */
+typedef struct {
+    const char* source;
+    ParseJob* jobs;
+    ParseSpan* spans;
+    int span_count;
+    int next_span;              /* Próximo trecho livre (atômico) */
+} ParsePool;
+
+/* Programa montado direto na AST plana, uma definição por vez */
+typedef struct {
+    FlatASTBuilder* builder;
+    ASTIndex* functions;        /* Definições copiadas, na ordem do fonte */
+    int function_count;
+    int function_capacity;
+    InternId* calls;            /* Chamadas dos corpos já analisados (modo sob demanda) */
+    int call_count;
+    int call_capacity;
+} ProgramStream;
 
 /* Declarações de funções estáticas */
 static int match_token(Parser* parser, TokenType expected);
 static int consume_token(Parser* parser, TokenType expected);
 static int expect_token(Parser* parser, TokenType expected);
 static ASTNode* create_node(Parser* parser, ASTNodeType type);
-static ASTNode* parse_program(Parser* parser);
+static FlatAST* parse_program(Parser* parser);
 static ASTNode* parse_main_function(Parser* parser);
 static ASTNode* parse_function(Parser* parser);
+static int parse_function_body(Parser* parser, ASTNode* func);
 static ASTNode* parse_block(Parser* parser);
 static ASTNode* parse_statement(Parser* parser);
 static ASTNode* parse_var_declaration(Parser* parser);
@@ -20,11 +65,12 @@ static ASTNode* parse_return_statement(Parser* parser);
 static ASTNode* parse_io_statement(Parser* parser);
 static ASTNode* parse_assignment(Parser* parser);
 static ASTNode* parse_function_call(Parser* parser);
+static ASTNode* parse_call(Parser* parser);
 static int parse_type_dimensions(Parser* parser, TypeInfo* type_info);
 
 /* Criar parser */
 Parser* parser_create(Lexer* lexer) {
-    Parser* parser = (Parser*)memory_alloc(g_memory_manager, sizeof(Parser));
+    Parser* parser = (Parser*)MEMORY_ALLOC(g_memory_manager, sizeof(Parser));
     if (!parser) {
         error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar parser");
         return NULL;
@@ -35,6 +81,20 @@ Parser* parser_create(Lexer* lexer) {
     parser->ast = NULL;
     parser->error_count = 0;
     parser->current_scope = 0;
+    parser->job = NULL;
+    parser->scope_names = NULL;
+    parser->scope_name_count = 0;
+    parser->scope_name_capacity = 0;
+    parser->scope_base = 0;
+    
+    /* Nós da árvore sintática são alocados na arena da fase */
+    parser->arena = memory_arena_create(g_memory_manager, "parser", 0);
+    if (!parser->arena) {
+        symbol_table_destroy(parser->symbol_table);
+        memory_free(g_memory_manager, parser);
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar arena do parser");
+        return NULL;
+    }
     
     return parser;
 }
@@ -51,14 +111,39 @@ void parser_destroy(Parser* parser) {
         ast_destroy(parser->ast);
     }
     
+    /* Libera toda a árvore sintática de uma vez */
+    memory_arena_destroy(parser->arena);
+    if (parser->scope_names) memory_free(g_memory_manager, parser->scope_names);
+    
     memory_free(g_memory_manager, parser);
 }
 
 /* Reportar erro sintático */
 void parser_error(Parser* parser, const char* message) {
     Token token = parser->lexer->current_token;
-    error_report(ERROR_SYNTAX, token.line, token.column, message);
     parser->error_count++;
+    
+    if (!parser->job) {
+        error_report(ERROR_SYNTAX, token.line, token.column, message);
+        return;
+    }
+    
+    /* Análise paralela: guardar para imprimir na ordem do fonte */
+    ParseJob* job = parser->job;
+    if (job->error_count >= job->error_capacity) {
+        int capacity = job->error_capacity == 0 ? 2 : job->error_capacity * 2;
+        ParseDiagnostic* errors = (ParseDiagnostic*)MEMORY_REALLOC(
+            g_memory_manager, job->errors, (size_t)capacity * sizeof(ParseDiagnostic));
+        if (!errors) return;
+        job->errors = errors;
+        job->error_capacity = capacity;
+    }
+    
+    ParseDiagnostic* error = &job->errors[job->error_count++];
+    error->line = token.line;
+    error->column = token.column;
+    strncpy(error->message, message, MAX_ERROR_MESSAGE_LENGTH - 1);
+    error->message[MAX_ERROR_MESSAGE_LENGTH - 1] = '\0';
 }
 
 /* Verificar se token atual é do tipo esperado */
@@ -91,63 +176,408 @@ static int expect_token(Parser* parser, TokenType expected) {
 
 /* Criar nó da AST */
 static ASTNode* create_node(Parser* parser, ASTNodeType type) {
-    ASTNode* node = ast_create_node(type);
+    ASTNode* node = ast_create_node_in(parser->arena, type);
     if (!node) {
         parser_error(parser, "Falha ao criar nó da AST");
         return NULL;
     }
-    node->token = parser->lexer->current_token;
+    node->token = ast_node_token(parser->lexer->current_token);
     return node;
 }
 
-/* Analisar programa */
-static ASTNode* parse_program(Parser* parser) {
-    ASTNode* program = create_node(parser, AST_PROGRAM);
-    if (!program) return NULL;
+/* Criar nó de definição de função; a definição fica na arena da árvore */
+static ASTNode* create_function_node(Parser* parser) {
+    ASTNode* func = create_node(parser, AST_FUNCTION_DEF);
+    if (!func) return NULL;
+    
+    func->data.function = (FunctionInfo*)memory_arena_alloc(parser->arena, sizeof(FunctionInfo));
+    if (!func->data.function) {
+        parser_error(parser, "Falha ao criar nó da AST");
+        return NULL;
+    }
+    memset(func->data.function, 0, sizeof(FunctionInfo));
+    return func;
+}
+
+/* Analisar uma definição de nível superior */
+static ASTNode* parse_top_level(Parser* parser) {
+    if (match_token(parser, TOKEN_FUNCAO)) {
+        /* Função normal */
+        return parse_function(parser);
+    }
+    if (match_token(parser, TOKEN_PRINCIPAL)) {
+        /* Função principal */
+        return parse_main_function(parser);
+    }
+    
+    parser_error(parser, "Esperado declaração de função");
+    return NULL;
+}
+
+/* Parser dos trabalhadores: sem arena própria e sem tabela de símbolos;
+ * declarações repetidas são detectadas pela lista de nomes dos escopos */
+static Parser* parser_create_worker(void) {
+    Parser* parser = (Parser*)MEMORY_ALLOC(g_memory_manager, sizeof(Parser));
+    if (!parser) return NULL;
     
-    /* Avançar para primeiro token */
-    parser->lexer->current_token = lexer_next_token(parser->lexer);
+    memset(parser, 0, sizeof(Parser));
+    return parser;
+}
+
+/* Analisar os trechos da fila com um parser próprio do trabalhador */
+static void parse_worker_run(ParsePool* pool) {
+    Parser* parser = parser_create_worker();
+    if (!parser) return;
     
-    /* Ler todas as funções do arquivo */
-    while (!match_token(parser, TOKEN_EOF)) {
-        ASTNode* func = NULL;
+    for (;;) {
+        int index = __atomic_fetch_add(&pool->next_span, 1, __ATOMIC_RELAXED);
+        if (index >= pool->span_count) break;
         
-        /* Verificar tipo de função */
-        if (match_token(parser, TOKEN_FUNCAO)) {
-            /* Função normal */
-            func = parse_function(parser);
-        } else if (match_token(parser, TOKEN_PRINCIPAL)) {
-            /* Função principal */
-            func = parse_main_function(parser);
-        } else {
-            parser_error(parser, "Esperado declaração de função");
-            ast_destroy(program);
-            return NULL;
+        ParseSpan* span = &pool->spans[index];
+        span->arena = memory_arena_create(g_memory_manager, "parser", 0);
+        if (!span->arena) break;    /* Sem erros guardados: a montagem relata a falha */
+        parser->arena = span->arena;
+        
+        for (int i = 0; i < span->job_count; i++) {
+            ParseJob* job = &pool->jobs[span->first_job + i];
+            Lexer* lexer = lexer_create_range(pool->source, &job->range);
+            if (!lexer) break;
+            
+            parser->lexer = lexer;
+            parser->job = job;
+            parser->current_scope = 0;
+            parser->scope_name_count = 0;
+            parser->scope_base = 0;
+            parser->lexer->current_token = lexer_next_token(lexer);
+            
+            /* A faixa termina na chave que fecha a definição */
+            ASTNode* func = parse_top_level(parser);
+            if (func && !match_token(parser, TOKEN_EOF)) {
+                parser_error(parser, "Esperado declaração de função");
+                func = NULL;
+            }
+            job->function = func;
+            
+            parser->lexer = NULL;
+            lexer_destroy(lexer);
+            
+            /* A montagem para no primeiro erro: o resto do trecho não é usado */
+            if (!func) break;
         }
         
-        if (!func) {
-            ast_destroy(program);
-            return NULL;
+        parser->arena = NULL;
+        parser->job = NULL;
+    }
+    
+    parser_destroy(parser);
+}
+
+/* Entrada das threads auxiliares */
+static void* parse_worker(void* arg) {
+    parse_worker_run((ParsePool*)arg);
+    memory_thread_release(g_memory_manager);
+    return NULL;
+}
+
+/* Garantir espaço em um vetor da montagem */
+static int stream_reserve(void** items, int* capacity, int needed, size_t item_size) {
+    if (needed <= *capacity) return 1;
+    
+    int new_capacity = *capacity == 0 ? 16 : *capacity * 2;
+    while (new_capacity < needed) new_capacity *= 2;
+    void* grown = MEMORY_REALLOC(g_memory_manager, *items, (size_t)new_capacity * item_size);
+    if (!grown) return 0;
+    *items = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+/* Guardar as funções chamadas dentro da subárvore */
+static int collect_called_ids(ProgramStream* stream, const ASTNode* node) {
+    if (node->type == AST_FUNCTION_CALL && node->name_id != INTERN_NONE) {
+        if (!stream_reserve((void**)&stream->calls, &stream->call_capacity,
+                            stream->call_count + 1, sizeof(InternId))) {
+            return 0;
+        }
+        stream->calls[stream->call_count++] = node->name_id;
+    }
+    
+    for (int i = 0; i < node->child_count; i++) {
+        if (!collect_called_ids(stream, ast_get_child(node, i))) return 0;
+    }
+    return 1;
+}
+
+/* Copiar definição de nível superior para a AST plana; a árvore de origem
+ * pode ser descartada em seguida */
+static int stream_function(Parser* parser, ProgramStream* stream, const ASTNode* func) {
+    int ok = stream_reserve((void**)&stream->functions, &stream->function_capacity,
+                            stream->function_count + 1, sizeof(ASTIndex));
+    if (ok && g_config.lazy_bodies) ok = collect_called_ids(stream, func);
+    
+    ASTIndex index = ok ? flat_ast_copy_subtree(stream->builder, func) : AST_INDEX_NONE;
+    if (index == AST_INDEX_NONE || stream->builder->failed) {
+        error_report(ERROR_MEMORY, func->token.line, func->token.column, "Falha ao alocar AST plana");
+        parser->error_count++;
+        return 0;
+    }
+    
+    stream->functions[stream->function_count++] = index;
+    return 1;
+}
+
+/* Analisar definições em paralelo a partir da pré-varredura. Retorna 1 se
+ * o programa foi montado, -1 em erro sintático e 0 se a análise paralela
+ * não se aplica (poucas funções, um trabalhador ou chaves sem par) */
+static int parse_program_parallel(Parser* parser, ProgramStream* stream) {
+    SourceRange* ranges = NULL;
+    int count = lexer_scan_top_level(parser->lexer, &ranges);
+    int workers = count > 1 ? config_worker_count(&g_config, count) : 1;
+    if (count < 2 || workers < 2) {
+        if (ranges) memory_free(g_memory_manager, ranges);
+        return 0;
+    }
+    
+    ParseJob* jobs = (ParseJob*)MEMORY_ALLOC(g_memory_manager, (size_t)count * sizeof(ParseJob));
+    if (!jobs) {
+        memory_free(g_memory_manager, ranges);
+        return 0;
+    }
+    
+    ParseSpan* spans = (ParseSpan*)MEMORY_ALLOC(g_memory_manager, (size_t)workers * sizeof(ParseSpan));
+    if (!spans) {
+        memory_free(g_memory_manager, jobs);
+        memory_free(g_memory_manager, ranges);
+        return 0;
+    }
+    
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        memset(&jobs[i], 0, sizeof(ParseJob));
+        jobs[i].range = ranges[i];
+        total += (size_t)(ranges[i].end - ranges[i].start);
+    }
+    memory_free(g_memory_manager, ranges);
+    
+    /* Um trecho contíguo por trabalhador, com volumes de fonte parecidos:
+     * cada trecho tem uma arena, liberada assim que ele é montado */
+    int span_count = 0;
+    size_t taken = 0;
+    for (int i = 0; i < count; i++) {
+        if (span_count == 0 || (span_count < workers &&
+                                taken >= total * (size_t)span_count / (size_t)workers)) {
+            spans[span_count].first_job = i;
+            spans[span_count].job_count = 0;
+            spans[span_count].arena = NULL;
+            span_count++;
+        }
+        spans[span_count - 1].job_count++;
+        taken += (size_t)(jobs[i].range.end - jobs[i].range.start);
+    }
+    
+    ParsePool pool;
+    pool.source = parser->lexer->source;
+    pool.jobs = jobs;
+    pool.spans = spans;
+    pool.span_count = span_count;
+    pool.next_span = 0;
+    
+    /* A thread atual também trabalha; as demais dividem a fila */
+    pthread_t threads[workers - 1];
+    int started = 0;
+    for (int i = 0; i < workers - 1; i++) {
+        if (pthread_create(&threads[started], NULL, parse_worker, &pool) == 0) {
+            started++;
+        }
+    }
+    parse_worker_run(&pool);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    /* Montar o programa na ordem do fonte; como na análise sequencial,
+     * o primeiro erro encerra e as definições seguintes são descartadas */
+    int result = 1;
+    for (int s = 0; s < span_count; s++) {
+        ParseSpan* span = &spans[s];
+        
+        for (int i = span->first_job; i < span->first_job + span->job_count; i++) {
+            ParseJob* job = &jobs[i];
+            
+            if (result > 0) {
+                for (int j = 0; j < job->error_count; j++) {
+                    error_report(ERROR_SYNTAX, job->errors[j].line, job->errors[j].column,
+                                 job->errors[j].message);
+                    parser->error_count++;
+                }
+                if (!job->function) {
+                    if (job->error_count == 0) {
+                        error_report(ERROR_MEMORY, job->range.line, job->range.column,
+                                     "Falha ao analisar definição");
+                        parser->error_count++;
+                    }
+                    result = -1;
+                } else if (!stream_function(parser, stream, job->function)) {
+                    result = -1;
+                }
+            }
+            
+            if (job->errors) memory_free(g_memory_manager, job->errors);
         }
         
-        ast_add_child(program, func);
+        /* Trecho já copiado para a AST plana */
+        if (span->arena) memory_arena_destroy(span->arena);
+    }
+    
+    memory_free(g_memory_manager, spans);
+    memory_free(g_memory_manager, jobs);
+    return result;
+}
+
+/* Analisar corpo pulado a partir do trecho guardado na pré-análise */
+static ASTNode* parse_pending_body(Parser* parser, const SourceRange* range) {
+    Lexer* outer = parser->lexer;
+    Lexer* lexer = lexer_create_range(outer->source, range);
+    if (!lexer) {
+        parser_error(parser, "Falha ao analisar corpo da função");
+        return NULL;
+    }
+    
+    parser->lexer = lexer;
+    lexer->current_token = lexer_next_token(lexer);
+    
+    ASTNode* body = NULL;
+    if (expect_token(parser, TOKEN_ABRE_CHAVE)) {
+        body = parse_block(parser);
+        if (body && !expect_token(parser, TOKEN_FECHA_CHAVE)) body = NULL;
+    }
+    if (body && !match_token(parser, TOKEN_EOF)) {
+        parser_error(parser, "Conteúdo inesperado após o corpo da função");
+        body = NULL;
     }
     
-    return program;
+    outer->error_count += lexer->error_count;
+    parser->lexer = outer;
+    lexer_destroy(lexer);
+    return body;
+}
+
+/* Analisar os corpos pulados alcançáveis a partir das funções já
+ * analisadas (principal); os demais continuam como trechos do fonte.
+ * Cada corpo é anexado à sua definição na AST plana */
+static int parse_reachable_bodies(Parser* parser, ProgramStream* stream) {
+    FlatASTBuilder* builder = stream->builder;
+    InternId max_id = INTERN_NONE;
+    int pending = 0;
+    for (int i = 0; i < stream->function_count; i++) {
+        ASTNode* func = flat_ast_builder_node(builder, stream->functions[i]);
+        if (func->name_id > max_id) max_id = func->name_id;
+        if (func->data.function->body_pending) pending++;
+    }
+    if (pending == 0) return 1;
+    
+    /* Ids internados são densos: índice direto do id para a definição */
+    ASTIndex* by_id = (ASTIndex*)MEMORY_ALLOC(g_memory_manager, ((size_t)max_id + 1) * sizeof(ASTIndex));
+    if (!by_id) {
+        parser_error(parser, "Falha ao alocar fila de corpos de funções");
+        return 0;
+    }
+    for (InternId id = 0; id <= max_id; id++) by_id[id] = AST_INDEX_NONE;
+    
+    for (int i = 0; i < stream->function_count; i++) {
+        ASTNode* func = flat_ast_builder_node(builder, stream->functions[i]);
+        if (func->data.function->body_pending && func->name_id != INTERN_NONE &&
+            by_id[func->name_id] == AST_INDEX_NONE) {
+            by_id[func->name_id] = stream->functions[i];
+        }
+    }
+    
+    /* As chamadas guardadas são a fila: cada corpo analisado acrescenta as suas */
+    int ok = 1;
+    for (int head = 0; head < stream->call_count && ok; head++) {
+        InternId id = stream->calls[head];
+        if (id > max_id || by_id[id] == AST_INDEX_NONE) continue;
+        
+        ASTIndex index = by_id[id];
+        by_id[id] = AST_INDEX_NONE;
+        
+        /* A definição fica na arena da AST plana: o ponteiro sobrevive ao
+         * crescimento do bloco de nós */
+        FunctionInfo* info = flat_ast_builder_node(builder, index)->data.function;
+        ASTNode* body = parse_pending_body(parser, &info->body);
+        if (!body) {
+            ok = 0;
+        } else if (!collect_called_ids(stream, body) || !flat_ast_attach_subtree(builder, index, body)) {
+            error_report(ERROR_MEMORY, body->token.line, body->token.column, "Falha ao alocar AST plana");
+            parser->error_count++;
+            ok = 0;
+        } else {
+            info->body_pending = 0;
+        }
+        memory_arena_reset(parser->arena);
+    }
+    
+    memory_free(g_memory_manager, by_id);
+    return ok;
+}
+
+/* Analisar programa direto para a AST plana: cada definição é copiada
+ * assim que termina e a árvore sintática é descartada, de modo que o pico
+ * de memória é o da maior função e não o do programa inteiro */
+static FlatAST* parse_program(Parser* parser) {
+    ProgramStream stream;
+    memset(&stream, 0, sizeof(ProgramStream));
+    stream.builder = flat_ast_builder_create(0, 0);
+    if (!stream.builder) return NULL;
+    
+    int ok = flat_ast_begin_node(stream.builder, AST_PROGRAM,
+                                 ast_node_token(parser->lexer->current_token)) != AST_INDEX_NONE;
+    
+    /* Várias definições e mais de um trabalhador: análise paralela */
+    int parallel = ok ? parse_program_parallel(parser, &stream) : 0;
+    if (parallel != 0) {
+        ok = parallel > 0;
+        parser->lexer->pos = parser->lexer->length;
+        parser->lexer->current_token.type = TOKEN_EOF;
+    } else if (ok) {
+        /* Avançar para primeiro token */
+        parser->lexer->current_token = lexer_next_token(parser->lexer);
+        
+        /* Ler todas as funções do arquivo */
+        while (ok && !match_token(parser, TOKEN_EOF)) {
+            ASTNode* func = parse_top_level(parser);
+            ok = func && stream_function(parser, &stream, func);
+            memory_arena_reset(parser->arena);
+        }
+    }
+    
+    /* Corpos pulados: analisar só os que principal alcança */
+    if (ok && g_config.lazy_bodies) ok = parse_reachable_bodies(parser, &stream);
+    
+    if (stream.functions) memory_free(g_memory_manager, stream.functions);
+    if (stream.calls) memory_free(g_memory_manager, stream.calls);
+    
+    if (!ok) {
+        flat_ast_builder_destroy(stream.builder);
+        return NULL;
+    }
+    
+    flat_ast_end_node(stream.builder);
+    return flat_ast_builder_finish(stream.builder);
 }
 
 /* Analisar função principal */
 static ASTNode* parse_main_function(Parser* parser) {
-    ASTNode* func = create_node(parser, AST_FUNCTION_DEF);
+    ASTNode* func = create_function_node(parser);
     if (!func) return NULL;
     
     /* Consumir 'principal' */
     consume_token(parser, TOKEN_PRINCIPAL);
     
     /* Copiar nome da função */
-    strncpy(func->data.function.name, "principal", MAX_IDENTIFIER_LENGTH - 1);
-    func->data.function.name[MAX_IDENTIFIER_LENGTH - 1] = '\0';
-    func->data.function.return_type = TYPE_INTEIRO; /* principal sempre retorna inteiro */
+    func->name_id = intern_string("principal");
+    func->data.function->name = intern_text(func->name_id);
+    func->data.function->return_type = TYPE_INTEIRO; /* principal sempre retorna inteiro */
     
     /* Parâmetros */
     if (!expect_token(parser, TOKEN_ABRE_PAREN)) {
@@ -160,46 +590,49 @@ static ASTNode* parse_main_function(Parser* parser) {
         return NULL;
     }
     
-    /* Corpo da função */
-    if (!expect_token(parser, TOKEN_ABRE_CHAVE)) {
+    /* Corpo da função: principal é sempre analisada */
+    if (!parse_function_body(parser, func)) {
         ast_destroy(func);
         return NULL;
     }
     
+    return func;
+}
+
+/* Analisar corpo da função entre chaves */
+static int parse_function_body(Parser* parser, ASTNode* func) {
+    if (!expect_token(parser, TOKEN_ABRE_CHAVE)) {
+        return 0;
+    }
+    
     /* Analisar bloco de código */
     ASTNode* body = parse_block(parser);
     if (!body) {
-        ast_destroy(func);
-        return NULL;
+        return 0;
     }
     
     ast_add_child(func, body);
     
-    if (!expect_token(parser, TOKEN_FECHA_CHAVE)) {
-        ast_destroy(func);
-        return NULL;
-    }
-    
-    return func;
+    return expect_token(parser, TOKEN_FECHA_CHAVE);
 }
 
 /* Analisar função */
 static ASTNode* parse_function(Parser* parser) {
-    ASTNode* func = create_node(parser, AST_FUNCTION_DEF);
+    ASTNode* func = create_function_node(parser);
     if (!func) return NULL;
     
     /* Consumir 'funcao' */
     consume_token(parser, TOKEN_FUNCAO);
     
-    /* Nome da função */
+    /* Nome da função (copiado antes de consumir o token) */
+    Token name_token = parser->lexer->current_token;
     if (!expect_token(parser, TOKEN_FUNCAO_ID)) {
         ast_destroy(func);
         return NULL;
     }
     
-    /* Copiar nome da função */
-    strncpy(func->data.function.name, parser->lexer->current_token.value, MAX_IDENTIFIER_LENGTH - 1);
-    func->data.function.name[MAX_IDENTIFIER_LENGTH - 1] = '\0';
+    func->name_id = name_token.id;
+    func->data.function->name = intern_text(name_token.id);
     
     /* Parâmetros */
     if (!expect_token(parser, TOKEN_ABRE_PAREN)) {
@@ -207,7 +640,8 @@ static ASTNode* parse_function(Parser* parser) {
         return NULL;
     }
     
-    /* Lista de parâmetros */
+    /* Lista de parâmetros, copiada depois para uma fatia do tamanho exato */
+    FunctionParam params[MAX_FUNCTION_PARAMS];
     int param_count = 0;
     if (!match_token(parser, TOKEN_FECHA_PAREN)) {
         do {
@@ -235,6 +669,7 @@ static ASTNode* parse_function(Parser* parser) {
             consume_token(parser, type_token.type);
             
             /* Nome do parâmetro */
+            Token param_token = parser->lexer->current_token;
             if (!expect_token(parser, TOKEN_VARIAVEL)) {
                 ast_destroy(func);
                 return NULL;
@@ -248,11 +683,9 @@ static ASTNode* parse_function(Parser* parser) {
             
             /* Adicionar parâmetro */
             if (param_count < MAX_FUNCTION_PARAMS) {
-                func->data.function.param_types[param_count] = param_type;
-                func->data.function.param_type_infos[param_count] = type_info;
-                strncpy(func->data.function.param_names[param_count],
-                        parser->lexer->current_token.value,
-                        MAX_IDENTIFIER_LENGTH - 1);
+                params[param_count].name_id = param_token.id;
+                params[param_count].type = param_type;
+                params[param_count].type_info = type_info;
                 param_count++;
             } else {
                 parser_error(parser, "Número máximo de parâmetros excedido");
@@ -269,29 +702,35 @@ static ASTNode* parse_function(Parser* parser) {
         } while (1);
     }
     
-    func->data.function.param_count = param_count;
-    
-    if (!expect_token(parser, TOKEN_FECHA_PAREN)) {
-        ast_destroy(func);
-        return NULL;
+    if (param_count > 0) {
+        size_t params_size = (size_t)param_count * sizeof(FunctionParam);
+        func->data.function->params = (FunctionParam*)memory_arena_alloc(parser->arena, params_size);
+        if (!func->data.function->params) {
+            parser_error(parser, "Falha ao criar nó da AST");
+            ast_destroy(func);
+            return NULL;
+        }
+        memcpy(func->data.function->params, params, params_size);
     }
+    func->data.function->param_count = param_count;
     
-    /* Corpo da função */
-    if (!expect_token(parser, TOKEN_ABRE_CHAVE)) {
+    if (!expect_token(parser, TOKEN_FECHA_PAREN)) {
         ast_destroy(func);
         return NULL;
     }
     
-    /* Analisar bloco de código */
-    ASTNode* body = parse_block(parser);
-    if (!body) {
-        ast_destroy(func);
-        return NULL;
+    /* Modo sob demanda: só delimitar o corpo pelas chaves */
+    if (g_config.lazy_bodies && match_token(parser, TOKEN_ABRE_CHAVE)) {
+        if (!lexer_skip_block(parser->lexer, &func->data.function->body)) {
+            parser_error(parser, "Bloco da função sem '}' correspondente");
+            ast_destroy(func);
+            return NULL;
+        }
+        func->data.function->body_pending = 1;
+        return func;
     }
     
-    ast_add_child(func, body);
-    
-    if (!expect_token(parser, TOKEN_FECHA_CHAVE)) {
+    if (!parse_function_body(parser, func)) {
         ast_destroy(func);
         return NULL;
     }
@@ -307,6 +746,8 @@ static ASTNode* parse_block(Parser* parser) {
     /* Entrar em novo escopo */
     parser->current_scope++;
     symbol_table_enter_scope(parser->symbol_table);
+    int outer_base = parser->scope_base;
+    parser->scope_base = parser->scope_name_count;
     
     /* Analisar declarações e comandos */
     while (!match_token(parser, TOKEN_FECHA_CHAVE) && 
@@ -323,6 +764,8 @@ static ASTNode* parse_block(Parser* parser) {
     
     /* Sair do escopo */
     symbol_table_exit_scope(parser->symbol_table);
+    parser->scope_name_count = parser->scope_base;
+    parser->scope_base = outer_base;
     parser->current_scope--;
     
     return block;
@@ -366,6 +809,26 @@ static ASTNode* parse_statement(Parser* parser) {
     }
 }
 
+/* Registrar nome no escopo atual sem tabela de símbolos; 0 se já
+ * declarado nele (ou sem memória) */
+static int declare_scope_name(Parser* parser, InternId name_id) {
+    for (int i = parser->scope_base; i < parser->scope_name_count; i++) {
+        if (parser->scope_names[i] == name_id) return 0;
+    }
+    
+    if (parser->scope_name_count >= parser->scope_name_capacity) {
+        int capacity = parser->scope_name_capacity == 0 ? 32 : parser->scope_name_capacity * 2;
+        InternId* names = (InternId*)MEMORY_REALLOC(g_memory_manager, parser->scope_names,
+                                                    (size_t)capacity * sizeof(InternId));
+        if (!names) return 0;
+        parser->scope_names = names;
+        parser->scope_name_capacity = capacity;
+    }
+    
+    parser->scope_names[parser->scope_name_count++] = name_id;
+    return 1;
+}
+
 /* Analisar declaração de variável */
 static ASTNode* parse_var_declaration(Parser* parser) {
     ASTNode* var_decl = create_node(parser, AST_VAR_DECL);
@@ -400,17 +863,15 @@ static ASTNode* parse_var_declaration(Parser* parser) {
         return NULL;
     }
 
-    /* Salvar token e nome da variável antes de consumir */
+    /* Salvar token (e o id internado do nome) antes de consumir */
     Token var_token = parser->lexer->current_token;
-    char var_name[MAX_IDENTIFIER_LENGTH];
-    strncpy(var_name, var_token.value, MAX_IDENTIFIER_LENGTH - 1);
-    var_name[MAX_IDENTIFIER_LENGTH - 1] = '\0';
+    var_decl->name_id = var_token.id;
 
     /* Consumir o token da variável */
     consume_token(parser, TOKEN_VARIAVEL);
 
     /* Atribuir o token da variável ao nó para relatórios corretos */
-    var_decl->token = var_token;
+    var_decl->token = ast_node_token(var_token);
     
     /* Verificar se tem dimensões */
     if (match_token(parser, TOKEN_ABRE_COLCH)) {
@@ -469,21 +930,26 @@ static ASTNode* parse_var_declaration(Parser* parser) {
         }
     }
     
-    /* Adicionar à tabela de símbolos USANDO O NOME SALVO */
-    Symbol* symbol = symbol_table_insert(
-        parser->symbol_table,
-        var_name,
-        var_decl->data.var_decl.var_type
-    );
+    /* Adicionar à tabela de símbolos pelo id salvo; trabalhadores da
+     * análise paralela só registram o nome no escopo */
+    Symbol* symbol = NULL;
+    int declared;
+    if (parser->symbol_table) {
+        symbol = symbol_table_insert_id(parser->symbol_table, var_decl->name_id,
+                                        var_decl->data.var_decl.var_type);
+        declared = symbol != NULL;
+    } else {
+        declared = declare_scope_name(parser, var_decl->name_id);
+    }
     
-    if (!symbol) {
+    if (!declared) {
         parser_error(parser, "Variável já declarada neste escopo");
         ast_destroy(var_decl);
         return NULL;
     }
     
     /* Copiar informações de tipo para o símbolo */
-    symbol->type_info = var_decl->data.var_decl.type_info;
+    if (symbol) symbol->type_info = var_decl->data.var_decl.type_info;
     
     /* Verificar atribuição inicial */
     if (match_token(parser, TOKEN_ATRIB)) {
@@ -496,7 +962,7 @@ static ASTNode* parse_var_declaration(Parser* parser) {
         }
         
         ast_add_child(var_decl, init_expr);
-        symbol->is_initialized = 1;
+        if (symbol) symbol->is_initialized = 1;
     }
     
     if (!expect_token(parser, TOKEN_PONTO_VIRG)) {
@@ -532,8 +998,11 @@ static ASTNode* parse_expression(Parser* parser) {
         case TOKEN_STRING:
             left = create_node(parser, AST_LITERAL);
             if (!left) return NULL;
-            strncpy(left->data.literal.string_val, token.value, MAX_STRING_LENGTH - 1);
-            left->data.literal.string_val[MAX_STRING_LENGTH - 1] = '\0';
+            left->data.literal.string_val = memory_arena_strdup(parser->arena, token.value);
+            if (!left->data.literal.string_val) {
+                parser_error(parser, "Falha ao criar nó da AST");
+                return NULL;
+            }
             left->data_type = TYPE_TEXTO;
             consume_token(parser, TOKEN_STRING);
             break;
@@ -542,10 +1011,17 @@ static ASTNode* parse_expression(Parser* parser) {
             /* Referência a variável */
             left = create_node(parser, AST_IDENTIFIER);
             if (!left) return NULL;
-            strncpy(left->data.literal.string_val, token.value, MAX_STRING_LENGTH - 1);
+            left->name_id = token.id;
+            left->data.literal.string_val = intern_text(token.id);
             consume_token(parser, TOKEN_VARIAVEL);
             break;
             
+        case TOKEN_FUNCAO_ID:
+            /* Chamada de função como operando */
+            left = parse_call(parser);
+            if (!left) return NULL;
+            break;
+            
         default:
             parser_error(parser, "Expressão inválida");
             return NULL;
@@ -681,8 +1157,8 @@ static ASTNode* parse_assignment_without_semicolon(Parser* parser) {
         return NULL;
     }
     
-    strncpy(var->data.literal.string_val, parser->lexer->current_token.value, MAX_STRING_LENGTH - 1);
-    var->data.literal.string_val[MAX_STRING_LENGTH - 1] = '\0';
+    var->name_id = parser->lexer->current_token.id;
+    var->data.literal.string_val = intern_text(var->name_id);
     consume_token(parser, TOKEN_VARIAVEL);
     
     ast_add_child(assign, var);
@@ -867,11 +1343,8 @@ static ASTNode* parse_io_statement(Parser* parser) {
     /* Tipo de operação */
     TokenType op_type = parser->lexer->current_token.type;
 
-    if (op_type == TOKEN_LEIA) {
-        strncpy(io_stmt->data.literal.string_val, "leia", MAX_STRING_LENGTH - 1);
-    } else {
-        strncpy(io_stmt->data.literal.string_val, "escreva", MAX_STRING_LENGTH - 1);
-    }
+    io_stmt->name_id = intern_string(op_type == TOKEN_LEIA ? "leia" : "escreva");
+    io_stmt->data.literal.string_val = intern_text(io_stmt->name_id);
 
     consume_token(parser, op_type);
     
@@ -935,8 +1408,9 @@ static ASTNode* parse_assignment(Parser* parser) {
     }
 
     /* Definir nome e token corretos */
-    strncpy(var->data.literal.string_val, var_token.value, MAX_STRING_LENGTH - 1);
-    var->token = var_token;
+    var->token = ast_node_token(var_token);
+    var->name_id = var_token.id;
+    var->data.literal.string_val = intern_text(var->name_id);
     
     /* Operador de atribuição */
     if (!expect_token(parser, TOKEN_ATRIB)) {
@@ -967,6 +1441,19 @@ static ASTNode* parse_assignment(Parser* parser) {
 
 /* Analisar chamada de função */
 static ASTNode* parse_function_call(Parser* parser) {
+    ASTNode* call = parse_call(parser);
+    if (!call) return NULL;
+    
+    if (!expect_token(parser, TOKEN_PONTO_VIRG)) {
+        ast_destroy(call);
+        return NULL;
+    }
+    
+    return call;
+}
+
+/* Analisar chamada de função: nome e argumentos entre parênteses */
+static ASTNode* parse_call(Parser* parser) {
     ASTNode* call = create_node(parser, AST_FUNCTION_CALL);
     if (!call) return NULL;
     
@@ -978,8 +1465,9 @@ static ASTNode* parse_function_call(Parser* parser) {
     }
 
     Token func_token = parser->lexer->current_token;
-    strncpy(call->data.literal.string_val, func_token.value, MAX_STRING_LENGTH - 1);
-    call->token = func_token;
+    call->token = ast_node_token(func_token);
+    call->name_id = func_token.id;
+    call->data.literal.string_val = intern_text(call->name_id);
 
     consume_token(parser, TOKEN_FUNCAO_ID);
     
@@ -1013,11 +1501,6 @@ static ASTNode* parse_function_call(Parser* parser) {
         return NULL;
     }
     
-    if (!expect_token(parser, TOKEN_PONTO_VIRG)) {
-        ast_destroy(call);
-        return NULL;
-    }
-    
     return call;
 }
 
@@ -1068,7 +1551,15 @@ static int parse_type_dimensions(Parser* parser, TypeInfo* type_info) {
     return 1;
 }
 
-/* Função principal de análise */
-ASTNode* parser_parse(Parser* parser) {
+/* Função principal de análise: programa já na AST plana */
+FlatAST* parser_parse(Parser* parser) {
     return parse_program(parser);
+}
+
+/* Descartar o que restou da árvore sintática ao fim da fase - O(1) */
+void parser_release_tree(Parser* parser) {
+    if (!parser) return;
+    
+    parser->ast = NULL;
+    memory_arena_reset(parser->arena);
 } 
\ No newline at end of file
@@ -1,23 +1,52 @@
 #include "../include/compiler.h"
+#include <pthread.h>
+
+/* Diagnóstico guardado para impressão posterior (mensagens são literais) */
+typedef struct {
+    int is_error;
+    int line;
+    int column;
+    const char* message;
+} SemanticDiagnostic;
+
+/* Corpo de função analisado por um trabalhador, com seus diagnósticos */
+typedef struct {
+    ASTNode* function;
+    SemanticDiagnostic* items;
+    int count;
+    int capacity;
+    int main_function_found;
+} SemanticJob;
 
 /* Contexto de análise semântica */
 typedef struct {
+    MemoryArena* arena;
     SymbolTable* symbol_table;
     Symbol* current_function;
     int in_loop;
     int error_count;
     int warning_count;
     int main_function_found;
+    SemanticJob* job;           /* Se definido, diagnósticos vão para o job */
 } SemanticContext;
 
+/* Fila compartilhada da segunda passada */
+typedef struct {
+    SymbolTable* globals;       /* Funções da primeira passada, somente leitura */
+    SemanticJob* jobs;
+    int job_count;
+    int next_job;               /* Próximo job livre (atômico) */
+} SemanticPool;
+
 /* Declarações de funções estáticas */
 static SemanticContext* create_context(SymbolTable* st);
 static void destroy_context(SemanticContext* ctx);
-static void semantic_error(SemanticContext* ctx, Token token, const char* message);
-static void semantic_warning(SemanticContext* ctx, Token token, const char* message);
+static void semantic_error(SemanticContext* ctx, NodeToken token, const char* message);
+static void semantic_warning(SemanticContext* ctx, NodeToken token, const char* message);
 static int check_type_compatibility(DataType type1, DataType type2);
 static DataType check_binary_operator(TokenType op, DataType left, DataType right);
 static DataType analyze_expression(SemanticContext* ctx, ASTNode* node);
+static DataType expression_type(SemanticContext* ctx, ASTNode* node);
 static void analyze_var_declaration(SemanticContext* ctx, ASTNode* node);
 static void analyze_if_statement(SemanticContext* ctx, ASTNode* node);
 static void analyze_for_statement(SemanticContext* ctx, ASTNode* node);
@@ -29,26 +58,38 @@ static void analyze_statement(SemanticContext* ctx, ASTNode* node);
 static void analyze_block(SemanticContext* ctx, ASTNode* node);
 static void analyze_function(SemanticContext* ctx, ASTNode* node);
 static void analyze_program(SemanticContext* ctx, ASTNode* node);
+static void analyze_function_bodies(SemanticContext* ctx, ASTNode* node);
 static int validate_function_name(const char* name);
 static int validate_variable_name(const char* name);
+static InternId node_name_id(const ASTNode* node, const char* name);
 static int validate_main_function(SemanticContext* ctx, ASTNode* node);
 static int validate_function_parameters(SemanticContext* ctx, ASTNode* node);
-static int validate_type_dimensions(SemanticContext* ctx, DataType type, TypeInfo info, Token token);
+static int validate_type_dimensions(SemanticContext* ctx, DataType type, TypeInfo info, NodeToken token);
 
 /* Criar contexto */
 static SemanticContext* create_context(SymbolTable* st) {
-    SemanticContext* ctx = (SemanticContext*)memory_alloc(g_memory_manager, sizeof(SemanticContext));
+    /* Arena da fase semântica: liberada inteira ao final da análise */
+    MemoryArena* arena = memory_arena_create(g_memory_manager, "semantico", 1024);
+    if (!arena) {
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar contexto semântico");
+        return NULL;
+    }
+    
+    SemanticContext* ctx = (SemanticContext*)memory_arena_alloc(arena, sizeof(SemanticContext));
     if (!ctx) {
+        memory_arena_destroy(arena);
         error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar contexto semântico");
         return NULL;
     }
     
+    ctx->arena = arena;
     ctx->symbol_table = st;
     ctx->current_function = NULL;
     ctx->in_loop = 0;
     ctx->error_count = 0;
     ctx->warning_count = 0;
     ctx->main_function_found = 0;
+    ctx->job = NULL;
     
     return ctx;
 }
@@ -56,20 +97,53 @@ static SemanticContext* create_context(SymbolTable* st) {
 /* Destruir contexto */
 static void destroy_context(SemanticContext* ctx) {
     if (ctx) {
-        memory_free(g_memory_manager, ctx);
+        memory_arena_destroy(ctx->arena);
+    }
+}
+
+/* Guardar diagnóstico no job do trabalhador */
+static void semantic_defer(SemanticJob* job, int is_error, int line, int column, const char* message) {
+    if (job->count >= job->capacity) {
+        int capacity = job->capacity == 0 ? 4 : job->capacity * 2;
+        SemanticDiagnostic* items = (SemanticDiagnostic*)MEMORY_REALLOC(
+            g_memory_manager, job->items, (size_t)capacity * sizeof(SemanticDiagnostic));
+        if (!items) return;
+        job->items = items;
+        job->capacity = capacity;
+    }
+    
+    SemanticDiagnostic* item = &job->items[job->count++];
+    item->is_error = is_error;
+    item->line = line;
+    item->column = column;
+    item->message = message;
+}
+
+/* Emitir diagnóstico (ou guardá-lo, na análise paralela) */
+static void semantic_emit(SemanticContext* ctx, int is_error, int line, int column, const char* message) {
+    if (ctx->job) {
+        semantic_defer(ctx->job, is_error, line, column, message);
+    } else if (is_error) {
+        error_report(ERROR_SEMANTIC, line, column, message);
+    } else {
+        printf("AVISO SEMÂNTICO - Linha %d, Coluna %d: %s\n", line, column, message);
+    }
+    
+    if (is_error) {
+        ctx->error_count++;
+    } else {
+        ctx->warning_count++;
     }
 }
 
 /* Reportar erro semântico */
-static void semantic_error(SemanticContext* ctx, Token token, const char* message) {
-    error_report(ERROR_SEMANTIC, token.line, token.column, message);
-    ctx->error_count++;
+static void semantic_error(SemanticContext* ctx, NodeToken token, const char* message) {
+    semantic_emit(ctx, 1, token.line, token.column, message);
 }
 
 /* Reportar aviso semântico */
-static void semantic_warning(SemanticContext* ctx, Token token, const char* message) {
-    printf("AVISO SEMÂNTICO - Linha %d, Coluna %d: %s\n", token.line, token.column, message);
-    ctx->warning_count++;
+static void semantic_warning(SemanticContext* ctx, NodeToken token, const char* message) {
+    semantic_emit(ctx, 0, token.line, token.column, message);
 }
 
 /* Verificar compatibilidade de tipos (com conversões implícitas) */
@@ -111,6 +185,11 @@ static int validate_function_name(const char* name) {
     return 1;
 }
 
+/* Id internado do nome do nó (internado aqui se o nó veio sem id) */
+static InternId node_name_id(const ASTNode* node, const char* name) {
+    return node->name_id != INTERN_NONE ? node->name_id : intern_string(name);
+}
+
 /* Validar nome de variável */
 static int validate_variable_name(const char* name) {
     if (strlen(name) < 2 || name[0] != '!') {
@@ -134,14 +213,14 @@ static int validate_variable_name(const char* name) {
 
 /* Validar função principal */
 static int validate_main_function(SemanticContext* ctx, ASTNode* node) {
-    if (strcmp(node->data.function.name, "principal") != 0) {
+    if (strcmp(node->data.function->name, "principal") != 0) {
         return 1; /* Não é função principal */
     }
     
     ctx->main_function_found = 1;
     
     /* Verificar se não tem parâmetros */
-    if (node->data.function.param_count > 0) {
+    if (node->data.function->param_count > 0) {
         semantic_error(ctx, node->token, "Função principal não pode ter parâmetros");
         return 0;
     }
@@ -151,16 +230,16 @@ static int validate_main_function(SemanticContext* ctx, ASTNode* node) {
 
 /* Validar parâmetros de função */
 static int validate_function_parameters(SemanticContext* ctx, ASTNode* node) {
-    for (int i = 0; i < node->data.function.param_count; i++) {
+    for (int i = 0; i < node->data.function->param_count; i++) {
         /* Verificar nome do parâmetro */
-        if (!validate_variable_name(node->data.function.param_names[i])) {
+        if (!validate_variable_name(intern_text(node->data.function->params[i].name_id))) {
             semantic_error(ctx, node->token, "Nome de parâmetro inválido - deve começar com ! seguido de letra minúscula");
             return 0;
         }
         
         /* Verificar se não há duplicatas */
-        for (int j = i + 1; j < node->data.function.param_count; j++) {
-            if (strcmp(node->data.function.param_names[i], node->data.function.param_names[j]) == 0) {
+        for (int j = i + 1; j < node->data.function->param_count; j++) {
+            if (node->data.function->params[i].name_id == node->data.function->params[j].name_id) {
                 semantic_error(ctx, node->token, "Parâmetro duplicado");
                 return 0;
             }
@@ -171,7 +250,7 @@ static int validate_function_parameters(SemanticContext* ctx, ASTNode* node) {
 }
 
 /* Validar dimensões de tipo */
-static int validate_type_dimensions(SemanticContext* ctx, DataType type, TypeInfo info, Token token) {
+static int validate_type_dimensions(SemanticContext* ctx, DataType type, TypeInfo info, NodeToken token) {
     switch (type) {
         case TYPE_TEXTO:
             if (info.size <= 0) {
@@ -249,10 +328,18 @@ static DataType check_binary_operator(TokenType op, DataType left, DataType righ
     return TYPE_VOID; /* Operador desconhecido */
 }
 
-/* Analisar expressão */
+/* Analisar expressão e anotar seu tipo no nó (usado pelas fases seguintes) */
 static DataType analyze_expression(SemanticContext* ctx, ASTNode* node) {
     if (!node) return TYPE_VOID;
     
+    DataType type = expression_type(ctx, node);
+    node->data_type = type;
+    return type;
+}
+
+/* Tipo de uma expressão, relatando erros */
+static DataType expression_type(SemanticContext* ctx, ASTNode* node) {
+    
     switch (node->type) {
         case AST_LITERAL:
             return node->data_type;
@@ -266,7 +353,7 @@ static DataType analyze_expression(SemanticContext* ctx, ASTNode* node) {
                 return TYPE_VOID;
             }
             
-            Symbol* symbol = symbol_table_lookup(ctx->symbol_table, name);
+            Symbol* symbol = symbol_table_lookup_id(ctx->symbol_table, node_name_id(node, name));
             if (!symbol) {
                 semantic_error(ctx, node->token, "Variável não declarada");
                 return TYPE_VOID;
@@ -281,8 +368,8 @@ static DataType analyze_expression(SemanticContext* ctx, ASTNode* node) {
         }
         
         case AST_BINARY_OP: {
-            DataType left = analyze_expression(ctx, node->children[0]);
-            DataType right = analyze_expression(ctx, node->children[1]);
+            DataType left = analyze_expression(ctx, ast_get_child(node, 0));
+            DataType right = analyze_expression(ctx, ast_get_child(node, 1));
             
             if (left == TYPE_VOID || right == TYPE_VOID) {
                 return TYPE_VOID;
@@ -317,7 +404,7 @@ static DataType analyze_expression(SemanticContext* ctx, ASTNode* node) {
                 return TYPE_VOID;
             }
             
-            Symbol* func = symbol_table_lookup(ctx->symbol_table, func_name);
+            Symbol* func = symbol_table_lookup_id(ctx->symbol_table, node_name_id(node, func_name));
             if (!func) {
                 semantic_error(ctx, node->token, "Função não declarada");
                 return TYPE_VOID;
@@ -335,19 +422,22 @@ static DataType analyze_expression(SemanticContext* ctx, ASTNode* node) {
             }
             
             /* Verificar tipos dos argumentos */
+            const FunctionSignature* signature = symbol_table_get_signature(ctx->symbol_table, func);
             for (int i = 0; i < node->child_count; i++) {
-                DataType arg_type = analyze_expression(ctx, node->children[i]);
+                DataType arg_type = analyze_expression(ctx, ast_get_child(node, i));
                 if (arg_type == TYPE_VOID) {
                     return TYPE_VOID;
                 }
                 
-                if (!check_type_compatibility(arg_type, func->param_types[i])) {
+                if (!signature) continue;
+                
+                if (!check_type_compatibility(arg_type, signature->params[i].type)) {
                     semantic_error(ctx, node->token, "Tipo de argumento incompatível");
                     return TYPE_VOID;
                 }
                 
                 /* Avisar sobre conversões implícitas */
-                if (arg_type != func->param_types[i]) {
+                if (arg_type != signature->params[i].type) {
                     semantic_warning(ctx, node->token, "Conversão implícita de tipo no argumento");
                 }
             }
@@ -362,7 +452,7 @@ static DataType analyze_expression(SemanticContext* ctx, ASTNode* node) {
 
 /* Analisar declaração de variável */
 static void analyze_var_declaration(SemanticContext* ctx, ASTNode* node) {
-    const char* var_name = node->token.value;
+    const char* var_name = intern_text(node->name_id);
     
     /* Validar nome da variável */
     if (!validate_variable_name(var_name)) {
@@ -371,7 +461,8 @@ static void analyze_var_declaration(SemanticContext* ctx, ASTNode* node) {
     }
     
     /* Verificar se já existe no escopo atual */
-    Symbol* existing = symbol_table_lookup(ctx->symbol_table, var_name);
+    InternId var_id = node_name_id(node, var_name);
+    Symbol* existing = symbol_table_lookup_id(ctx->symbol_table, var_id);
     if (existing && existing->scope_level == ctx->symbol_table->scope_level) {
         semantic_error(ctx, node->token, "Variável já declarada neste escopo");
         return;
@@ -383,7 +474,7 @@ static void analyze_var_declaration(SemanticContext* ctx, ASTNode* node) {
     }
     
     /* Inserir variável na tabela de símbolos */
-    Symbol* var = symbol_table_insert(ctx->symbol_table, var_name, node->data.var_decl.var_type);
+    Symbol* var = symbol_table_insert_id(ctx->symbol_table, var_id, node->data.var_decl.var_type);
     if (!var) {
         semantic_error(ctx, node->token, "Erro ao declarar variável");
         return;
@@ -393,7 +484,7 @@ static void analyze_var_declaration(SemanticContext* ctx, ASTNode* node) {
 
     /* Verificar inicialização */
     if (node->child_count > 0) {
-        DataType init_type = analyze_expression(ctx, node->children[0]);
+        DataType init_type = analyze_expression(ctx, ast_get_child(node, 0));
         if (init_type == TYPE_VOID) {
             return;
         }
@@ -415,7 +506,7 @@ static void analyze_var_declaration(SemanticContext* ctx, ASTNode* node) {
 /* Analisar comando if */
 static void analyze_if_statement(SemanticContext* ctx, ASTNode* node) {
     /* Verificar condição */
-    DataType cond_type = analyze_expression(ctx, node->children[0]);
+    DataType cond_type = analyze_expression(ctx, ast_get_child(node, 0));
     if (cond_type == TYPE_VOID) {
         return;
     }
@@ -426,9 +517,9 @@ static void analyze_if_statement(SemanticContext* ctx, ASTNode* node) {
     }
     
     /* Analisar blocos then e else */
-    analyze_block(ctx, node->children[1]);
+    analyze_block(ctx, ast_get_child(node, 1));
     if (node->child_count > 2) {
-        analyze_block(ctx, node->children[2]);
+        analyze_block(ctx, ast_get_child(node, 2));
     }
 }
 
@@ -437,26 +528,26 @@ static void analyze_for_statement(SemanticContext* ctx, ASTNode* node) {
     ctx->in_loop++;
     
     /* Verificar inicialização */
-    if (node->children[0]) {
-        analyze_statement(ctx, node->children[0]);
+    if (ast_get_child(node, 0)) {
+        analyze_statement(ctx, ast_get_child(node, 0));
     }
     
     /* Verificar condição */
-    if (node->children[1]) {
-        DataType cond_type = analyze_expression(ctx, node->children[1]);
+    if (ast_get_child(node, 1)) {
+        DataType cond_type = analyze_expression(ctx, ast_get_child(node, 1));
         if (cond_type != TYPE_VOID && cond_type != TYPE_INTEIRO) {
             semantic_error(ctx, node->token, "Condição deve ser do tipo inteiro");
         }
     }
     
     /* Verificar incremento */
-    if (node->children[2]) {
-        analyze_statement(ctx, node->children[2]);
+    if (ast_get_child(node, 2)) {
+        analyze_statement(ctx, ast_get_child(node, 2));
     }
     
     /* Analisar bloco */
-    if (node->children[3]) {
-        analyze_block(ctx, node->children[3]);
+    if (ast_get_child(node, 3)) {
+        analyze_block(ctx, ast_get_child(node, 3));
     }
     
     ctx->in_loop--;
@@ -467,7 +558,7 @@ static void analyze_while_statement(SemanticContext* ctx, ASTNode* node) {
     ctx->in_loop++;
     
     /* Verificar condição */
-    DataType cond_type = analyze_expression(ctx, node->children[0]);
+    DataType cond_type = analyze_expression(ctx, ast_get_child(node, 0));
     if (cond_type == TYPE_VOID) {
         ctx->in_loop--;
         return;
@@ -478,7 +569,7 @@ static void analyze_while_statement(SemanticContext* ctx, ASTNode* node) {
     }
     
     /* Analisar bloco */
-    analyze_block(ctx, node->children[1]);
+    analyze_block(ctx, ast_get_child(node, 1));
     
     ctx->in_loop--;
 }
@@ -492,7 +583,7 @@ static void analyze_return_statement(SemanticContext* ctx, ASTNode* node) {
     
     /* Verificar tipo do valor retornado */
     if (node->child_count > 0) {
-        DataType return_type = analyze_expression(ctx, node->children[0]);
+        DataType return_type = analyze_expression(ctx, ast_get_child(node, 0));
         if (return_type == TYPE_VOID) {
             return;
         }
@@ -506,6 +597,14 @@ static void analyze_return_statement(SemanticContext* ctx, ASTNode* node) {
         if (return_type != ctx->current_function->type) {
             semantic_warning(ctx, node->token, "Conversão implícita de tipo no retorno");
         }
+        
+        /* Chamada em posição de cauda: sem conversão pendente no retorno, a
+         * função chamada pode ocupar o quadro desta (principal não tem quadro) */
+        const ASTNode* value = ast_get_child(node, 0);
+        node->data.return_stmt.tail_call =
+            value->type == AST_FUNCTION_CALL && value->token.type == TOKEN_FUNCAO_ID &&
+            return_type == ctx->current_function->type &&
+            strcmp(ctx->current_function->name, "principal") != 0;
     } else if (ctx->current_function->type != TYPE_VOID) {
         semantic_error(ctx, node->token, "Função deve retornar um valor");
     }
@@ -515,7 +614,7 @@ static void analyze_return_statement(SemanticContext* ctx, ASTNode* node) {
 static void analyze_io_statement(SemanticContext* ctx, ASTNode* node) {
     /* Verificar argumentos */
     for (int i = 0; i < node->child_count; i++) {
-        DataType arg_type = analyze_expression(ctx, node->children[i]);
+        DataType arg_type = analyze_expression(ctx, ast_get_child(node, i));
         if (arg_type == TYPE_VOID) {
             semantic_error(ctx, node->token, "Argumento inválido em comando de E/S");
             return;
@@ -523,14 +622,15 @@ static void analyze_io_statement(SemanticContext* ctx, ASTNode* node) {
         
         /* Para leia(), todos os argumentos devem ser variáveis */
         if (node->token.type == TOKEN_LEIA) {
-            if (node->children[i]->type != AST_IDENTIFIER) {
+            if (ast_get_child(node, i)->type != AST_IDENTIFIER) {
                 semantic_error(ctx, node->token, "Comando leia() só aceita variáveis");
                 return;
             }
             
             /* Marcar variável como inicializada */
-            const char* var_name = node->children[i]->data.literal.string_val;
-            Symbol* var = symbol_table_lookup(ctx->symbol_table, var_name);
+            ASTNode* target = ast_get_child(node, i);
+            Symbol* var = symbol_table_lookup_id(ctx->symbol_table,
+                                                 node_name_id(target, target->data.literal.string_val));
             if (var) {
                 var->is_initialized = 1;
             }
@@ -546,12 +646,12 @@ static void analyze_assignment(SemanticContext* ctx, ASTNode* node) {
     }
     
     /* Verificar se o lado esquerdo é uma variável */
-    if (node->children[0]->type != AST_IDENTIFIER) {
+    if (ast_get_child(node, 0)->type != AST_IDENTIFIER) {
         semantic_error(ctx, node->token, "Lado esquerdo da atribuição deve ser uma variável");
         return;
     }
     
-    const char* var_name = node->children[0]->data.literal.string_val;
+    const char* var_name = ast_get_child(node, 0)->data.literal.string_val;
     
     /* Validar nome da variável */
     if (!validate_variable_name(var_name)) {
@@ -560,14 +660,14 @@ static void analyze_assignment(SemanticContext* ctx, ASTNode* node) {
     }
     
     /* Verificar se variável existe */
-    Symbol* var = symbol_table_lookup(ctx->symbol_table, var_name);
+    Symbol* var = symbol_table_lookup_id(ctx->symbol_table, node_name_id(ast_get_child(node, 0), var_name));
     if (!var) {
         semantic_error(ctx, node->token, "Variável não declarada");
         return;
     }
     
     /* Verificar tipo da expressão */
-    DataType expr_type = analyze_expression(ctx, node->children[1]);
+    DataType expr_type = analyze_expression(ctx, ast_get_child(node, 1));
     if (expr_type == TYPE_VOID) {
         return;
     }
@@ -621,7 +721,7 @@ static void analyze_statement(SemanticContext* ctx, ASTNode* node) {
         default:
             /* Para outros tipos de comando, apenas analisar recursivamente */
             for (int i = 0; i < node->child_count; i++) {
-                analyze_statement(ctx, node->children[i]);
+                analyze_statement(ctx, ast_get_child(node, i));
             }
             break;
     }
@@ -636,16 +736,29 @@ static void analyze_block(SemanticContext* ctx, ASTNode* node) {
     
     /* Analisar cada comando */
     for (int i = 0; i < node->child_count; i++) {
-        analyze_statement(ctx, node->children[i]);
+        analyze_statement(ctx, ast_get_child(node, i));
     }
     
     /* Sair do escopo */
     symbol_table_exit_scope(ctx->symbol_table);
 }
 
+/* Bloco termina em retorno em todos os caminhos (laços não são seguidos) */
+static int block_always_returns(const ASTNode* block) {
+    if (!block || block->child_count == 0) return 0;
+    
+    const ASTNode* last = ast_get_child(block, block->child_count - 1);
+    if (last->type == AST_RETURN_STMT) return 1;
+    if (last->type == AST_IF_STMT && last->child_count > 2) {
+        return block_always_returns(ast_get_child(last, 1)) &&
+               block_always_returns(ast_get_child(last, 2));
+    }
+    return 0;
+}
+
 /* Analisar função */
 static void analyze_function(SemanticContext* ctx, ASTNode* node) {
-    const char* func_name = node->data.function.name;
+    const char* func_name = node->data.function->name;
     
     /* Validar nome da função */
     if (!validate_function_name(func_name)) {
@@ -654,7 +767,7 @@ static void analyze_function(SemanticContext* ctx, ASTNode* node) {
     }
     
     /* Obter símbolo da função (declarado na primeira passada) */
-    Symbol* func = symbol_table_lookup(ctx->symbol_table, func_name);
+    Symbol* func = symbol_table_lookup_id(ctx->symbol_table, node_name_id(node, func_name));
     if (!func) {
         /* Esta situação não deveria ocorrer, pois a função foi cadastrada na
          * primeira passada. Tratar como erro genérico. */
@@ -672,21 +785,20 @@ static void analyze_function(SemanticContext* ctx, ASTNode* node) {
         return;
     }
     
-    /* Informações da função já foram registradas anteriormente */
-    func->param_count = node->data.function.param_count;
+    /* Informações da função já foram registradas na primeira passada;
+     * o símbolo é compartilhado entre trabalhadores e não é alterado aqui */
     
     /* Entrar em escopo da função */
     symbol_table_enter_scope(ctx->symbol_table);
     
     /* Adicionar parâmetros ao escopo da função */
-    for (int i = 0; i < node->data.function.param_count; i++) {
-        Symbol* param = symbol_table_insert(ctx->symbol_table, 
-                                           node->data.function.param_names[i], 
-                                           node->data.function.param_types[i]);
+    for (int i = 0; i < node->data.function->param_count; i++) {
+        const FunctionParam* definition = &node->data.function->params[i];
+        Symbol* param = symbol_table_insert_id(ctx->symbol_table, definition->name_id, definition->type);
         if (param) {
             param->is_parameter = 1;
             param->is_initialized = 1; /* Parâmetros são sempre inicializados */
-            param->type_info = node->data.function.param_type_infos[i];
+            param->type_info = definition->type_info;
         }
     }
     
@@ -694,11 +806,12 @@ static void analyze_function(SemanticContext* ctx, ASTNode* node) {
     ctx->current_function = func;
     
     if (node->child_count > 0) {
-        analyze_block(ctx, node->children[0]);
+        analyze_block(ctx, ast_get_child(node, 0));
     }
     
     /* Verificar se função não-void tem retorno */
-    if (func->type != TYPE_VOID && strcmp(func_name, "principal") != 0) {
+    if (func->type != TYPE_VOID && strcmp(func_name, "principal") != 0 &&
+        !block_always_returns(node->child_count > 0 ? ast_get_child(node, 0) : NULL)) {
         /* Esta verificação seria mais precisa com análise de fluxo de controle */
         semantic_warning(ctx, node->token, "Função pode não ter retorno em todos os caminhos");
     }
@@ -709,61 +822,255 @@ static void analyze_function(SemanticContext* ctx, ASTNode* node) {
     symbol_table_exit_scope(ctx->symbol_table);
 }
 
+/* Trabalhador da segunda passada: visão local sobre as funções globais */
+static void semantic_worker_run(SemanticPool* pool) {
+    SymbolTable* view = symbol_table_create_view(pool->globals);
+    SemanticContext* ctx = view ? create_context(view) : NULL;
+    if (!ctx) {
+        symbol_table_destroy(view);
+        return;
+    }
+    
+    for (;;) {
+        int index = __atomic_fetch_add(&pool->next_job, 1, __ATOMIC_RELAXED);
+        if (index >= pool->job_count) break;
+        
+        SemanticJob* job = &pool->jobs[index];
+        ctx->job = job;
+        ctx->main_function_found = 0;
+        analyze_function(ctx, job->function);
+        job->main_function_found = ctx->main_function_found;
+    }
+    
+    destroy_context(ctx);
+    symbol_table_destroy(view);
+}
+
+/* Entrada das threads auxiliares */
+static void* semantic_worker(void* arg) {
+    semantic_worker_run((SemanticPool*)arg);
+    memory_thread_release(g_memory_manager);
+    return NULL;
+}
+
+/* Definição cujo corpo foi analisado sintaticamente (corpos sob demanda
+ * não alcançados por principal ficam de fora) */
+static int has_function_body(const ASTNode* node) {
+    return node->type == AST_FUNCTION_DEF && !node->data.function->body_pending;
+}
+
+/* Analisar corpos das funções em paralelo e imprimir diagnósticos na
+ * ordem do código fonte */
+static void analyze_function_bodies(SemanticContext* ctx, ASTNode* node) {
+    int job_count = 0;
+    for (int i = 0; i < node->child_count; i++) {
+        if (has_function_body(ast_get_child(node, i))) job_count++;
+    }
+    if (job_count == 0) return;
+    
+    SemanticJob* jobs = (SemanticJob*)MEMORY_ALLOC(g_memory_manager, (size_t)job_count * sizeof(SemanticJob));
+    if (!jobs) {
+        semantic_error(ctx, node->token, "Falha ao alocar análise das funções");
+        return;
+    }
+    
+    int next = 0;
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* child = ast_get_child(node, i);
+        if (!has_function_body(child)) continue;
+        memset(&jobs[next], 0, sizeof(SemanticJob));
+        jobs[next++].function = child;
+    }
+    
+    SemanticPool pool;
+    pool.globals = ctx->symbol_table;
+    pool.jobs = jobs;
+    pool.job_count = job_count;
+    pool.next_job = 0;
+    
+    /* A thread atual também trabalha; as demais dividem a fila */
+    int workers = config_worker_count(&g_config, job_count);
+    pthread_t threads[workers > 1 ? workers - 1 : 1];
+    int started = 0;
+    for (int i = 0; i < workers - 1; i++) {
+        if (pthread_create(&threads[started], NULL, semantic_worker, &pool) == 0) {
+            started++;
+        }
+    }
+    semantic_worker_run(&pool);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    /* Funções sem trabalhador disponível (falha de memória) ficam sem análise */
+    if (pool.next_job < job_count) {
+        semantic_error(ctx, node->token, "Falha ao analisar corpos das funções");
+    }
+    
+    for (int i = 0; i < job_count; i++) {
+        for (int j = 0; j < jobs[i].count; j++) {
+            SemanticDiagnostic* item = &jobs[i].items[j];
+            semantic_emit(ctx, item->is_error, item->line, item->column, item->message);
+        }
+        if (jobs[i].main_function_found) ctx->main_function_found = 1;
+        if (jobs[i].items) memory_free(g_memory_manager, jobs[i].items);
+    }
+    
+    memory_free(g_memory_manager, jobs);
+}
+
+/* Definição de função do programa pelo id do nome */
+static const ASTNode* find_function_def(const ASTNode* program, InternId name_id) {
+    for (int i = 0; i < program->child_count; i++) {
+        const ASTNode* child = ast_get_child(program, i);
+        if (child->type == AST_FUNCTION_DEF && child->name_id == name_id) return child;
+    }
+    return NULL;
+}
+
+/* Tipo declarado de uma variável dentro da subárvore */
+static DataType find_declared_type(const ASTNode* node, InternId name_id) {
+    if (node->type == AST_VAR_DECL && node->name_id == name_id) {
+        return node->data.var_decl.var_type;
+    }
+    for (int i = 0; i < node->child_count; i++) {
+        DataType type = find_declared_type(ast_get_child(node, i), name_id);
+        if (type != TYPE_VOID) return type;
+    }
+    return TYPE_VOID;
+}
+
+/* Tipo de uma variável da função: parâmetro ou declaração no corpo */
+static DataType variable_type_in_function(const ASTNode* func, InternId name_id) {
+    for (int i = 0; i < func->data.function->param_count; i++) {
+        if (func->data.function->params[i].name_id == name_id) {
+            return func->data.function->params[i].type;
+        }
+    }
+    return find_declared_type(func, name_id);
+}
+
+/* Tipo de uma expressão sem tabela de símbolos (VOID se indeterminado) */
+static DataType infer_expression_type(const ASTNode* program, const ASTNode* func, const ASTNode* expr) {
+    switch (expr->type) {
+        case AST_LITERAL:
+            return expr->data_type;
+            
+        case AST_IDENTIFIER:
+            return variable_type_in_function(func, expr->name_id);
+            
+        case AST_BINARY_OP: {
+            if (expr->child_count < 2) return TYPE_VOID;
+            DataType left = infer_expression_type(program, func, ast_get_child(expr, 0));
+            DataType right = infer_expression_type(program, func, ast_get_child(expr, 1));
+            if (left == TYPE_VOID || right == TYPE_VOID) return TYPE_VOID;
+            return check_binary_operator(expr->data.binary_op.operator, left, right);
+        }
+        
+        case AST_FUNCTION_CALL: {
+            /* Funções ainda não resolvidas ficam para a próxima rodada */
+            const ASTNode* callee = find_function_def(program, expr->name_id);
+            return callee ? callee->data.function->return_type : TYPE_VOID;
+        }
+        
+        default:
+            return TYPE_VOID;
+    }
+}
+
+/* Primeiro tipo determinável entre os retornos da subárvore */
+static DataType infer_returns_in(const ASTNode* program, const ASTNode* func, const ASTNode* node) {
+    if (node->type == AST_RETURN_STMT && node->child_count > 0) {
+        DataType type = infer_expression_type(program, func, ast_get_child(node, 0));
+        if (type != TYPE_VOID) return type;
+    }
+    for (int i = 0; i < node->child_count; i++) {
+        DataType type = infer_returns_in(program, func, ast_get_child(node, i));
+        if (type != TYPE_VOID) return type;
+    }
+    return TYPE_VOID;
+}
+
+/* Tipos de retorno: funções não declaram o tipo (a regra 1.5 só exige que
+ * retornem), então ele vem das expressões de retorno. Repete enquanto
+ * alguma função for resolvida, pois retornos podem depender de chamadas a
+ * funções ainda sem tipo; o que não se resolver (recursão pura ou corpo
+ * não analisado) retorna inteiro. */
+static void infer_return_types(ASTNode* program) {
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int i = 0; i < program->child_count; i++) {
+            ASTNode* func = ast_get_child(program, i);
+            if (func->type != AST_FUNCTION_DEF || func->data.function->return_type != TYPE_VOID) continue;
+            
+            DataType type = infer_returns_in(program, func, func);
+            if (type != TYPE_VOID) {
+                func->data.function->return_type = type;
+                changed = 1;
+            }
+        }
+    }
+    
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* func = ast_get_child(program, i);
+        if (func->type == AST_FUNCTION_DEF && func->data.function->return_type == TYPE_VOID) {
+            func->data.function->return_type = TYPE_INTEIRO;
+        }
+    }
+}
+
 /* Analisar programa */
 static void analyze_program(SemanticContext* ctx, ASTNode* node) {
     if (!node || node->type != AST_PROGRAM) return;
     
+    infer_return_types(node);
+    
     /* Primeira passada: declarar todas as funções */
     for (int i = 0; i < node->child_count; i++) {
-        if (node->children[i]->type == AST_FUNCTION_DEF) {
-            const char* func_name = node->children[i]->data.function.name;
+        ASTNode* child = ast_get_child(node, i);
+        if (child->type == AST_FUNCTION_DEF) {
+            const char* func_name = child->data.function->name;
             
             /* Validar nome da função */
             if (!validate_function_name(func_name)) {
-                semantic_error(ctx, node->children[i]->token, "Nome de função inválido");
+                semantic_error(ctx, child->token, "Nome de função inválido");
                 continue;
             }
             
             /* Verificar se função já foi declarada */
-            Symbol* existing = symbol_table_lookup(ctx->symbol_table, func_name);
+            InternId func_id = node_name_id(child, func_name);
+            Symbol* existing = symbol_table_lookup_id(ctx->symbol_table, func_id);
             if (existing && existing->scope_level == ctx->symbol_table->scope_level) {
-                semantic_error(ctx, node->children[i]->token, "Função já declarada");
+                semantic_error(ctx, child->token, "Função já declarada");
                 continue;
             }
             
             /* Adicionar função à tabela de símbolos */
-            Symbol* func = symbol_table_insert(ctx->symbol_table, func_name, 
-                                             node->children[i]->data.function.return_type);
+            Symbol* func = symbol_table_insert_id(ctx->symbol_table, func_id,
+                                                child->data.function->return_type);
             if (func) {
                 func->is_function = 1;
-                func->param_count = node->children[i]->data.function.param_count;
+                func->param_count = child->data.function->param_count;
                 
-                /* Copiar informações dos parâmetros */
-                for (int j = 0; j < func->param_count; j++) {
-                    func->param_types[j] = node->children[i]->data.function.param_types[j];
-                    func->param_type_infos[j] = node->children[i]->data.function.param_type_infos[j];
-                    strncpy(func->param_names[j], node->children[i]->data.function.param_names[j], 
-                           MAX_IDENTIFIER_LENGTH - 1);
-                    func->param_names[j][MAX_IDENTIFIER_LENGTH - 1] = '\0';
-                }
+                /* A assinatura compartilha os parâmetros da definição */
+                FunctionSignature* signature = func->param_count > 0
+                    ? symbol_table_add_signature(ctx->symbol_table, func) : NULL;
+                if (signature) signature->params = child->data.function->params;
                 
                 /* Verificar se é função principal */
                 if (strcmp(func_name, "principal") == 0) {
                     ctx->main_function_found = 1;
                     if (func->param_count > 0) {
-                        semantic_error(ctx, node->children[i]->token, "Função principal não pode ter parâmetros");
+                        semantic_error(ctx, child->token, "Função principal não pode ter parâmetros");
                     }
                 }
             }
         }
     }
     
-    /* Segunda passada: analisar corpos das funções */
-    for (int i = 0; i < node->child_count; i++) {
-        if (node->children[i]->type == AST_FUNCTION_DEF) {
-            analyze_function(ctx, node->children[i]);
-        }
-    }
+    /* Segunda passada: corpos das funções são independentes */
+    analyze_function_bodies(ctx, node);
     
     /* Verificar se existe função principal */
     if (!ctx->main_function_found) {
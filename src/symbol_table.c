@@ -1,42 +1,194 @@
 #include "../include/compiler.h"
 
-/* Criar tabela de símbolos */
-SymbolTable* symbol_table_create(void) {
-    SymbolTable* st = (SymbolTable*)memory_alloc(g_memory_manager, sizeof(SymbolTable));
-    if (!st) {
+/* Capacidade inicial da pilha de escopos */
+#define SCOPE_STACK_INITIAL 16
+
+/* Fator de carga máximo da tabela aberta: 3/4 */
+#define SYMBOL_LOAD_NUM 3
+#define SYMBOL_LOAD_DEN 4
+
+/* Arredondar capacidade para potência de 2 */
+static int symbol_capacity_for(int requested) {
+    int capacity = 16;
+    while (capacity < requested && capacity < (1 << 30)) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/* Distância da entrada até sua posição ideal */
+static int slot_distance(const SymbolTable* st, unsigned int hash, int index) {
+    int mask = st->table_size - 1;
+    return (index - (int)(hash & (unsigned int)mask)) & mask;
+}
+
+/* Colocar entrada na tabela (robin hood: quem está mais longe de casa fica) */
+static void slot_place(SymbolTable* st, unsigned int hash, Symbol* symbol) {
+    int mask = st->table_size - 1;
+    int index = (int)(hash & (unsigned int)mask);
+    int distance = 0;
+    
+    while (st->table[index].symbol) {
+        int existing = slot_distance(st, st->table[index].hash, index);
+        if (existing < distance) {
+            SymbolSlot displaced = st->table[index];
+            st->table[index].hash = hash;
+            st->table[index].symbol = symbol;
+            hash = displaced.hash;
+            symbol = displaced.symbol;
+            distance = existing;
+        }
+        index = (index + 1) & mask;
+        distance++;
+    }
+    
+    st->table[index].hash = hash;
+    st->table[index].symbol = symbol;
+}
+
+/* Localizar entrada do nome; -1 se ausente */
+static int slot_find(const SymbolTable* st, unsigned int hash, InternId name_id) {
+    int mask = st->table_size - 1;
+    int index = (int)(hash & (unsigned int)mask);
+    int distance = 0;
+    
+    while (st->table[index].symbol) {
+        /* Entrada mais perto de casa que a busca: o nome não está na tabela */
+        if (slot_distance(st, st->table[index].hash, index) < distance) {
+            return -1;
+        }
+        if (st->table[index].symbol->name_id == name_id) {
+            return index;
+        }
+        index = (index + 1) & mask;
+        distance++;
+    }
+    
+    return -1;
+}
+
+/* Remover entrada deslocando as seguintes para trás */
+static void slot_remove(SymbolTable* st, int index) {
+    int mask = st->table_size - 1;
+    int next = (index + 1) & mask;
+    
+    while (st->table[next].symbol && slot_distance(st, st->table[next].hash, next) > 0) {
+        st->table[index] = st->table[next];
+        index = next;
+        next = (next + 1) & mask;
+    }
+    
+    st->table[index].hash = 0;
+    st->table[index].symbol = NULL;
+    st->used_slots--;
+}
+
+/* Alocar vetor de entradas vazio */
+static SymbolSlot* slot_array_create(int capacity) {
+    SymbolSlot* slots = (SymbolSlot*)MEMORY_ALLOC(g_memory_manager, (size_t)capacity * sizeof(SymbolSlot));
+    if (!slots) return NULL;
+    memset(slots, 0, (size_t)capacity * sizeof(SymbolSlot));
+    return slots;
+}
+
+/* Dobrar a tabela e reinserir entradas */
+static int symbol_table_grow(SymbolTable* st) {
+    int old_size = st->table_size;
+    SymbolSlot* old_table = st->table;
+    
+    if (old_size >= (1 << 30)) return 0;
+    
+    SymbolSlot* table = slot_array_create(old_size * 2);
+    if (!table) {
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao expandir tabela de símbolos");
+        return 0;
+    }
+    
+    st->table = table;
+    st->table_size = old_size * 2;
+    for (int i = 0; i < old_size; i++) {
+        if (old_table[i].symbol) {
+            slot_place(st, old_table[i].hash, old_table[i].symbol);
+        }
+    }
+    
+    memory_free(g_memory_manager, old_table);
+    return 1;
+}
+
+/* Capacidade inicial de uma visão local (escopos de uma função) */
+#define SYMBOL_VIEW_INITIAL 64
+
+/* Criar tabela com capacidade inicial e tabela-pai opcional */
+static SymbolTable* symbol_table_create_sized(int requested, const SymbolTable* parent) {
+    /* Símbolos e pilha de escopos vivem na arena; a tabela cresce à parte */
+    int table_size = symbol_capacity_for(requested);
+    MemoryArena* arena = memory_arena_create(g_memory_manager, "simbolos",
+                                             sizeof(SymbolTable) +
+                                             SCOPE_STACK_INITIAL * sizeof(Symbol*) +
+                                             8 * sizeof(Symbol));
+    if (!arena) {
         error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar tabela de símbolos");
         return NULL;
     }
     
-    /* Inicializar tabela */
-    for (int i = 0; i < MAX_SYMBOL_TABLE_SIZE; i++) {
-        st->table[i] = NULL;
+    SymbolTable* st = (SymbolTable*)memory_arena_alloc(arena, sizeof(SymbolTable));
+    Symbol** scopes = st ? (Symbol**)memory_arena_alloc(arena, SCOPE_STACK_INITIAL * sizeof(Symbol*)) : NULL;
+    SymbolSlot* table = scopes ? slot_array_create(table_size) : NULL;
+    if (!st || !scopes || !table) {
+        memory_arena_destroy(arena);
+        error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar tabela de símbolos");
+        return NULL;
     }
     
+    /* Inicializar tabela */
+    st->parent = parent;
+    st->table = table;
+    st->table_size = table_size;
+    st->used_slots = 0;
+    
     st->scope_level = 0;
+    st->scope_symbols = scopes;
+    st->scope_capacity = SCOPE_STACK_INITIAL;
+    for (int i = 0; i < SCOPE_STACK_INITIAL; i++) {
+        st->scope_symbols[i] = NULL;
+    }
     st->symbol_count = 0;
+    st->arena = arena;
+    st->free_symbols = NULL;
+    st->signatures = NULL;
+    st->signature_count = 0;
+    st->signature_capacity = 0;
     
     return st;
 }
 
+/* Criar tabela de símbolos */
+SymbolTable* symbol_table_create(void) {
+    return symbol_table_create_sized(g_config.symbol_table_size > 0 ? g_config.symbol_table_size
+                                                                    : MAX_SYMBOL_TABLE_SIZE, NULL);
+}
+
+/* Criar visão local sobre uma tabela compartilhada: inserções ficam na
+ * visão e buscas sem resultado seguem para a tabela-pai, que não é
+ * modificada. Visões diferentes podem ser usadas em threads diferentes. */
+SymbolTable* symbol_table_create_view(const SymbolTable* parent) {
+    if (!parent) return NULL;
+    return symbol_table_create_sized(SYMBOL_VIEW_INITIAL, parent);
+}
+
 /* Destruir tabela de símbolos */
 void symbol_table_destroy(SymbolTable* st) {
     if (!st) return;
     
-    /* Liberar todos os símbolos */
-    for (int i = 0; i < MAX_SYMBOL_TABLE_SIZE; i++) {
-        Symbol* symbol = st->table[i];
-        while (symbol) {
-            Symbol* next = symbol->next;
-            memory_free(g_memory_manager, symbol);
-            symbol = next;
-        }
-    }
-    
-    memory_free(g_memory_manager, st);
+    /* Vetores de entradas e assinaturas à parte; símbolos e a própria tabela vivem na arena */
+    memory_free(g_memory_manager, st->table);
+    if (st->signatures) memory_free(g_memory_manager, st->signatures);
+    memory_arena_destroy(st->arena);
 }
 
-/* Função de hash para strings */
+/* Função de hash para strings: djb2 com mistura final dos bits baixos,
+ * já que o índice usa a máscara da potência de 2 */
 unsigned int symbol_hash(const char* str) {
     unsigned int hash = 5381;
     int c;
@@ -45,44 +197,75 @@ unsigned int symbol_hash(const char* str) {
         hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
     }
     
-    return hash % MAX_SYMBOL_TABLE_SIZE;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    
+    return hash;
 }
 
 /* Inserir símbolo na tabela */
 Symbol* symbol_table_insert(SymbolTable* st, const char* name, DataType type) {
     if (!st || !name) return NULL;
+    return symbol_table_insert_id(st, intern_string(name), type);
+}
+
+/* Inserir símbolo pelo id internado do nome */
+Symbol* symbol_table_insert_id(SymbolTable* st, InternId name_id, DataType type) {
+    if (!st || name_id == INTERN_NONE) return NULL;
+    
+    unsigned int hash = intern_hash(name_id);
+    int index = slot_find(st, hash, name_id);
     
     /* Verificar se já existe no escopo atual */
-    Symbol* existing = symbol_table_lookup(st, name);
-    if (existing && existing->scope_level == st->scope_level) {
+    if (index >= 0 && st->table[index].symbol->scope_level == st->scope_level) {
         return NULL; /* Já declarado neste escopo */
     }
     
-    /* Criar novo símbolo */
-    Symbol* symbol = (Symbol*)memory_alloc(g_memory_manager, sizeof(Symbol));
+    /* Nome novo: crescer antes de passar do fator de carga */
+    if (index < 0 && (st->used_slots + 1) * SYMBOL_LOAD_DEN > st->table_size * SYMBOL_LOAD_NUM) {
+        if (!symbol_table_grow(st)) return NULL;
+    }
+    
+    /* Reaproveitar símbolo de escopo encerrado ou alocar na arena */
+    Symbol* symbol = st->free_symbols;
+    if (symbol) {
+        st->free_symbols = symbol->next;
+    } else {
+        symbol = (Symbol*)memory_arena_alloc(st->arena, sizeof(Symbol));
+    }
     if (!symbol) {
         error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar símbolo");
         return NULL;
     }
     
     /* Inicializar símbolo */
-    strncpy(symbol->name, name, MAX_IDENTIFIER_LENGTH - 1);
-    symbol->name[MAX_IDENTIFIER_LENGTH - 1] = '\0';
+    symbol->name_id = name_id;
+    symbol->name = intern_text(name_id);
     symbol->type = type;
     symbol->is_function = 0;
     symbol->is_parameter = 0;
     symbol->scope_level = st->scope_level;
     symbol->is_initialized = 0;
+    symbol->line_declared = 0;
     symbol->param_count = 0;
-    
-    /* Zerar valores */
-    memset(&symbol->value, 0, sizeof(symbol->value));
+    symbol->signature = -1;
+    symbol->hash = hash;
     memset(&symbol->type_info, 0, sizeof(symbol->type_info));
     
-    /* Inserir na tabela */
-    unsigned int index = symbol_hash(name);
-    symbol->next = st->table[index];
-    st->table[index] = symbol;
+    /* Nome já visível: o novo símbolo o oculta até o fim do escopo */
+    if (index >= 0) {
+        symbol->next = st->table[index].symbol;
+        st->table[index].symbol = symbol;
+    } else {
+        symbol->next = NULL;
+        slot_place(st, hash, symbol);
+        st->used_slots++;
+    }
+    
+    /* Registrar no escopo atual para remoção na saída */
+    symbol->scope_next = st->scope_symbols[st->scope_level];
+    st->scope_symbols[st->scope_level] = symbol;
     st->symbol_count++;
     
     return symbol;
@@ -92,48 +275,108 @@ Symbol* symbol_table_insert(SymbolTable* st, const char* name, DataType type) {
 Symbol* symbol_table_lookup(SymbolTable* st, const char* name) {
     if (!st || !name) return NULL;
     
-    unsigned int index = symbol_hash(name);
-    Symbol* symbol = st->table[index];
+    /* Nome nunca internado não pode estar na tabela */
+    return symbol_table_lookup_id(st, intern_lookup(name));
+}
+
+/* Buscar símbolo pelo id internado do nome */
+Symbol* symbol_table_lookup_id(SymbolTable* st, InternId name_id) {
+    if (!st || name_id == INTERN_NONE) return NULL;
     
-    /* Procurar símbolo mais recente com o nome */
-    Symbol* found = NULL;
-    while (symbol) {
-        if (strcmp(symbol->name, name) == 0) {
-            if (!found || symbol->scope_level > found->scope_level) {
-                found = symbol;
-            }
+    /* A entrada guarda o símbolo do escopo mais interno */
+    unsigned int hash = intern_hash(name_id);
+    for (const SymbolTable* table = st; table; table = table->parent) {
+        int index = slot_find(table, hash, name_id);
+        if (index >= 0) return table->table[index].symbol;
+    }
+    return NULL;
+}
+
+/* Criar assinatura vazia para a função (substitui a anterior, se houver).
+ * Assinaturas pertencem à tabela raiz; visões não criam assinaturas.
+ * Os parâmetros apontados pertencem à AST analisada, não à tabela. */
+FunctionSignature* symbol_table_add_signature(SymbolTable* st, Symbol* func) {
+    if (!st || !func || st->parent) return NULL;
+    
+    if (st->signature_count >= st->signature_capacity) {
+        int new_capacity = st->signature_capacity == 0 ? 8 : st->signature_capacity * 2;
+        FunctionSignature* signatures = (FunctionSignature*)MEMORY_REALLOC(
+            g_memory_manager, st->signatures, (size_t)new_capacity * sizeof(FunctionSignature));
+        if (!signatures) {
+            error_report(ERROR_MEMORY, 0, 0, "Falha ao alocar assinatura de função");
+            return NULL;
         }
-        symbol = symbol->next;
+        st->signatures = signatures;
+        st->signature_capacity = new_capacity;
     }
     
-    return found;
+    FunctionSignature* signature = &st->signatures[st->signature_count];
+    memset(signature, 0, sizeof(FunctionSignature));
+    func->signature = st->signature_count++;
+    
+    return signature;
+}
+
+/* Assinatura da função (válida até a próxima symbol_table_add_signature) */
+const FunctionSignature* symbol_table_get_signature(const SymbolTable* st, const Symbol* func) {
+    if (!st || !func) return NULL;
+    
+    while (st->parent) st = st->parent;
+    if (func->signature < 0 || func->signature >= st->signature_count) {
+        return NULL;
+    }
+    return &st->signatures[func->signature];
 }
 
 /* Entrar em novo escopo */
 void symbol_table_enter_scope(SymbolTable* st) {
     if (!st) return;
+    
+    /* Dobrar pilha de escopos na arena quando necessário */
+    if (st->scope_level + 1 >= st->scope_capacity) {
+        int new_capacity = st->scope_capacity * 2;
+        Symbol** scopes = (Symbol**)memory_arena_alloc(st->arena, new_capacity * sizeof(Symbol*));
+        if (!scopes) {
+            error_report(ERROR_MEMORY, 0, 0, "Falha ao expandir pilha de escopos");
+            return;
+        }
+        memcpy(scopes, st->scope_symbols, st->scope_capacity * sizeof(Symbol*));
+        for (int i = st->scope_capacity; i < new_capacity; i++) {
+            scopes[i] = NULL;
+        }
+        st->scope_symbols = scopes;
+        st->scope_capacity = new_capacity;
+    }
+    
     st->scope_level++;
+    st->scope_symbols[st->scope_level] = NULL;
 }
 
 /* Sair do escopo atual */
 void symbol_table_exit_scope(SymbolTable* st) {
     if (!st || st->scope_level == 0) return;
     
-    /* Remover símbolos do escopo atual */
-    for (int i = 0; i < MAX_SYMBOL_TABLE_SIZE; i++) {
-        Symbol** symbol_ptr = &st->table[i];
-        while (*symbol_ptr) {
-            if ((*symbol_ptr)->scope_level == st->scope_level) {
-                Symbol* to_remove = *symbol_ptr;
-                *symbol_ptr = to_remove->next;
-                memory_free(g_memory_manager, to_remove);
-                st->symbol_count--;
+    /* Remover apenas os símbolos registrados no escopo: cada um é o
+     * visível do seu nome e volta a expor o que ocultava */
+    Symbol* symbol = st->scope_symbols[st->scope_level];
+    while (symbol) {
+        Symbol* scope_next = symbol->scope_next;
+        int index = slot_find(st, symbol->hash, symbol->name_id);
+        if (index >= 0) {
+            if (symbol->next) {
+                st->table[index].symbol = symbol->next;
             } else {
-                symbol_ptr = &(*symbol_ptr)->next;
+                slot_remove(st, index);
             }
         }
+        
+        symbol->next = st->free_symbols;
+        st->free_symbols = symbol;
+        st->symbol_count--;
+        symbol = scope_next;
     }
     
+    st->scope_symbols[st->scope_level] = NULL;
     st->scope_level--;
 }
 
@@ -143,10 +386,11 @@ void symbol_table_print(SymbolTable* st) {
     
     printf("\n=== TABELA DE SÍMBOLOS ===\n");
     printf("Escopo atual: %d\n", st->scope_level);
-    printf("Total de símbolos: %d\n\n", st->symbol_count);
+    printf("Total de símbolos: %d\n", st->symbol_count);
+    printf("Ocupação: %d/%d entradas\n\n", st->used_slots, st->table_size);
     
-    for (int i = 0; i < MAX_SYMBOL_TABLE_SIZE; i++) {
-        Symbol* symbol = st->table[i];
+    for (int i = 0; i < st->table_size; i++) {
+        Symbol* symbol = st->table[i].symbol;
         if (symbol) {
             printf("Índice %d:\n", i);
             while (symbol) {
@@ -155,13 +399,14 @@ void symbol_table_print(SymbolTable* st) {
                        data_type_to_string(symbol->type),
                        symbol->scope_level);
                 
+                const FunctionSignature* signature = symbol_table_get_signature(st, symbol);
                 if (symbol->is_function) {
                     printf("    Função com %d parâmetros\n", symbol->param_count);
-                    for (int j = 0; j < symbol->param_count; j++) {
+                    for (int j = 0; signature && j < symbol->param_count; j++) {
                         printf("    Param %d: %s (%s)\n",
                                j + 1,
-                               symbol->param_names[j],
-                               data_type_to_string(symbol->param_types[j]));
+                               intern_text(signature->params[j].name_id),
+                               data_type_to_string(signature->params[j].type));
                     }
                 }
                 
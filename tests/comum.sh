@@ -0,0 +1,44 @@
+# Funções dos testes de paridade, incluídas com ". tests/comum.sh".
+# Cada teste roda os mesmos programas em dois modos do compilador e
+# compara só o trecho de execução: relatórios de memória, tempo, JIT e
+# cache mudam entre os modos.
+
+# Linhas do início da execução até o relatório de memória, sem os
+# relatórios do JIT e do cache de funções puras
+execucao() {
+    awk '/^=== INICIANDO EXECUÇÃO ===/ { dentro = 1 }
+         !dentro { next }
+         /^=== RELATÓRIO/ { exit }
+         /^=== (JIT|CACHE DE FUNÇÕES PURAS) ===$/ { relatorio = 1; next }
+         relatorio { if ($0 ~ /^=+$/) relatorio = 0; next }
+         { print }'
+}
+
+# comparar COMPILADOR "opções de referência" "opções testadas": roda
+# examples/ e tests/programas/ nos dois modos; falha se alguma saída difere
+comparar() {
+    compilador=$1
+    referencia=$2
+    testado=$3
+    dir=$(dirname "$0")
+    tmp=${TMPDIR:-/tmp}/paridade.$$
+    falhas=0
+    total=0
+
+    for programa in "$dir"/../examples/*.txt "$dir"/programas/*.txt; do
+        total=$((total + 1))
+        "$compilador" $referencia "$programa" </dev/null 2>/dev/null | execucao >"$tmp.ref"
+        "$compilador" $testado "$programa" </dev/null 2>/dev/null | execucao >"$tmp.novo"
+        if cmp -s "$tmp.ref" "$tmp.novo"; then
+            echo "ok     $programa"
+        else
+            echo "FALHOU $programa"
+            diff "$tmp.ref" "$tmp.novo" | head -20
+            falhas=$((falhas + 1))
+        fi
+    done
+
+    rm -f "$tmp.ref" "$tmp.novo"
+    echo "$((total - falhas)) de $total programas com a mesma saída"
+    [ "$falhas" -eq 0 ]
+}
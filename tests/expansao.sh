@@ -0,0 +1,7 @@
+#!/bin/sh
+# Compara a saída dos programas com a expansão de funções pequenas contra
+# a execução sem expansão: a ordem dos efeitos (escrita, erro) não muda.
+# Uso: tests/expansao.sh [compilador] (padrão: bin/compiler)
+
+. "$(dirname "$0")/comum.sh"
+comparar "${1:-bin/compiler}" "--expandir-funcoes=0" "--expandir-funcoes=16"
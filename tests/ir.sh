@@ -0,0 +1,7 @@
+#!/bin/sh
+# Compara a saída dos programas executados pela IR (construída, otimizada
+# pelos passos padrão e conferida) contra o interpretador da AST.
+# Uso: tests/ir.sh [compilador] (padrão: bin/compiler)
+
+. "$(dirname "$0")/comum.sh"
+comparar "${1:-bin/compiler}" "" "--executar-ir"
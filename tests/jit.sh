@@ -0,0 +1,7 @@
+#!/bin/sh
+# Compara a saída dos programas com o JIT compilando na primeira chamada e
+# na primeira volta de laço contra a execução só interpretada.
+# Uso: tests/jit.sh [compilador] (padrão: bin/compiler)
+
+. "$(dirname "$0")/comum.sh"
+comparar "${1:-bin/compiler}" "--jit-chamadas=0 --jit-lacos=0" "--jit-chamadas=1 --jit-lacos=1"